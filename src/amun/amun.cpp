@@ -20,8 +20,10 @@
 
 #include "amun.h"
 #include "receiver.h"
+#include "visioningest.h"
 #include "optionsmanager.h"
 #include "commandconverter.h"
+#include "core/latencytrace.h"
 #include "core/timer.h"
 #include "core/protobuffilesaver.h"
 #include "core/sslprotocols.h"
@@ -38,6 +40,7 @@
 #include "networkinterfacewatcher.h"
 #include "seshat/seshat.h"
 #include "gitinforecorder.h"
+#include <QDebug>
 #include <QMetaType>
 #include <QThread>
 #include <QList>
@@ -72,6 +75,7 @@ Amun::Amun(bool simulatorOnly, QObject *parent) :
     m_referee(nullptr),
     m_vision(nullptr),
     m_mixedTeam(nullptr),
+    m_visionPort(SSL_VISION_PORT),
     m_simulatorEnabled(false),
     m_scaling(1.0f),
     m_useNetworkTransceiver(false),
@@ -89,6 +93,8 @@ Amun::Amun(bool simulatorOnly, QObject *parent) :
     qRegisterMetaType< QList<robot::RadioCommand> >("QList<robot::RadioCommand>");
     qRegisterMetaType< QList<robot::RadioResponse> >("QList<robot::RadioResponse>");
     qRegisterMetaType<Status>("Status");
+    qRegisterMetaType<QList<ReceivedPacket>>("QList<ReceivedPacket>");
+    qRegisterMetaType<std::shared_ptr<VisionIngestQueue>>("std::shared_ptr<VisionIngestQueue>");
     qRegisterMetaType<std::shared_ptr<gameController::AutoRefToController>>("std::shared_ptr<gameController::AutoRefToController>");
     qRegisterMetaType<amun::DebugValue>("amun::DebugValue");
     qRegisterMetaType<amun::Visualization>("amun::Visualization");
@@ -111,6 +117,7 @@ Amun::Amun(bool simulatorOnly, QObject *parent) :
     m_timer = new Timer;
     m_replayTimer = new Timer;
     m_replayTimer->setScaling(0);
+    m_latencyTrace.reset(new LatencyTrace);
 
     m_commandConverter = new CommandConverter(m_timer, this);
     connect(m_commandConverter, &CommandConverter::sendStatus, this, &Amun::handleStatus);
@@ -153,6 +160,7 @@ void Amun::start()
     // create processor
     Q_ASSERT(m_processor == nullptr);
     m_processor = new Processor(m_timer, false);
+    m_processor->setLatencyTrace(m_latencyTrace.get());
     m_processor->moveToThread(m_processorThread);
     connect(m_processorThread, SIGNAL(finished()), m_processor, SLOT(deleteLater()));
 
@@ -207,6 +215,7 @@ void Amun::start()
         Q_ASSERT(m_strategy[i] == nullptr);
         ProtobufFileSaver *pathInput = m_pathInputSaver[std::min(1, i)].get();
         m_strategy[i] = new Strategy(m_timer, strategy, m_debugHelper[i], &m_compilerRegistry, m_gameControllerConnection[i], i == 2, false, pathInput);
+        m_strategy[i]->setLatencyTrace(m_latencyTrace.get());
         m_strategy[i]->moveToThread(m_strategyThread[i]);
         connect(m_strategyThread[i], SIGNAL(finished()), m_strategy[i], SLOT(deleteLater()));
 
@@ -263,7 +272,7 @@ void Amun::start()
         setupReceiver(m_referee, QHostAddress(SSL_GAME_CONTROLLER_ADDRESS), SSL_GAME_CONTROLLER_PORT);
         connect(this, &Amun::updateRefereePort, m_referee, &Receiver::updatePort);
         // move referee packets to processor
-        connect(m_referee, &Receiver::gotPacket, m_processor, &Processor::handleRefereePacket);
+        connect(m_referee, &Receiver::gotPackets, m_processor, &Processor::handleRefereePackets);
 
         // create vision
         setupReceiver(m_vision, QHostAddress(SSL_VISION_ADDRESS), SSL_VISION_PORT);
@@ -271,6 +280,7 @@ void Amun::start()
         connect(this, &Amun::updateVisionPort, m_vision, &Receiver::updatePort);
         // vision is connected in setSimulatorEnabled
         connect(m_vision, &Receiver::sendStatus, this, &Amun::handleStatus);
+        connect(this, &Amun::updateVisionIngestQueue, m_processor, &Processor::setVisionIngestQueue);
 
         // create mixed team information receiver
         setupReceiver(m_mixedTeam, QHostAddress(), SSL_MIXED_TEAM_PORT);
@@ -290,6 +300,7 @@ void Amun::start()
     if (!m_simulatorOnly) {
         Q_ASSERT(m_transceiver == nullptr);
         m_transceiver = new Transceiver(m_timer);
+        m_transceiver->setLatencyTrace(m_latencyTrace.get());
         m_transceiver->moveToThread(m_transceiverThread);
         connect(m_transceiverThread, SIGNAL(finished()), m_transceiver, SLOT(deleteLater()));
         // route commands to transceiver
@@ -331,6 +342,8 @@ void Amun::start()
  */
 void Amun::stop()
 {
+    stopVisionIngest();
+
     // stop threads
     m_processorThread->quit();
     m_transceiverThread->quit();
@@ -391,6 +404,61 @@ void Amun::setupReceiver(Receiver *&receiver, const QHostAddress &address, quint
     connect(m_networkInterfaceWatcher, &NetworkInterfaceWatcher::interfaceUpdated, receiver, &Receiver::updateInterface);
 }
 
+/*!
+ * \brief Move the vision reception to a dedicated thread
+ *
+ * The thread is pinned to a single core and uses real time scheduling if permitted.
+ * It decodes the vision packets and passes the frames to the processor using a lock-free queue.
+ * The regular vision receiver is stopped in the meantime.
+ * \param enabled Whether to use the ingest thread
+ */
+void Amun::setVisionIngestEnabled(bool enabled)
+{
+    if (m_simulatorOnly || enabled == (m_visionIngest != nullptr)) {
+        return;
+    }
+    if (!enabled) {
+        stopVisionIngest();
+        QMetaObject::invokeMethod(m_vision, "startListen", Qt::QueuedConnection);
+        return;
+    }
+
+    // both sockets could be bound at once, which would duplicate multicast packets
+    QMetaObject::invokeMethod(m_vision, "stopListen", Qt::BlockingQueuedConnection);
+
+    m_visionIngestQueue = std::make_shared<VisionIngestQueue>();
+    m_visionIngestThread = new QThread(this);
+    m_visionIngestThread->setObjectName("vision ingest");
+    m_visionIngest = new VisionIngest(QHostAddress(SSL_VISION_ADDRESS), m_visionPort, m_timer, m_visionIngestQueue);
+    m_visionIngest->moveToThread(m_visionIngestThread);
+    connect(m_visionIngestThread, &QThread::started, m_visionIngest, &VisionIngest::start);
+    connect(m_visionIngestThread, &QThread::finished, m_visionIngest, &VisionIngest::deleteLater);
+    connect(this, &Amun::updateVisionPort, m_visionIngest, &VisionIngest::updatePort);
+    connect(m_networkInterfaceWatcher, &NetworkInterfaceWatcher::interfaceUpdated, m_visionIngest, &VisionIngest::updateInterface);
+    connect(m_visionIngest, &VisionIngest::sendStatus, this, &Amun::handleStatus);
+    connect(m_visionIngest, &VisionIngest::framesAvailable, m_processor, &Processor::handleIngestedFrames);
+    if (!m_simulatorEnabled) {
+        emit updateVisionIngestQueue(m_visionIngestQueue);
+    }
+    m_visionIngestThread->start();
+}
+
+void Amun::stopVisionIngest()
+{
+    if (!m_visionIngest) {
+        return;
+    }
+    emit updateVisionIngestQueue(nullptr);
+    // deletes the ingest object
+    m_visionIngestThread->quit();
+    m_visionIngestThread->wait();
+    delete m_visionIngestThread;
+    m_visionIngestThread = nullptr;
+    m_visionIngest = nullptr;
+    // the processor may still hold a reference until it handled the update
+    m_visionIngestQueue.reset();
+}
+
 void Amun::createSimulator(const amun::SimulatorSetup &setup)
 {
     m_simulator = new Simulator(m_timer, setup);
@@ -459,11 +527,21 @@ void Amun::handleCommandLocally(const Command &command)
 
     if (command->has_amun()) {
         if (command->amun().has_vision_port()) {
-            emit updateVisionPort(command->amun().vision_port());
+            m_visionPort = command->amun().vision_port();
+            emit updateVisionPort(m_visionPort);
         }
         if (command->amun().has_referee_port()) {
             emit updateRefereePort(command->amun().referee_port());
         }
+        if (command->amun().has_latency_trace_file()) {
+            const QString filename = QString::fromStdString(command->amun().latency_trace_file());
+            if (!m_latencyTrace->setExportFile(filename)) {
+                qWarning() << "Failed to open the latency trace file" << filename;
+            }
+        }
+        if (command->amun().has_vision_ingest_thread()) {
+            setVisionIngestEnabled(command->amun().vision_ingest_thread());
+        }
     }
 
     if (command->has_transceiver()) {
@@ -668,8 +746,11 @@ void Amun::setSimulatorEnabled(bool enabled, bool useNetworkTransceiver)
         connect(m_simulator, &Simulator::sendRealData, m_processor, &Processor::handleSimulatorExtraVision);
 
     } else {
-        connect(m_vision, SIGNAL(gotPacket(QByteArray, qint64, QString)),
-                m_processor, SLOT(handleVisionPacket(QByteArray, qint64, QString)));
+        connect(m_vision, &Receiver::gotPackets, m_processor, &Processor::handleVisionPackets);
+    }
+    if (m_visionIngest) {
+        // the ingest thread keeps running, but its frames are ignored while simulating
+        emit updateVisionIngestQueue(enabled ? nullptr : m_visionIngestQueue);
     }
 
     // setup connections for robot responses
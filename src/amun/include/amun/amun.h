@@ -38,6 +38,8 @@ class Receiver;
 class Strategy;
 class Timer;
 class Transceiver;
+class VisionIngest;
+struct VisionIngestQueue;
 class NetworkTransceiver;
 class QHostAddress;
 class Integrator;
@@ -47,6 +49,7 @@ class OptionsManager;
 class Seshat;
 class CommandConverter;
 class GitInfoRecorder;
+class LatencyTrace;
 
 namespace camun {
     namespace simulator {
@@ -69,6 +72,7 @@ signals:
     void sendStatus(const Status &status);
     void gotCommand(const Command &command);
     void updateVisionPort(quint16 port);
+    void updateVisionIngestQueue(const std::shared_ptr<VisionIngestQueue> &queue);
     void updateRefereePort(quint16 port);
     void useInternalGameController(bool useInternal);
     void gotCommandForGC(const amun::CommandReferee &command);
@@ -89,6 +93,8 @@ private slots:
 private:
     void setupReceiver(Receiver *&receiver, const QHostAddress &address, quint16 port);
     void setSimulatorEnabled(bool enabled, bool useNetworkTransceiver);
+    void setVisionIngestEnabled(bool enabled);
+    void stopVisionIngest();
     void updateScaling(float scaling);
     void createSimulator(const amun::SimulatorSetup &setup);
     void enableAutoref(bool enable);
@@ -111,6 +117,11 @@ private:
     Receiver *m_referee;
     Receiver *m_vision;
     Receiver *m_mixedTeam;
+    // optional replacement for m_vision, only exists while it is enabled
+    QThread *m_visionIngestThread = nullptr;
+    VisionIngest *m_visionIngest = nullptr;
+    std::shared_ptr<VisionIngestQueue> m_visionIngestQueue;
+    quint16 m_visionPort;
     Strategy *m_strategy[3];
     DebugHelper *m_debugHelper[3];
     std::shared_ptr<StrategyGameControllerMediator> m_gameControllerConnection[3];
@@ -129,6 +140,8 @@ private:
     bool m_useAutoref;
     bool m_enableTrackingReplay = false;
     std::unique_ptr<TrackingReplay> m_trackingReplay;
+    // shared by processor, strategies and transceiver, must outlive their threads
+    std::unique_ptr<LatencyTrace> m_latencyTrace;
 
     QSet<amun::PauseSimulatorReason> m_activePauseReasons;
     float m_previousSpeed;
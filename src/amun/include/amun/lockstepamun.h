@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef LOCKSTEPAMUN_H
+#define LOCKSTEPAMUN_H
+
+#include "strategy/script/compilerregistry.h"
+#include "protobuf/command.h"
+#include "protobuf/status.h"
+#include <QByteArray>
+#include <QObject>
+#include <QSet>
+#include <memory>
+
+class CommandConverter;
+class OptionsManager;
+class Processor;
+class Strategy;
+class StrategyGameControllerMediator;
+class Timer;
+
+namespace camun {
+    namespace simulator {
+        class Simulator;
+    }
+}
+
+// runs simulator, processor and strategies without timers on the calling thread
+class LockstepAmun : public QObject
+{
+    Q_OBJECT
+
+public:
+    // the simulator is seeded with the given value, also when it is replaced
+    explicit LockstepAmun(quint32 seed, QObject *parent = nullptr);
+    ~LockstepAmun() override;
+    LockstepAmun(const LockstepAmun&) = delete;
+    LockstepAmun& operator=(const LockstepAmun&) = delete;
+
+signals:
+    void gotStatus(const Status &status);
+    void gotCommand(const Command &command);
+
+public:
+    void start();
+    void stop();
+
+public slots:
+    void handleCommand(const Command &command);
+
+private slots:
+    void step();
+    void handleStatus(const Status &status);
+
+private:
+    void createSimulator(const amun::SimulatorSetup &setup);
+    void pauseSimulator(const amun::PauseSimulatorCommand &pauseCommand);
+    void sendReferee();
+    void scheduleStep();
+
+private:
+    const quint32 m_seed;
+    // destroyed last, used by all components
+    std::unique_ptr<Timer> m_timer;
+    CompilerRegistry m_compilerRegistry;
+    std::unique_ptr<Processor> m_processor;
+    std::unique_ptr<CommandConverter> m_commandConverter;
+    std::unique_ptr<OptionsManager> m_optionsManager;
+    camun::simulator::Simulator *m_simulator = nullptr;
+    std::shared_ptr<StrategyGameControllerMediator> m_gameControllerConnection[2];
+    std::unique_ptr<Strategy> m_strategy[2];
+
+    bool m_running = false;
+    bool m_stepScheduled = false;
+    QSet<amun::PauseSimulatorReason> m_activePauseReasons;
+    // the last referee packet is repeated like the game controller would do
+    QByteArray m_refereePacket;
+    qint64 m_nextRefereeTime = 0;
+};
+
+#endif // LOCKSTEPAMUN_H
@@ -0,0 +1,238 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "lockstepamun.h"
+#include "commandconverter.h"
+#include "optionsmanager.h"
+#include "core/timer.h"
+#include "gamecontroller/strategygamecontrollermediator.h"
+#include "processor/processor.h"
+#include "simulator/fastsimulator.h"
+#include "simulator/simulator.h"
+#include "strategy/strategy.h"
+
+using namespace camun::simulator;
+
+static const QString SENDER_NAME_FOR_REFEREE = "LockstepAmun";
+// fixed start, the timer is only advanced by the simulation loop
+static const qint64 START_TIME = 1234;
+// the processor runs at this period in regular operation
+static const qint64 STEP_INTERVAL = 10 * 1000 * 1000LL;
+static const qint64 REFEREE_INTERVAL = 100 * 1000 * 1000LL;
+
+/*!
+ * \class LockstepAmun
+ * \ingroup amun
+ * \brief Deterministic replacement of \ref Amun for simulated games
+ *
+ * Advances simulator, processor and strategies in a single loop on the calling thread,
+ * without any timers. Each step runs as soon as the event loop is idle, thus the game runs
+ * as fast as the CPU allows and repeated runs with the same seed yield identical results.
+ *
+ * There is no game controller, the referee commands are passed to the processor as packets.
+ * Therefore the internal autoref is not supported.
+ */
+
+LockstepAmun::LockstepAmun(quint32 seed, QObject *parent) :
+    QObject(parent),
+    m_seed(seed),
+    m_timer(new Timer)
+{
+    qRegisterMetaType<Command>("Command");
+    qRegisterMetaType<Status>("Status");
+
+    m_timer->setScaling(0);
+    m_timer->setTime(START_TIME, 0);
+
+    m_processor.reset(new Processor(m_timer.get(), true));
+    connect(this, &LockstepAmun::gotCommand, m_processor.get(), &Processor::handleCommand);
+    connect(m_processor.get(), &Processor::sendStatus, this, &LockstepAmun::handleStatus);
+
+    m_commandConverter.reset(new CommandConverter(m_timer.get()));
+    connect(this, &LockstepAmun::gotCommand, m_commandConverter.get(), &CommandConverter::handleCommand);
+    connect(m_commandConverter.get(), &CommandConverter::sendStatus, this, &LockstepAmun::handleStatus);
+    connect(m_processor.get(), &Processor::sendRadioCommands, m_commandConverter.get(), &CommandConverter::handleRadioCommands);
+
+    m_optionsManager.reset(new OptionsManager);
+    connect(this, &LockstepAmun::gotCommand, m_optionsManager.get(), &OptionsManager::handleCommand);
+    connect(m_optionsManager.get(), &OptionsManager::sendStatus, this, &LockstepAmun::handleStatus);
+
+    for (int i = 0;i<2;i++) {
+        const StrategyType type = i == 0 ? StrategyType::BLUE : StrategyType::YELLOW;
+        m_gameControllerConnection[i] = std::make_shared<StrategyGameControllerMediator>(false);
+        m_strategy[i].reset(new Strategy(m_timer.get(), type, nullptr, &m_compilerRegistry, m_gameControllerConnection[i]));
+        Strategy *strategy = m_strategy[i].get();
+
+        connect(m_processor.get(), &Processor::sendStrategyStatus, strategy, &Strategy::handleStatus);
+        connect(m_optionsManager.get(), &OptionsManager::sendStatus, strategy, &Strategy::handleStatus);
+        connect(strategy, &Strategy::sendStrategyCommands, m_processor.get(), &Processor::handleStrategyCommands);
+        connect(strategy, &Strategy::sendHalt, m_processor.get(), &Processor::handleStrategyHalt);
+        connect(m_processor.get(), &Processor::setFlipped, strategy, &Strategy::setFlipped);
+
+        // queued as the command is also passed to the strategy, which is still running
+        connect(strategy, &Strategy::gotCommand, this, &LockstepAmun::handleCommand, Qt::QueuedConnection);
+        connect(this, &LockstepAmun::gotCommand, strategy, &Strategy::handleCommand);
+        connect(strategy, &Strategy::sendStatus, this, &LockstepAmun::handleStatus);
+        connect(strategy, &Strategy::sendStatus, m_optionsManager.get(), &OptionsManager::handleStatus);
+    }
+
+    amun::SimulatorSetup defaultSimulatorSetup;
+    simulatorSetupSetDefault(defaultSimulatorSetup);
+    createSimulator(defaultSimulatorSetup);
+}
+
+LockstepAmun::~LockstepAmun()
+{
+    delete m_simulator;
+}
+
+void LockstepAmun::createSimulator(const amun::SimulatorSetup &setup)
+{
+    if (m_simulator) {
+        // the simulator may be replaced while it is emitting signals
+        m_simulator->blockSignals(true);
+        m_simulator->deleteLater();
+    }
+    m_simulator = new Simulator(m_timer.get(), setup, true);
+    m_simulator->seedPRGN(m_seed);
+
+    connect(this, &LockstepAmun::gotCommand, m_simulator, &Simulator::handleCommand);
+    connect(m_simulator, &Simulator::sendStatus, this, &LockstepAmun::handleStatus);
+    connect(m_simulator, &Simulator::gotPacket, m_processor.get(), &Processor::handleVisionPacket);
+    connect(m_simulator, &Simulator::sendRealData, m_processor.get(), &Processor::handleSimulatorExtraVision);
+    connect(m_simulator, &Simulator::sendRadioResponses, m_processor.get(), &Processor::handleRadioResponses);
+    connect(m_simulator, &Simulator::sendSSLSimError, m_commandConverter.get(), &CommandConverter::handleSimulatorErrors);
+    connect(m_commandConverter.get(), &CommandConverter::sendSSLSim, m_simulator, &Simulator::handleRadioCommands);
+    connect(m_processor.get(), &Processor::setFlipped, m_simulator, &Simulator::setFlipped);
+}
+
+/*!
+ * \brief Start the simulation loop
+ *
+ * The commands sent before, like the team and strategy setup, are already handled.
+ */
+void LockstepAmun::start()
+{
+    m_running = true;
+    scheduleStep();
+}
+
+void LockstepAmun::stop()
+{
+    m_running = false;
+}
+
+void LockstepAmun::scheduleStep()
+{
+    if (m_stepScheduled) {
+        return;
+    }
+    m_stepScheduled = true;
+    // queued to let the event loop handle everything else between two steps
+    QMetaObject::invokeMethod(this, "step", Qt::QueuedConnection);
+}
+
+void LockstepAmun::step()
+{
+    m_stepScheduled = false;
+    if (!m_running || !m_activePauseReasons.isEmpty()) {
+        return;
+    }
+
+    // simulator -> processor -> strategies, the processor passes the radio commands
+    // to the simulator on its next iteration
+    FastSimulator::goDelta(m_simulator, m_timer.get(), STEP_INTERVAL);
+    if (!m_refereePacket.isEmpty() && m_timer->currentTime() >= m_nextRefereeTime) {
+        sendReferee();
+    }
+    m_processor->process(m_timer->currentTime());
+    for (auto &strategy : m_strategy) {
+        strategy->tryProcess();
+    }
+
+    scheduleStep();
+}
+
+void LockstepAmun::sendReferee()
+{
+    const qint64 now = m_timer->currentTime();
+    m_processor->handleRefereePacket(m_refereePacket, now, SENDER_NAME_FOR_REFEREE);
+    m_nextRefereeTime = now + REFEREE_INTERVAL;
+}
+
+/*!
+ * \brief Process a command
+ *
+ * Time scaling has no effect as the timer is only advanced by the simulation loop.
+ * \param command Command to process
+ */
+void LockstepAmun::handleCommand(const Command &command)
+{
+    Command forwarded = command;
+    if (command->has_referee()) {
+        // use the referee packets without going through a game controller
+        forwarded = Command(new amun::Command(*command));
+        amun::CommandReferee *referee = forwarded->mutable_referee();
+        if (referee->has_command()) {
+            m_refereePacket = QByteArray::fromStdString(referee->command());
+            sendReferee();
+            referee->clear_command();
+        }
+        referee->set_active(false);
+        referee->clear_use_internal_autoref();
+    }
+
+    if (command->has_simulator() && command->simulator().has_simulator_setup()) {
+        createSimulator(command->simulator().simulator_setup());
+    }
+
+    if (command->has_pause_simulator()) {
+        pauseSimulator(command->pause_simulator());
+    }
+
+    emit gotCommand(forwarded);
+}
+
+void LockstepAmun::pauseSimulator(const amun::PauseSimulatorCommand &pauseCommand)
+{
+    const auto reason = pauseCommand.reason();
+    if (pauseCommand.has_pause()) {
+        if (pauseCommand.pause()) {
+            m_activePauseReasons.insert(reason);
+        } else {
+            m_activePauseReasons.remove(reason);
+        }
+    }
+    if (pauseCommand.has_toggle() && pauseCommand.toggle()) {
+        if (!m_activePauseReasons.contains(reason)) {
+            m_activePauseReasons.insert(reason);
+        } else {
+            m_activePauseReasons.remove(reason);
+        }
+    }
+    if (m_running && m_activePauseReasons.isEmpty()) {
+        scheduleStep();
+    }
+}
+
+void LockstepAmun::handleStatus(const Status &status)
+{
+    status->set_time(m_timer->currentTime());
+    emit gotStatus(status);
+}
@@ -21,6 +21,8 @@
 #ifndef PROCESSOR_H
 #define PROCESSOR_H
 
+#include "core/receivedpacket.h"
+#include "visioningestqueue.h"
 #include "protobuf/command.h"
 #include "protobuf/robotcommand.h"
 #include "protobuf/ssl_mixed_team.pb.h"
@@ -28,15 +30,24 @@
 #include <QMap>
 #include <QPair>
 #include <QObject>
+#include <QSet>
 #include <QThread>
+#include <QVector>
+#include <functional>
+#include <memory>
 
 class CommandEvaluator;
+class LatencyHistogram;
+class LatencyTrace;
 class Referee;
 class SpeedTracker;
 class Timer;
 class Tracker;
+class VisionFrameDecoder;
 class QTimer;
+class QThreadPool;
 class InternalGameController;
+struct TrackerSnapshot;
 
 class Processor : public QObject
 {
@@ -51,7 +62,20 @@ public:
     Processor& operator=(const Processor&) = delete;
     bool getIsFlipped() const { return m_lastFlipped; }
     InternalGameController *getInternalGameController() const { return m_gameController; }
+    void setLatencyTrace(LatencyTrace *trace) { m_latencyTrace = trace; }
     void resetTracking();
+    // runs all trackers on the calling thread, for running many processors in parallel
+    void setParallelTracking(bool enabled);
+
+    // state of all trackers, can only be restored to the processor it was taken from
+    struct TrackingSnapshot
+    {
+        std::shared_ptr<const TrackerSnapshot> tracker;
+        std::shared_ptr<const TrackerSnapshot> speedTracker;
+        std::shared_ptr<const TrackerSnapshot> simpleTracker;
+    };
+    TrackingSnapshot snapshotTracking() const;
+    void restoreTracking(const TrackingSnapshot &snapshot);
 
 signals:
     void sendStatus(const Status &status);
@@ -64,6 +88,12 @@ public slots:
     void setScaling(double scaling);
     void handleRefereePacket(const QByteArray &data, qint64 time, QString sender);
     void handleVisionPacket(const QByteArray &data, qint64 time, QString sender);
+    // additionally track the wakeup delay of the receivers
+    void handleRefereePackets(const QList<ReceivedPacket> &packets);
+    void handleVisionPackets(const QList<ReceivedPacket> &packets);
+    // frames of the vision ingest thread replace the vision packets, pass nullptr to disable
+    void setVisionIngestQueue(const std::shared_ptr<VisionIngestQueue> &queue);
+    void handleIngestedFrames();
     void handleSimulatorExtraVision(const QByteArray &data);
     void handleMixedTeamInfo(const QByteArray &data, qint64 time);
     void handleRadioResponses(const QList<robot::RadioResponse> &responses);
@@ -73,6 +103,10 @@ public slots:
     // public only for tracking replay
     void process(qint64 overwriteTime = -1);
 
+private slots:
+    // tracking only, triggered by a complete set of camera frames
+    void processVision();
+
 private:
     struct Robot;
     struct Team
@@ -93,19 +127,59 @@ private:
     const world::Robot *getWorldRobot(const RobotList &robots, uint id);
     void injectExtraData(Status &status);
     void injectUserControl(Status &status, bool isBlue);
-    Status assembleStatus(qint64 time, bool resetRaw);
+    // computes the world state of the main and the simple tracker concurrently
+    void predictWorldStates(qint64 time, const Status &current, Status &status, Status &simplePredictionStatus);
+    void startTrackerTask(const std::function<void()> &task);
+    void assembleStatus(Status &status, Status &simplePredictionStatus, bool isPrediction);
+    void referenceSharedData(Status &strategyStatus, const Status &status);
     world::WorldSource currentWorldSource() const;
+    void queueVisionFrame(const VisionFramePtr &frame, qint64 time);
+    void drainVisionIngestQueue();
+    void handleVisionTrigger(quint32 cameraId);
+    void addVisionLatencies(qint64 time);
+    float updateVisionLatency(qint64 time, qint64 traceId, qint64 traceStart, amun::DebugValues *debug);
     static QString ballModelConfigFile(bool isSimulator);
 
     void sendTeams();
 
     const Timer *m_timer;
     QTimer* m_trigger;
+    int m_triggerInterval;
+
+    // vision triggered tracking, m_trigger keeps running everything with the fixed rate
+    bool m_visionTriggered = false;
+    QTimer *m_minPeriodTrigger;
+    // last time the trackers processed the vision frames
+    qint64 m_lastProcessTime = 0;
+    // set while process runs, which includes draining the vision ingest queue
+    bool m_processing = false;
+    QMap<quint32, qint64> m_cameraLastSeen;
+    QSet<quint32> m_pendingCameras;
+    // reception time of the vision frames since the last iteration
+    QVector<qint64> m_pendingVisionTimes;
+    // number of pending vision frames which already were tracked and added to the latency histogram
+    int m_trackedVisionTimes = 0;
+    qint64 m_latencyWindowStart = 0;
+    std::unique_ptr<LatencyHistogram> m_fixedRateLatency;
+    std::unique_ptr<LatencyHistogram> m_visionTriggeredLatency;
+    // time between the kernel receiving a packet and the receiver reading it
+    std::unique_ptr<LatencyHistogram> m_refereeWakeupDelay;
+    std::unique_ptr<LatencyHistogram> m_visionWakeupDelay;
+
+    LatencyTrace *m_latencyTrace = nullptr;
+    // traces of the strategy commands received since the last iteration
+    QVector<qint64> m_commandTraces;
     Referee *m_referee;
     Referee *m_refereeInternal;
     std::unique_ptr<Tracker> m_tracker;
     std::unique_ptr<Tracker> m_speedTracker;
     std::unique_ptr<Tracker> m_simpleTracker;
+    // vision packets are decoded once for all trackers
+    std::unique_ptr<VisionFrameDecoder> m_visionDecoder;
+    std::shared_ptr<VisionIngestQueue> m_visionIngestQueue;
+    // the trackers don't share any mutable state, thus these can run concurrently
+    QThreadPool *m_trackingPool;
+    bool m_parallelTracking = true;
     QList<robot::RadioResponse> m_responses;
     QList<QByteArray> m_extraVision;
     ssl::TeamPlan m_mixedTeamInfo;
@@ -23,6 +23,10 @@
 
 #include <QObject>
 #include <QCache>
+#include <QList>
+#include <QMap>
+#include <QVector>
+#include <string>
 
 #include "protobuf/ssl_referee.h"
 #include "protobuf/status.h"
@@ -33,6 +37,11 @@ class TrackingReplay : public QObject
     Q_OBJECT
 public:
     explicit TrackingReplay(Timer *timer);
+    // overrides the ball models stored in the log
+    void setBallModel(const world::BallModel &ballModel);
+    void setParallelTracking(bool enabled) { m_replayProcessor.setParallelTracking(enabled); }
+    // log times of the tracking checkpoints, in ascending order
+    QList<qint64> checkpointTimes() const;
 
 signals:
     void gotStatus(const Status &status);
@@ -45,15 +54,41 @@ public slots:
 private slots:
     void ammendStatus(const Status &status);
 
+private:
+    struct Checkpoint
+    {
+        Processor::TrackingSnapshot snapshot;
+        // the statuses processed after taking the snapshot, in order, reduced to their tracking inputs
+        QVector<Status> inputs;
+    };
+
+    void processStatus(const Status &status);
+    void seek(qint64 time);
+    void recordCheckpoint(const Status &status);
+    quint64 cacheKey(const Status &status);
+    static Status trackingInput(const Status &status);
+
 private:
     Timer *m_timer;
     Processor m_replayProcessor;
     Status m_lastTrackingReplayGameState;
     SSLRefereeExtractor m_refereeExtractor;
 
-    // the tracking can not go back in time, therefore add a cache for already processed packages
-    QCache<QString, Status> m_statusCache;
-    QString m_currentPacketString;
+    // the tracking can not go back in time, therefore add a cache for already processed packages,
+    // its cost is the serialized size of the cached statuses
+    QCache<quint64, Status> m_statusCache;
+    quint64 m_currentPacketKey;
+    // reused to serialize the fields of a status which are relevant for tracking
+    std::string m_keyBuffer;
+
+    // tracking state at regular intervals of the log time, used to re-track only
+    // from the nearest checkpoint after a seek instead of starting from scratch
+    QMap<qint64, Checkpoint> m_checkpoints;
+    // time of the last status passed to the replay processor
+    qint64 m_lastTrackedTime;
+    // set while re-tracking the inputs of a checkpoint, the results are not published
+    bool m_retracking;
+    bool m_hasFixedBallModel;
 };
 
 #endif // TRACKINGREPLAY_H
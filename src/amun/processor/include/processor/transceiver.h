@@ -27,6 +27,7 @@
 #include <QMap>
 #include <QPair>
 
+class LatencyTrace;
 class QTimer;
 class Timer;
 class USBThread;
@@ -59,6 +60,7 @@ public:
     ~Transceiver() override;
     Transceiver(const Transceiver&) = delete;
     Transceiver& operator=(const Transceiver&) = delete;
+    void setLatencyTrace(LatencyTrace *trace) { m_latencyTrace = trace; }
 
 signals:
     void sendStatus(const Status &status);
@@ -121,6 +123,7 @@ private:
     QList<robot::RadioCommand> m_commands;
     qint64 m_processingStart;
     int m_droppedCommands;
+    LatencyTrace *m_latencyTrace = nullptr;
 };
 
 #endif // TRANSCEIVER_H
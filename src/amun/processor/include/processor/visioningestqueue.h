@@ -0,0 +1,50 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef VISIONINGESTQUEUE_H
+#define VISIONINGESTQUEUE_H
+
+#include "core/spscqueue.h"
+#include "tracking/visionframe.h"
+#include <atomic>
+
+// vision frame decoded by the ingest thread
+struct IngestedVisionFrame
+{
+    VisionFramePtr frame;
+    qint64 time = 0;
+    qint64 wakeupDelay = -1;
+};
+
+// hands decoded frames from the vision ingest thread to the processor
+struct VisionIngestQueue
+{
+    // about two seconds of vision with four cameras
+    static const int CAPACITY = 512;
+
+    SpscQueue<IngestedVisionFrame> frames{CAPACITY};
+    // set by the producer after a push, cleared by the consumer before draining the queue.
+    // the producer only notifies the consumer if the flag was not set yet
+    std::atomic<bool> notified{false};
+    // frames that were dropped as the queue was full, only written by the producer
+    std::atomic<int> dropped{0};
+};
+
+#endif // VISIONINGESTQUEUE_H
@@ -23,12 +23,17 @@
 #include "coordinatehelper.h"
 #include "processor.h"
 #include "referee.h"
+#include "core/latencyhistogram.h"
+#include "core/latencytrace.h"
 #include "core/timer.h"
 #include "core/configuration.h"
 #include "gamecontroller/internalgamecontroller.h"
 #include "tracking/tracker.h"
 #include "config/config.h"
 #include <cmath>
+#include <functional>
+#include <QRunnable>
+#include <QThreadPool>
 #include <QTimer>
 #include <QFile>
 #include <google/protobuf/text_format.h>
@@ -114,6 +119,16 @@ struct Processor::Robot
 
 const int Processor::FREQUENCY(100);
 
+// lower bound for the tracking period in the vision triggered mode
+static const qint64 VISION_TRIGGER_MIN_PERIOD = 4 * 1000 * 1000;
+// the latency percentiles are computed once per window
+static const qint64 LATENCY_WINDOW = 1000 * 1000 * 1000;
+// cameras without a frame for this time are not waited for
+static const qint64 ACTIVE_CAMERA_TIMEOUT = 200 * 1000 * 1000;
+// the receiver wakeup delay is usually far below a millisecond, cover up to 10 ms with 50 us resolution
+static const qint64 WAKEUP_DELAY_BUCKET_SIZE = 50 * 1000;
+static const int WAKEUP_DELAY_BUCKET_COUNT = 200;
+
 /*!
  * \brief Constructs a Processor
  * \param timer Timer to be used for time scaling
@@ -123,6 +138,12 @@ Processor::Processor(const Timer *timer, bool isReplay) :
     m_tracker(new Tracker(false, false)),
     m_speedTracker(new Tracker(true, true)),
     m_simpleTracker(new Tracker(false, false)),
+    m_visionDecoder(new VisionFrameDecoder),
+    m_trackingPool(new QThreadPool(this)),
+    m_fixedRateLatency(new LatencyHistogram),
+    m_visionTriggeredLatency(new LatencyHistogram),
+    m_refereeWakeupDelay(new LatencyHistogram(WAKEUP_DELAY_BUCKET_SIZE, WAKEUP_DELAY_BUCKET_COUNT)),
+    m_visionWakeupDelay(new LatencyHistogram(WAKEUP_DELAY_BUCKET_SIZE, WAKEUP_DELAY_BUCKET_COUNT)),
     m_mixedTeamInfoSet(false),
     m_refereeInternalActive(isReplay),
     m_lastFlipped(false),
@@ -130,6 +151,10 @@ Processor::Processor(const Timer *timer, bool isReplay) :
     m_transceiverEnabled(isReplay),
     m_saveBallModel(!isReplay)
 {
+    // the main tracker runs on the processor thread
+    m_trackingPool->setMaxThreadCount(2);
+    m_trackingPool->setExpiryTimeout(-1);
+
     // keep two separate referee states
     m_referee = new Referee();
     m_refereeInternal = new Referee();
@@ -154,10 +179,16 @@ Processor::Processor(const Timer *timer, bool isReplay) :
     m_trigger = new QTimer(this);
     connect(m_trigger, SIGNAL(timeout()), SLOT(process()));
     m_trigger->setTimerType(Qt::PreciseTimer);
+    m_triggerInterval = 1000/FREQUENCY;
     if (!isReplay) {
-        m_trigger->start(1000/FREQUENCY);
+        m_trigger->start(m_triggerInterval);
     }
 
+    m_minPeriodTrigger = new QTimer(this);
+    m_minPeriodTrigger->setSingleShot(true);
+    m_minPeriodTrigger->setTimerType(Qt::PreciseTimer);
+    connect(m_minPeriodTrigger, SIGNAL(timeout()), SLOT(processVision()));
+
     connect(timer, &Timer::scalingChanged, this, &Processor::setScaling);
 
     loadConfiguration("division-dimensions", &m_divisionDimensions, false);
@@ -181,29 +212,79 @@ Processor::~Processor()
     qDeleteAll(m_yellowTeam.robots);
 }
 
-Status Processor::assembleStatus(qint64 time, bool resetRaw)
+namespace {
+class TrackerTask : public QRunnable
 {
-    if (m_ballModelUpdated) {
-        // TODO: handle geometry entirely in processor?
-        m_tracker->setGeometryUpdated();
+public:
+    explicit TrackerTask(const std::function<void()> &task) : m_task(task) {}
+    void run() override { m_task(); }
+
+private:
+    std::function<void()> m_task;
+};
+}
+
+void Processor::startTrackerTask(const std::function<void()> &task)
+{
+    if (m_parallelTracking) {
+        m_trackingPool->start(new TrackerTask(task));
+    } else {
+        task();
     }
-    Status status = m_tracker->worldState(time, resetRaw);
-    Status simplePredictionStatus = m_simpleTracker->worldState(time, resetRaw);
-    status->mutable_world_state()->mutable_simple_tracking_blue()->CopyFrom(simplePredictionStatus->world_state().blue());
-    status->mutable_world_state()->mutable_simple_tracking_yellow()->CopyFrom(simplePredictionStatus->world_state().yellow());
-    if (simplePredictionStatus->world_state().has_ball()) {
-        status->mutable_world_state()->mutable_simple_tracking_ball()->CopyFrom(simplePredictionStatus->world_state().ball());
+}
+
+void Processor::setParallelTracking(bool enabled)
+{
+    m_parallelTracking = enabled;
+    m_tracker->setParallelBallFilters(enabled);
+    m_speedTracker->setParallelBallFilters(enabled);
+    m_simpleTracker->setParallelBallFilters(enabled);
+}
+
+void Processor::predictWorldStates(qint64 time, const Status &current, Status &status, Status &simplePredictionStatus)
+{
+    // the trackers continue from the state computed for the current time
+    startTrackerTask([this, time, &simplePredictionStatus]() {
+        simplePredictionStatus = m_simpleTracker->predictWorldState(time, Status());
+    });
+    status = m_tracker->predictWorldState(time, current);
+    m_trackingPool->waitForDone();
+}
+
+void Processor::assembleStatus(Status &status, Status &simplePredictionStatus, bool isPrediction)
+{
+    world::State *worldState = status->mutable_world_state();
+    world::State *simpleState = simplePredictionStatus->mutable_world_state();
+    if (status.keepAlive(simplePredictionStatus)) {
+        // reference the robots instead of copying them
+        for (world::Robot &robot : *simpleState->mutable_blue()) {
+            worldState->mutable_simple_tracking_blue()->UnsafeArenaAddAllocated(&robot);
+        }
+        for (world::Robot &robot : *simpleState->mutable_yellow()) {
+            worldState->mutable_simple_tracking_yellow()->UnsafeArenaAddAllocated(&robot);
+        }
+        if (simpleState->has_ball()) {
+            worldState->unsafe_arena_set_allocated_simple_tracking_ball(simpleState->mutable_ball());
+        }
+    } else {
+        // both messages are on the heap, thus swapping is cheap
+        worldState->mutable_simple_tracking_blue()->Swap(simpleState->mutable_blue());
+        worldState->mutable_simple_tracking_yellow()->Swap(simpleState->mutable_yellow());
+        if (simpleState->has_ball()) {
+            worldState->mutable_simple_tracking_ball()->Swap(simpleState->mutable_ball());
+        }
     }
     if (!m_extraVision.empty()) {
         for(const QByteArray& data : m_extraVision) {
-            status->mutable_world_state()->add_reality()->ParseFromArray(data.data(), data.size());
+            worldState->add_reality()->ParseFromArray(data.data(), data.size());
         }
-        if (resetRaw) {
+        if (isPrediction) {
             m_extraVision.clear();
         }
     }
 
-    if (status->has_geometry()) {
+    // the prediction references the already completed geometry
+    if (!isPrediction && status->has_geometry()) {
         world::Geometry* geometry = status->mutable_geometry();
 
         geometry->mutable_ball_model()->CopyFrom(m_ballModel);
@@ -218,8 +299,6 @@ Status Processor::assembleStatus(qint64 time, bool resetRaw)
             geometry->set_division(world::Geometry_Division_A);
         }
     }
-
-    return status;
 }
 
 world::WorldSource Processor::currentWorldSource() const
@@ -245,17 +324,52 @@ QString Processor::ballModelConfigFile(bool isSimulator)
 void Processor::process(qint64 overwriteTime)
 {
     const qint64 tracker_start = Timer::systemTime();
+    const qint64 traceStart = LatencyTrace::now();
 
     const qint64 current_time = overwriteTime == -1 ? m_timer->currentTime() : overwriteTime;
-    // the controller runs with 100 Hz -> 10ms ticks
+    // the controller runs with 100 Hz -> 10ms ticks, also in the vision triggered mode
     const qint64 tickDuration = 1000 * 1000 * 1000 / FREQUENCY;
+    // the strategy identifies its commands by the time of the strategy status
+    const qint64 traceId = current_time + tickDuration;
+    const bool tracing = m_latencyTrace && overwriteTime == -1;
 
-    // run tracking
+    // frames which arrived after the last notification are still part of this iteration,
+    // their vision triggers must not start a nested iteration
+    m_processing = true;
+    drainVisionIngestQueue();
+
+    m_lastProcessTime = current_time;
+    m_pendingCameras.clear();
+    m_minPeriodTrigger->stop();
+
+    // run tracking, the speed and the simple tracker run on the worker pool
+    if (m_ballModelUpdated) {
+        m_tracker->setGeometryUpdated();
+    }
+    Status radioStatus;
+    Status simplePredictionStatus;
+    float speedTrackerTime = 0;
+    float simpleTrackerTime = 0;
+    startTrackerTask([this, current_time, &radioStatus, &speedTrackerTime]() {
+        const qint64 start = Timer::systemTime();
+        m_speedTracker->process(current_time);
+        radioStatus = m_speedTracker->worldState(current_time, false);
+        speedTrackerTime = (Timer::systemTime() - start) * 1E-9f;
+    });
+    startTrackerTask([this, current_time, &simplePredictionStatus, &simpleTrackerTime]() {
+        const qint64 start = Timer::systemTime();
+        m_simpleTracker->process(current_time);
+        simplePredictionStatus = m_simpleTracker->worldState(current_time, false);
+        simpleTrackerTime = (Timer::systemTime() - start) * 1E-9f;
+    });
     m_tracker->process(current_time);
-    m_speedTracker->process(current_time);
-    m_simpleTracker->process(current_time);
-    Status status = assembleStatus(current_time, false);
-    Status radioStatus = m_speedTracker->worldState(current_time, false);
+    Status status = m_tracker->worldState(current_time, false);
+    const float mainTrackerTime = (Timer::systemTime() - tracker_start) * 1E-9f;
+    m_trackingPool->waitForDone();
+    assembleStatus(status, simplePredictionStatus, false);
+    status->mutable_timing()->set_tracking_main(mainTrackerTime);
+    status->mutable_timing()->set_tracking_speed(speedTrackerTime);
+    status->mutable_timing()->set_tracking_simple(simpleTrackerTime);
 
     // add information, about whether the world state is from the simulator or not
     status->mutable_world_state()->set_is_simulated(m_simulatorEnabled);
@@ -287,6 +401,17 @@ void Processor::process(qint64 overwriteTime)
 
     amun::DebugValues *debug = status->add_debug();
     debug->set_source(amun::Controller);
+    if (overwriteTime == -1) {
+        const float visionLatency = updateVisionLatency(current_time, traceId, traceStart, debug);
+        if (visionLatency >= 0) {
+            status->mutable_timing()->set_vision_latency(visionLatency);
+        }
+    }
+    m_pendingVisionTimes.clear();
+    m_trackedVisionTimes = 0;
+    if (tracing) {
+        m_latencyTrace->writeStatistics(debug, traceStart);
+    }
     QList<robot::RadioCommand> radio_commands_prio;
 
     {
@@ -309,18 +434,21 @@ void Processor::process(qint64 overwriteTime)
 
     // prediction which accounts for the strategy runtime
     // depends on the just created radio command
-    Status strategyStatus = assembleStatus(current_time + tickDuration, true);
+    Status strategyStatus;
+    Status strategySimplePredictionStatus;
+    predictWorldStates(current_time + tickDuration, status, strategyStatus, strategySimplePredictionStatus);
+    assembleStatus(strategyStatus, strategySimplePredictionStatus, true);
     strategyStatus->mutable_world_state()->set_is_simulated(m_simulatorEnabled);
     strategyStatus->mutable_world_state()->set_world_source(currentWorldSource());
     strategyStatus->mutable_game_state()->CopyFrom(activeReferee->gameState());
-    injectExtraData(strategyStatus);
+    referenceSharedData(strategyStatus, status);
     // remove responses after injecting to avoid sending them a second time
     m_responses.clear();
     m_mixedTeamInfo.Clear();
     m_mixedTeamInfoSet = false;
-    // copy to other status message
-    strategyStatus->mutable_user_input_yellow()->CopyFrom(status->user_input_yellow());
-    strategyStatus->mutable_user_input_blue()->CopyFrom(status->user_input_blue());
+    if (tracing) {
+        m_latencyTrace->record(traceId, LatencyTrace::TrackingDone, LatencyTrace::now());
+    }
     emit sendStrategyStatus(strategyStatus);
 
     // publish world state and timing information
@@ -328,10 +456,15 @@ void Processor::process(qint64 overwriteTime)
     emit sendStatus(status);
 
     if (m_transceiverEnabled) {
+        if (tracing) {
+            m_latencyTrace->recordRadioQueued(current_time, m_commandTraces, LatencyTrace::now());
+        }
         emit sendRadioCommands(radio_commands_prio, current_time);
     }
+    m_commandTraces.clear();
 
     m_tracker->finishProcessing();
+    m_processing = false;
 }
 
 const world::Robot* Processor::getWorldRobot(const RobotList &robots, uint id) {
@@ -357,6 +490,33 @@ void Processor::injectExtraData(Status &status)
     }
 }
 
+void Processor::referenceSharedData(Status &strategyStatus, const Status &status)
+{
+    if (!strategyStatus.keepAlive(status)) {
+        injectExtraData(strategyStatus);
+        strategyStatus->mutable_user_input_yellow()->CopyFrom(status->user_input_yellow());
+        strategyStatus->mutable_user_input_blue()->CopyFrom(status->user_input_blue());
+        return;
+    }
+
+    // status is kept alive by the strategy status and isn't modified after this point,
+    // except for its timing
+    amun::Status *source = &*status;
+    world::State *worldState = strategyStatus->mutable_world_state();
+    for (robot::RadioResponse &response : *source->mutable_world_state()->mutable_radio_response()) {
+        worldState->mutable_radio_response()->UnsafeArenaAddAllocated(&response);
+    }
+    if (source->world_state().has_mixed_team_info()) {
+        worldState->unsafe_arena_set_allocated_mixed_team_info(source->mutable_world_state()->mutable_mixed_team_info());
+    }
+    if (source->has_user_input_yellow()) {
+        strategyStatus->unsafe_arena_set_allocated_user_input_yellow(source->mutable_user_input_yellow());
+    }
+    if (source->has_user_input_blue()) {
+        strategyStatus->unsafe_arena_set_allocated_user_input_blue(source->mutable_user_input_blue());
+    }
+}
+
 void Processor::injectUserControl(Status &status, bool isBlue)
 {
     // copy movement commands from input devices
@@ -438,9 +598,173 @@ void Processor::handleRefereePacket(const QByteArray &data, qint64 /*time*/, QSt
 
 void Processor::handleVisionPacket(const QByteArray &data, qint64 time, QString sender)
 {
-    m_tracker->queuePacket(data, time, sender);
-    m_speedTracker->queuePacket(data, time, sender);
-    m_simpleTracker->queuePacket(data, time, sender);
+    const VisionFramePtr frame = m_visionDecoder->decode(data, time, sender);
+    if (frame) {
+        queueVisionFrame(frame, time);
+    }
+}
+
+void Processor::queueVisionFrame(const VisionFramePtr &frame, qint64 time)
+{
+    m_tracker->queueFrame(frame);
+    m_speedTracker->queueFrame(frame);
+    m_simpleTracker->queueFrame(frame);
+
+    if (frame->wrapper.has_detection()) {
+        m_pendingVisionTimes.append(time);
+        handleVisionTrigger(frame->wrapper.detection().camera_id());
+    }
+}
+
+void Processor::handleRefereePackets(const QList<ReceivedPacket> &packets)
+{
+    for (const ReceivedPacket &packet : packets) {
+        if (packet.wakeupDelay >= 0) {
+            m_refereeWakeupDelay->add(packet.wakeupDelay);
+        }
+        handleRefereePacket(packet.data, packet.time, packet.sender);
+    }
+}
+
+void Processor::handleVisionPackets(const QList<ReceivedPacket> &packets)
+{
+    for (const ReceivedPacket &packet : packets) {
+        if (packet.wakeupDelay >= 0) {
+            m_visionWakeupDelay->add(packet.wakeupDelay);
+        }
+        handleVisionPacket(packet.data, packet.time, packet.sender);
+    }
+}
+
+void Processor::setVisionIngestQueue(const std::shared_ptr<VisionIngestQueue> &queue)
+{
+    m_visionIngestQueue = queue;
+}
+
+void Processor::handleIngestedFrames()
+{
+    // a vision trigger may run the processing while draining, which takes the remaining frames
+    drainVisionIngestQueue();
+}
+
+void Processor::drainVisionIngestQueue()
+{
+    if (!m_visionIngestQueue) {
+        return;
+    }
+    // clear the flag first, frames pushed during draining will notify again.
+    // The pops below must not move before the store, otherwise they may miss a frame whose push still saw the flag set
+    m_visionIngestQueue->notified.store(false, std::memory_order_seq_cst);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    IngestedVisionFrame ingested;
+    while (m_visionIngestQueue->frames.pop(ingested)) {
+        if (ingested.wakeupDelay >= 0) {
+            m_visionWakeupDelay->add(ingested.wakeupDelay);
+        }
+        queueVisionFrame(ingested.frame, ingested.time);
+    }
+}
+
+void Processor::handleVisionTrigger(quint32 cameraId)
+{
+    const qint64 now = m_timer->currentTime();
+    m_cameraLastSeen[cameraId] = now;
+    m_pendingCameras.insert(cameraId);
+    if (m_processing || !m_visionTriggered || !m_trigger->isActive()) {
+        return;
+    }
+
+    // wait until every active camera has sent a frame
+    for (auto it = m_cameraLastSeen.begin(); it != m_cameraLastSeen.end();) {
+        if (it.value() + ACTIVE_CAMERA_TIMEOUT < now) {
+            it = m_cameraLastSeen.erase(it);
+            continue;
+        }
+        if (!m_pendingCameras.contains(it.key())) {
+            return;
+        }
+        ++it;
+    }
+
+    const qint64 sinceLastProcess = now - m_lastProcessTime;
+    if (sinceLastProcess >= VISION_TRIGGER_MIN_PERIOD) {
+        processVision();
+    } else if (!m_minPeriodTrigger->isActive()) {
+        const qint64 remaining = VISION_TRIGGER_MIN_PERIOD - sinceLastProcess;
+        m_minPeriodTrigger->start(static_cast<int>((remaining + 999999) / 1000000));
+    }
+}
+
+void Processor::processVision()
+{
+    const qint64 currentTime = m_timer->currentTime();
+    m_lastProcessTime = currentTime;
+    m_pendingCameras.clear();
+    m_minPeriodTrigger->stop();
+
+    // only update the filters, the controllers and the strategy keep their fixed period
+    // and just predict the world state on the next tick
+    startTrackerTask([this, currentTime]() {
+        m_speedTracker->process(currentTime);
+    });
+    startTrackerTask([this, currentTime]() {
+        m_simpleTracker->process(currentTime);
+    });
+    m_tracker->process(currentTime);
+    m_trackingPool->waitForDone();
+
+    addVisionLatencies(currentTime);
+}
+
+void Processor::addVisionLatencies(qint64 time)
+{
+    LatencyHistogram &histogram = m_visionTriggered ? *m_visionTriggeredLatency : *m_fixedRateLatency;
+    for (int i = m_trackedVisionTimes; i < m_pendingVisionTimes.size(); i++) {
+        histogram.add(time - m_pendingVisionTimes[i]);
+    }
+    m_trackedVisionTimes = m_pendingVisionTimes.size();
+}
+
+float Processor::updateVisionLatency(qint64 time, qint64 traceId, qint64 traceStart, amun::DebugValues *debug)
+{
+    addVisionLatencies(time);
+    qint64 maxLatency = -1;
+    for (qint64 receiveTime : m_pendingVisionTimes) {
+        maxLatency = std::max(maxLatency, time - receiveTime);
+    }
+
+    if (m_latencyTrace) {
+        // the processing start creates the trace
+        m_latencyTrace->record(traceId, LatencyTrace::ProcessingStart, traceStart);
+        // the reception time is taken from the timer, convert it to the monotonic clock of the trace
+        if (maxLatency >= 0) {
+            m_latencyTrace->record(traceId, LatencyTrace::VisionReceived, traceStart - maxLatency);
+        }
+    }
+
+    if (time >= m_latencyWindowStart + LATENCY_WINDOW) {
+        m_latencyWindowStart = time;
+        m_fixedRateLatency->finishWindow();
+        m_visionTriggeredLatency->finishWindow();
+        m_visionWakeupDelay->finishWindow();
+        m_refereeWakeupDelay->finishWindow();
+    }
+    // publish both modes for comparison
+    m_fixedRateLatency->writeWindow(debug, "Vision latency/fixed rate");
+    m_visionTriggeredLatency->writeWindow(debug, "Vision latency/vision triggered");
+    if (m_visionWakeupDelay->windowCount() > 0) {
+        m_visionWakeupDelay->writeWindow(debug, "Receiver wakeup delay/vision");
+    }
+    if (m_refereeWakeupDelay->windowCount() > 0) {
+        m_refereeWakeupDelay->writeWindow(debug, "Receiver wakeup delay/referee");
+    }
+    if (m_visionIngestQueue) {
+        amun::DebugValue *dropped = debug->add_value();
+        dropped->set_key("Vision ingest/dropped frames");
+        dropped->set_float_value(m_visionIngestQueue->dropped.load(std::memory_order_relaxed));
+    }
+
+    return (maxLatency < 0) ? -1.0f : maxLatency * 1E-9f;
 }
 
 void Processor::handleSimulatorExtraVision(const QByteArray &data)
@@ -514,6 +838,14 @@ void Processor::handleCommand(const Command &command)
         handleControl(m_yellowTeam, command->control());
     }
 
+    if (command->has_tracking() && command->tracking().has_vision_triggered()) {
+        m_visionTriggered = command->tracking().vision_triggered();
+        m_pendingCameras.clear();
+        if (!m_visionTriggered) {
+            m_minPeriodTrigger->stop();
+        }
+    }
+
     if (command->has_tracking()) {
         const qint64 currentTime = m_timer->currentTime();
         m_tracker->handleCommand(command->tracking(), currentTime);
@@ -558,6 +890,22 @@ void Processor::resetTracking()
     m_simpleTracker->reset();
 }
 
+Processor::TrackingSnapshot Processor::snapshotTracking() const
+{
+    TrackingSnapshot snapshot;
+    snapshot.tracker = m_tracker->snapshot();
+    snapshot.speedTracker = m_speedTracker->snapshot();
+    snapshot.simpleTracker = m_simpleTracker->snapshot();
+    return snapshot;
+}
+
+void Processor::restoreTracking(const TrackingSnapshot &snapshot)
+{
+    m_tracker->restore(*snapshot.tracker);
+    m_speedTracker->restore(*snapshot.speedTracker);
+    m_simpleTracker->restore(*snapshot.simpleTracker);
+}
+
 void Processor::handleControl(Team &team, const amun::CommandControl &control)
 {
     // clear all previously set commands
@@ -577,6 +925,13 @@ void Processor::handleControl(Team &team, const amun::CommandControl &control)
 // blue is actually redundant, but this ensures that only the right strategy can control a robot
 void Processor::handleStrategyCommands(bool blue, const QList<RobotCommandInfo> &commands, qint64 time)
 {
+    if (m_latencyTrace) {
+        m_latencyTrace->record(time, LatencyTrace::CommandsReceived, LatencyTrace::now());
+        if (!m_commandTraces.contains(time)) {
+            m_commandTraces.append(time);
+        }
+    }
+
     for (const RobotCommandInfo &command : commands) {
         Team &team = blue ? m_blueTeam : m_yellowTeam;
         Robot *robot = team.robots.value(qMakePair(command.generation, command.robotId));
@@ -625,6 +980,7 @@ void Processor::setScaling(double scaling)
         m_trigger->stop();
     } else {
         const int t = 10 / scaling;
-        m_trigger->start(qMax(1, t));
+        m_triggerInterval = qMax(1, t);
+        m_trigger->start(m_triggerInterval);
     }
 }
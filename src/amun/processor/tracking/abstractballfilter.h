@@ -56,7 +56,7 @@ struct CameraInfo {
     QMap<int, QString> cameraSender;
 };
 
-typedef KalmanFilter<6, 3> Kalman;
+typedef KalmanFilter<6, 3, float> Kalman;
 
 class AbstractBallFilter {
 public:
@@ -27,7 +27,6 @@
 #include <QDebug>
 
 static const int MAX_FRAMES_PER_FLIGHT = 200; // 60Hz, 3 seconds in the air
-static const int ADDITIONAL_DATA_INSERTION = 1; // these additional are for the position bias
 static const float INITIAL_BIAS_STRENGTH = 0.1f;
 static const float GRAVITY = 9.81;
 
@@ -100,51 +99,49 @@ bool FlyFilter::collision() const
     return (angle < 0.86*M_PI || angle > 1.14*M_PI) && height < 0.15f && robotDist < 0.18f;
 }
 
+void FlyFilter::pinvObservations(int frame, float startTime, Eigen::Matrix<float, 2, 6> &rows, Eigen::Vector2f &values) const
+{
+    const Eigen::Vector3f cam = m_cameraInfo->cameraPosition.value(m_kickFrames.at(frame).cameraId);
+    const float t_i = m_kickFrames.at(frame).captureTime - startTime;
+    const float x = m_kickFrames.at(frame).ballPos(0);
+    const float y = m_kickFrames.at(frame).ballPos(1);
+    const float alpha = (x-cam(0)) / cam(2);
+    const float beta = (y-cam(1)) / cam(2);
+
+    rows << alpha, alpha*t_i, 1, t_i, 0, 0,
+            beta, beta*t_i, 0, 0, 1, t_i;
+    values(0) = 0.5*GRAVITY*alpha*t_i*t_i + x;
+    values(1) = 0.5*GRAVITY*beta*t_i*t_i + y;
+}
+
 auto FlyFilter::calcPinv() -> std::optional<BallFlight>
 {
     const ChipDetection firstInTheAir = m_kickFrames.at(m_shotStartFrame);
 
-    if (m_pinvDataInserted == 0) {
-        m_pinvDataInserted = m_shotStartFrame-1;
+    Eigen::Matrix<float, 2, 6> rows;
+    Eigen::Vector2f values;
+    for (int i = std::max(m_pinvFramesInserted, m_shotStartFrame); i < m_kickFrames.size(); i++) {
+        pinvObservations(i, firstInTheAir.captureTime, rows, values);
+        m_pinvSolver.addObservation(rows.row(0), values(0));
+        m_pinvSolver.addObservation(rows.row(1), values(1));
     }
-    for (int i=m_pinvDataInserted+1; i<m_kickFrames.size(); i++) {
-        const Eigen::Vector3f cam = m_cameraInfo->cameraPosition.value(m_kickFrames.at(i).cameraId);
-        const float t_i = m_kickFrames.at(i).captureTime - firstInTheAir.captureTime;
-        const float x = m_kickFrames.at(i).ballPos(0);
-        const float y = m_kickFrames.at(i).ballPos(1);
-        const float alpha = (x-cam(0)) / cam(2);
-        const float beta = (y-cam(1)) / cam(2);
-
-        const int baseIndex = (i + ADDITIONAL_DATA_INSERTION) * 2;
-        m_D_detailed(baseIndex, 0) = alpha;
-        m_D_detailed(baseIndex, 1) = alpha*t_i;
-        m_D_detailed(baseIndex, 2) = 1;
-        m_D_detailed(baseIndex, 3) = t_i;
-        m_D_detailed(baseIndex, 4) = 0;
-        m_D_detailed(baseIndex, 5) = 0;
-        m_d_detailed(baseIndex) = 0.5*GRAVITY*alpha*t_i*t_i + x;
-
-        m_D_detailed(baseIndex + 1, 0) = beta;
-        m_D_detailed(baseIndex + 1, 1) = beta*t_i;
-        m_D_detailed(baseIndex + 1, 2) = 0;
-        m_D_detailed(baseIndex + 1, 3) = 0;
-        m_D_detailed(baseIndex + 1, 4) = 1;
-        m_D_detailed(baseIndex + 1, 5) = t_i;
-        m_d_detailed(baseIndex + 1) = 0.5*GRAVITY*beta*t_i*t_i + y;
-        m_pinvDataInserted = i;
-    }
-
-    Eigen::VectorXf pi;
+    m_pinvFramesInserted = m_kickFrames.size();
+
+    PinvSolver::Vector pi;
+    float usedBiasStrength = 0;
     float startDistance = 0;
     const float MAX_DISTANCE = 0.03f;
     do {
-        m_D_detailed(0, 2) = m_biasStrength;
-        m_d_detailed(0) = firstInTheAir.ballPos.x() * m_biasStrength;
-        m_D_detailed(1, 4) = m_biasStrength;
-        m_d_detailed(1) = firstInTheAir.ballPos.y() * m_biasStrength;
-
-        const int filledEntries = (m_kickFrames.size() + ADDITIONAL_DATA_INSERTION) * 2;
-        pi = m_D_detailed.block(0, 0, filledEntries, 6).colPivHouseholderQr().solve(m_d_detailed.block(0, 0, filledEntries, 1));
+        // the bias pulls the start position towards the first detection in the air
+        usedBiasStrength = m_biasStrength;
+        PinvSolver biased = m_pinvSolver;
+        PinvSolver::Row biasRow = PinvSolver::Row::Zero();
+        biasRow(2) = m_biasStrength;
+        biased.addObservation(biasRow, firstInTheAir.ballPos.x() * m_biasStrength);
+        biasRow(2) = 0;
+        biasRow(4) = m_biasStrength;
+        biased.addObservation(biasRow, firstInTheAir.ballPos.y() * m_biasStrength);
+        pi = biased.solve();
 
         const Eigen::Vector2f startPos = Eigen::Vector2f(pi(2), pi(4));
         const Eigen::Vector2f trueStart = firstInTheAir.ballPos;
@@ -158,8 +155,12 @@ auto FlyFilter::calcPinv() -> std::optional<BallFlight>
         }
     } while (startDistance > MAX_DISTANCE);
 
-
-    const float piError = (m_D_detailed * pi - m_d_detailed).lpNorm<1>();
+    // the detection thresholds are tuned for the absolute error, which can not be accumulated
+    float piError = usedBiasStrength * (std::abs(pi(2) - firstInTheAir.ballPos.x()) + std::abs(pi(4) - firstInTheAir.ballPos.y()));
+    for (int i = m_shotStartFrame; i < m_kickFrames.size(); i++) {
+        pinvObservations(i, firstInTheAir.captureTime, rows, values);
+        piError += (rows * pi - values).lpNorm<1>();
+    }
 
     const float z0 = pi(0);
     const float vz = pi(1);
@@ -201,16 +202,22 @@ auto FlyFilter::calcPinv() -> std::optional<BallFlight>
     return result;
 }
 
-auto FlyFilter::constrainedReconstruction(Eigen::Vector2f shotStartPos, Eigen::Vector2f groundSpeed,
-                                          float startTime, int startFrame) const -> BallFlight
+auto FlyFilter::constrainedReconstruction(ConstrainedFit &fit, Eigen::Vector2f shotStartPos, Eigen::Vector2f groundSpeed,
+                                          float startTime, int startFrame) -> BallFlight
 {
     groundSpeed = groundSpeed.normalized();
 
-    const int MAX_ENTRIES = 2*(m_kickFrames.size() - startFrame + 1);
-    Eigen::MatrixXf solver = Eigen::MatrixXf::Zero(MAX_ENTRIES, 3);
-    Eigen::VectorXf positions = Eigen::VectorXf::Zero(MAX_ENTRIES);
+    if (fit.startFrame != startFrame || fit.startTime != startTime || fit.startPos != shotStartPos
+            || (fit.direction - groundSpeed).squaredNorm() > 1e-8f) {
+        fit.solver.reset();
+        fit.startPos = shotStartPos;
+        fit.direction = groundSpeed;
+        fit.startTime = startTime;
+        fit.startFrame = startFrame;
+        fit.framesInserted = startFrame;
+    }
 
-    for (int i=startFrame; i < m_kickFrames.size(); i++) {
+    for (int i = fit.framesInserted; i < m_kickFrames.size(); i++) {
         const Eigen::Vector3f cam = m_cameraInfo->cameraPosition.value(m_kickFrames.at(i).cameraId);
         const float t_i = m_kickFrames.at(i).time - startTime;
         const float x = m_kickFrames.at(i).ballPos(0);
@@ -218,21 +225,16 @@ auto FlyFilter::constrainedReconstruction(Eigen::Vector2f shotStartPos, Eigen::V
         const float alpha = (cam(0) - x) / cam(2);
         const float beta = (cam(1) - y) / cam(2);
 
-        const int baseIndex = (i - startFrame) * 2;
-        solver(baseIndex, 0) = alpha*t_i;
-        solver(baseIndex, 1) = -groundSpeed.x() * t_i;
-        solver(baseIndex, 2) = alpha;
-        positions(baseIndex) = 0.5*GRAVITY*alpha*t_i*t_i + shotStartPos.x() - x;
-
-        solver(baseIndex + 1, 0) = beta*t_i;
-        solver(baseIndex + 1, 1) = -groundSpeed.y() * t_i;
-        solver(baseIndex + 1, 2) = beta;
-        positions(baseIndex + 1) = 0.5*GRAVITY*beta*t_i*t_i + shotStartPos.y() - y;
+        fit.solver.addObservation(Eigen::RowVector3f(alpha*t_i, -fit.direction.x() * t_i, alpha),
+                                  0.5*GRAVITY*alpha*t_i*t_i + shotStartPos.x() - x);
+        fit.solver.addObservation(Eigen::RowVector3f(beta*t_i, -fit.direction.y() * t_i, beta),
+                                  0.5*GRAVITY*beta*t_i*t_i + shotStartPos.y() - y);
     }
+    fit.framesInserted = m_kickFrames.size();
 
-    const Eigen::VectorXf values = solver.colPivHouseholderQr().solve(positions);
+    const Eigen::Vector3f values = fit.solver.solve();
 
-    const float error = (solver * values - positions).norm() / (m_kickFrames.size() - startFrame);
+    const float error = std::sqrt(fit.solver.squaredError(values)) / (m_kickFrames.size() - startFrame);
     plot("constrained error", error);
 
     // ignore the z0 component here, since it should be rather small
@@ -241,7 +243,7 @@ auto FlyFilter::constrainedReconstruction(Eigen::Vector2f shotStartPos, Eigen::V
     result.flightStartPos = shotStartPos;
     result.flightStartTime = startTime;
     result.captureFlightStartTime = startTime;
-    result.groundSpeed = groundSpeed.normalized() * values(1);
+    result.groundSpeed = fit.direction * values(1);
     result.zSpeed = values(0);
     result.startFrame = startFrame;
     result.reconstructionError = error;
@@ -253,10 +255,10 @@ Eigen::Vector2f FlyFilter::approxGroundDirection() const
     return m_kickFrames.at(m_shotStartFrame).dribblerPos - m_kickFrames.at(m_shotStartFrame).robotPos;
 }
 
-auto FlyFilter::approachShotDirectionApply() const -> BallFlight
+auto FlyFilter::approachShotDirectionApply() -> BallFlight
 {
     const ChipDetection firstInTheAir = m_kickFrames.at(m_shotStartFrame);
-    BallFlight reconstruction = constrainedReconstruction(firstInTheAir.ballPos, approxGroundDirection(),
+    BallFlight reconstruction = constrainedReconstruction(m_shotDirectionFit, firstInTheAir.ballPos, approxGroundDirection(),
                                                           firstInTheAir.time, m_shotStartFrame);
     reconstruction.flightStartTime -= 0.01f; // -10ms, actual kick was before
     reconstruction.captureFlightStartTime -= 0.01f; // -10ms, actual kick was before
@@ -391,7 +393,7 @@ bool FlyFilter::approachShotDirectionApplicable(const BallFlight &reconstruction
             && maxBallHeight(reconstruction.zSpeed) > 0.3f;
 }
 
-auto FlyFilter::parabolicFlightReconstruct(const BallFlight& pinvRes) const -> std::optional<BallFlight>
+auto FlyFilter::parabolicFlightReconstruct(const BallFlight& pinvRes) -> std::optional<BallFlight>
 {
     if (approachPinvApplicable(pinvRes)) {
         debug("chip approach", "pinv");
@@ -762,8 +764,8 @@ void FlyFilter::updateBouncing(qint64 time)
 
         // if the shot is sufficiently curved, reconstruct the flight with constrained least squares fitting
         if (maxShotLineDist - minShotLineDist > 0.05f && framesSinceBounce > 4) {
-            const BallFlight reconstruction = constrainedReconstruction(currentFlight.flightStartPos, currentFlight.groundSpeed,
-                                                               currentFlight.flightStartTime, currentFlight.startFrame);
+            const BallFlight reconstruction = constrainedReconstruction(m_bounceFit, currentFlight.flightStartPos, currentFlight.groundSpeed,
+                                                                        currentFlight.flightStartTime, currentFlight.startFrame);
             const BallFlight &previousFlight = m_flightReconstructions.at(m_flightReconstructions.size() - 2);
             if (reconstruction.groundSpeed.norm() < previousFlight.groundSpeed.norm()
                     && reconstruction.zSpeed > 0 && reconstruction.zSpeed < previousFlight.zSpeed) {
@@ -856,10 +858,10 @@ void FlyFilter::resetFlightReconstruction()
     m_flightReconstructions.clear();
     m_kickFrames.clear();
     m_shootCommand = ShootCommand::NONE;
-    m_pinvDataInserted = 0;
+    m_pinvFramesInserted = 0;
+    m_pinvSolver.reset();
     m_biasStrength = INITIAL_BIAS_STRENGTH;
-    const int matchEntries = MAX_FRAMES_PER_FLIGHT + ADDITIONAL_DATA_INSERTION;
-    m_d_detailed = Eigen::VectorXf::Zero(2*matchEntries);
-    m_D_detailed = Eigen::MatrixXf::Zero(2*matchEntries, 6);
+    m_shotDirectionFit.reset();
+    m_bounceFit.reset();
 }
 
@@ -22,6 +22,7 @@
 #define BALLFLYFILTER_H
 
 #include "abstractballfilter.h"
+#include "recursiveleastsquares.h"
 #include "protobuf/ssl_detection.pb.h"
 #include "protobuf/world.pb.h"
 
@@ -94,17 +95,32 @@ private:
     bool collision() const;
     unsigned numMeasurementsWithOwnCamera() const;
 
+    typedef RecursiveLeastSquares<6> PinvSolver;
+    // observations of the x and y coordinate of a kick frame, times are relative to startTime
+    void pinvObservations(int frame, float startTime, Eigen::Matrix<float, 2, 6> &rows, Eigen::Vector2f &values) const;
     std::optional<BallFlight> calcPinv();
 
+    // the observations are relative to the flight, thus the fit restarts whenever the flight changes (e.g. after a bounce)
+    struct ConstrainedFit {
+        RecursiveLeastSquares<3> solver;
+        Eigen::Vector2f startPos;
+        Eigen::Vector2f direction;
+        float startTime;
+        int startFrame = -1;
+        int framesInserted;
+
+        void reset() { solver.reset(); startFrame = -1; }
+    };
+
     Eigen::Vector2f approxGroundDirection() const;
-    BallFlight constrainedReconstruction(Eigen::Vector2f shotStartPos, Eigen::Vector2f groundSpeed, float startTime, int startFrame) const;
+    BallFlight constrainedReconstruction(ConstrainedFit &fit, Eigen::Vector2f shotStartPos, Eigen::Vector2f groundSpeed, float startTime, int startFrame);
 
-    BallFlight approachShotDirectionApply() const;
+    BallFlight approachShotDirectionApply();
 
     bool approachPinvApplicable(const BallFlight &pinvRes) const;
     bool approachShotDirectionApplicable(const BallFlight &reconstruction) const;
 
-    std::optional<BallFlight> parabolicFlightReconstruct(const BallFlight &pinvRes) const;
+    std::optional<BallFlight> parabolicFlightReconstruct(const BallFlight &pinvRes);
     void resetFlightReconstruction();
 
     float chipShotError(const BallFlight &pinvRes) const;
@@ -142,9 +158,13 @@ private:
     float m_distToStartPos;
 
     float m_biasStrength;
-    int m_pinvDataInserted;
-    Eigen::VectorXf m_d_detailed;
-    Eigen::MatrixXf m_D_detailed;
+    // the kick frames before this one are part of m_pinvSolver
+    int m_pinvFramesInserted;
+    PinvSolver m_pinvSolver;
+
+    // one fit per call site, as they reconstruct different flights and would restart each other
+    ConstrainedFit m_shotDirectionFit;
+    ConstrainedFit m_bounceFit;
 };
 
 #endif // BALLFLYFILTER_H
@@ -303,7 +303,7 @@ static float distToRobotShadow(Eigen::Vector2f pos, const RobotInfo &robot, floa
 
 bool BallGroundCollisionFilter::isBallCloseToRobotShadow(const VisionFrame &frame) const
 {
-    const Eigen::Vector3f camPos = m_cameraInfo->cameraPosition[m_primaryCamera];
+    const Eigen::Vector3f camPos = m_cameraInfo->cameraPosition.value(m_primaryCamera);
     const Eigen::Vector2f ballPos(frame.x, frame.y);
     const float shadowDist = distToRobotShadow(ballPos, frame.robot, ROBOT_RADIUS, ROBOT_HEIGHT, camPos);
     const float robotDist = (ballPos - frame.robot.robotPos).norm();
@@ -417,7 +417,7 @@ bool BallGroundCollisionFilter::checkFeasibleInvisibility(const QVector<RobotInf
         }
     }
     const float sizeFactor = DRIBBLING_ROBOT_VISIBILITY_FACTOR;
-    const Eigen::Vector3f camPos = m_cameraInfo->cameraPosition[m_primaryCamera];
+    const Eigen::Vector3f camPos = m_cameraInfo->cameraPosition.value(m_primaryCamera);
     return std::any_of(robots.begin(), robots.end(), [=](const RobotInfo &r) {
         return !isBallVisible(ballPos, pastToCurrentRobotInfo(r), ROBOT_RADIUS * sizeFactor,
                               ROBOT_HEIGHT * sizeFactor, camPos);
@@ -488,11 +488,11 @@ bool BallGroundCollisionFilter::handleDribbling(world::Ball *ball, const QVector
 
     const bool wasPushed = isInsideRobot(m_dribbleOffset->pushingBallPos, robot->robotPos, robot->dribblerPos, ROBOT_RADIUS);
     const bool pushingPosVisible = isBallVisible(m_dribbleOffset->pushingBallPos, *robot, ROBOT_RADIUS * DRIBBLING_ROBOT_VISIBILITY_FACTOR,
-                                                 ROBOT_HEIGHT * DRIBBLING_ROBOT_VISIBILITY_FACTOR, m_cameraInfo->cameraPosition[m_primaryCamera]);
+                                                 ROBOT_HEIGHT * DRIBBLING_ROBOT_VISIBILITY_FACTOR, m_cameraInfo->cameraPosition.value(m_primaryCamera));
     bool otherRobotObstruction = false;
     for (const RobotInfo &r : robots) {
         if (r.identifier != robot->identifier && !isBallVisible(m_dribbleOffset->pushingBallPos, r, ROBOT_RADIUS, ROBOT_HEIGHT,
-                           m_cameraInfo->cameraPosition[m_primaryCamera])) {
+                           m_cameraInfo->cameraPosition.value(m_primaryCamera))) {
             otherRobotObstruction = true;
             break;
         }
@@ -606,7 +606,7 @@ void BallGroundCollisionFilter::updateEmptyFrame(qint64 frameTime, const QVector
         if (r != robots.end()) {
             const RobotInfo robot = pastToCurrentRobotInfo(*r);
             const Eigen::Vector2f unprojected = unprojectRelativePosition(m_rotateAndDribbleOffset->ballOffset, robot);
-            if (!isBallVisible(unprojected, robot, ROBOT_RADIUS, ROBOT_HEIGHT, m_cameraInfo->cameraPosition[m_primaryCamera])) {
+            if (!isBallVisible(unprojected, robot, ROBOT_RADIUS, ROBOT_HEIGHT, m_cameraInfo->cameraPosition.value(m_primaryCamera))) {
                 m_dribbleOffset  = m_rotateAndDribbleOffset;
                 debug("activate rotate and dribble", 1);
                 return;
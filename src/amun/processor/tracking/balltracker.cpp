@@ -56,6 +56,25 @@ BallTracker::BallTracker(const BallTracker& previousFilter, qint32 primaryCamera
     m_groundFilter->moveToCamera(primaryCamera);
 }
 
+BallTracker::BallTracker(const BallTracker& filter) :
+    Filter(filter),
+    m_lastUpdateTime(filter.m_lastUpdateTime),
+    m_groundFilter(new BallGroundCollisionFilter(*filter.m_groundFilter, filter.m_primaryCamera)),
+    m_flyFilter(new FlyFilter(*filter.m_flyFilter)),
+    m_visionFrames(filter.m_visionFrames),
+    m_rawMeasurements(filter.m_rawMeasurements),
+    m_cameraInfo(filter.m_cameraInfo),
+    m_initTime(filter.m_initTime),
+    m_lastBallPos(filter.m_lastBallPos),
+    m_lastFrameTime(filter.m_lastFrameTime),
+    m_confidence(filter.m_confidence),
+    m_updateFrameCounter(filter.m_updateFrameCounter),
+    m_cachedDistToCamera(filter.m_cachedDistToCamera)
+#ifdef ENABLE_TRACKING_DEBUG
+    , m_debug(filter.m_debug)
+#endif
+{ }
+
 BallTracker::~BallTracker()
 {
     delete m_flyFilter;
@@ -37,8 +37,9 @@ class BallTracker : public Filter
 public:
     BallTracker(const VisionFrame &frame, CameraInfo* cameraInfo, const FieldTransform &transform, const world::BallModel &ballModel);
     BallTracker(const BallTracker& previousFilter, qint32 primaryCamera);
+    // exact copy, only used for tracker snapshots
+    BallTracker(const BallTracker& filter);
     ~BallTracker() override;
-    BallTracker(const BallTracker&) = delete;
     BallTracker& operator=(const BallTracker&) = delete;
 
 public:
@@ -25,15 +25,16 @@
 
 //! @param DIM dimension of state vector
 //! @param MDIM dimension of observation vector
-template <int DIM, int MDIM>
+//! @param Scalar floating point type used for all computations
+template <int DIM, int MDIM, typename Scalar = double>
 class KalmanFilter
 {
 public:
-    typedef Eigen::Matrix<double, DIM, DIM> Matrix;
-    typedef Eigen::Matrix<double, MDIM, DIM> MatrixM;
-    typedef Eigen::Matrix<double, MDIM, MDIM> MatrixMM;
-    typedef Eigen::Matrix<double, DIM, 1> Vector;
-    typedef Eigen::Matrix<double, MDIM, 1> VectorM;
+    typedef Eigen::Matrix<Scalar, DIM, DIM> Matrix;
+    typedef Eigen::Matrix<Scalar, MDIM, DIM> MatrixM;
+    typedef Eigen::Matrix<Scalar, MDIM, MDIM> MatrixMM;
+    typedef Eigen::Matrix<Scalar, DIM, 1> Vector;
+    typedef Eigen::Matrix<Scalar, MDIM, 1> VectorM;
 
 public:
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -55,8 +56,9 @@ public:
 public:
     void predict(bool permanentUpdate)
     {
-        m_xm = F * m_x + u;
-        m_Pm = B * m_P * B.transpose() + Q;
+        m_xm.noalias() = F * m_x + u;
+        m_Pm.noalias() = B * m_P * B.transpose();
+        m_Pm += Q;
         if (permanentUpdate) {
             m_x = m_xm;
             m_P = m_Pm;
@@ -65,11 +67,18 @@ public:
 
     void update()
     {
-        VectorM y = z - H * m_xm;
-        MatrixMM S = H * m_Pm * H.transpose() + R;
-        Eigen::Matrix<double, DIM, MDIM> K = m_Pm * H.transpose() * S.inverse();
+        const VectorM y = z - H * m_xm;
+        const MatrixM HP = H * m_Pm;
+        MatrixMM S = R;
+        S.noalias() += HP * H.transpose();
+        // m_Pm is symmetric, thus Pm * H^T = (H * Pm)^T
+        // for small observation vectors Eigen inverts S in closed form, which is faster than a decomposition
+        const Eigen::Matrix<Scalar, DIM, MDIM> K = HP.transpose() * S.inverse();
         m_x = m_xm + K * y;
-        m_P = (Matrix::Identity() - K * H) * m_Pm;
+        m_P = m_Pm;
+        m_P.noalias() -= K * HP;
+        // keep the covariance symmetric, rounding errors would accumulate otherwise
+        m_P = (m_P + m_P.transpose()).eval() * Scalar(0.5);
     }
 
     const Vector& state() const
@@ -83,7 +92,7 @@ public:
     }
 
     // !!! Use with care
-    void modifyState(int index, double value)
+    void modifyState(int index, Scalar value)
     {
         m_xm(index) = value;
     }
@@ -0,0 +1,91 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef RECURSIVELEASTSQUARES_H
+#define RECURSIVELEASTSQUARES_H
+
+#include <Eigen/Dense>
+#include <algorithm>
+
+//! Linear least squares fit which is extended by one observation at a time.
+//! Only the normal equations are kept, thus adding an observation and solving
+//! take constant time independent of the number of observations.
+//! @param DIM number of parameters
+template <int DIM>
+class RecursiveLeastSquares
+{
+public:
+    typedef Eigen::Matrix<float, DIM, 1> Vector;
+    typedef Eigen::Matrix<float, 1, DIM> Row;
+
+public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    RecursiveLeastSquares()
+    {
+        reset();
+    }
+
+    void reset()
+    {
+        m_AtA.setZero();
+        m_Atb.setZero();
+        m_btb = 0;
+        m_count = 0;
+    }
+
+    //! adds the observation row * x = value
+    void addObservation(const Row &row, float value)
+    {
+        // the sums are kept in double precision as squaring the problem loses half of the digits
+        const Eigen::Matrix<double, 1, DIM> r = row.template cast<double>();
+        m_AtA.noalias() += r.transpose() * r;
+        m_Atb += r.transpose() * double(value);
+        m_btb += double(value) * value;
+        m_count++;
+    }
+
+    int observationCount() const
+    {
+        return m_count;
+    }
+
+    Vector solve() const
+    {
+        // the pivoting decomposition behaves like the one of the full problem if the fit is underdetermined
+        return m_AtA.colPivHouseholderQr().solve(m_Atb).template cast<float>();
+    }
+
+    //! sum of the squared residuals for the parameters x
+    float squaredError(const Vector &x) const
+    {
+        const Eigen::Matrix<double, DIM, 1> xd = x.template cast<double>();
+        const double error = m_btb - 2 * xd.dot(m_Atb) + xd.dot(m_AtA * xd);
+        // cancellation may result in slightly negative values
+        return float(std::max(0.0, error));
+    }
+
+private:
+    Eigen::Matrix<double, DIM, DIM> m_AtA;
+    Eigen::Matrix<double, DIM, 1> m_Atb;
+    double m_btb;
+    int m_count;
+};
+
+#endif // RECURSIVELEASTSQUARES_H
@@ -0,0 +1,74 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef ROBOTFILTERSTORE_H
+#define ROBOTFILTERSTORE_H
+
+#include <QVector>
+#include <memory>
+#include <vector>
+
+class RobotFilter;
+class SSL_DetectionRobot;
+
+// Holds the robot filters of one team, indexed by robot id.
+// Removed filters are kept in a pool and reused for new hypotheses,
+// thus no allocations happen once all ids have been seen.
+class RobotFilterStore
+{
+public:
+    typedef QVector<RobotFilter*> Hypotheses;
+    typedef std::vector<Hypotheses>::iterator iterator;
+    // larger ids are rejected to bound the size of the index
+    static const uint MAX_ID = 255;
+
+    RobotFilterStore();
+    ~RobotFilterStore();
+    RobotFilterStore(const RobotFilterStore&) = delete;
+    RobotFilterStore& operator=(const RobotFilterStore&) = delete;
+
+public:
+    // creates the slot for the id if necessary
+    Hypotheses &hypotheses(uint id);
+    // returns nullptr if no filter was ever created for the id
+    const Hypotheses *find(uint id) const;
+
+    RobotFilter *create(const SSL_DetectionRobot &robot, qint64 time, bool teamIsYellow);
+    RobotFilter *duplicate(const RobotFilter &filter);
+    // the filter must already be removed from its hypotheses
+    void release(RobotFilter *filter);
+    // releases every filter to the pool
+    void clear();
+    // replaces all hypotheses with copies of those in other
+    void assign(const RobotFilterStore &other);
+
+    iterator begin() { return m_robots.begin(); }
+    iterator end() { return m_robots.end(); }
+
+private:
+    RobotFilter *acquire();
+
+private:
+    std::vector<Hypotheses> m_robots;
+    std::vector<std::unique_ptr<RobotFilter>> m_storage;
+    QVector<RobotFilter*> m_free;
+};
+
+#endif // ROBOTFILTERSTORE_H
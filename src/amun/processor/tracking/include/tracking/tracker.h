@@ -24,11 +24,16 @@
 #include "protobuf/command.pb.h"
 #include "protobuf/status.h"
 #include "protobuf/world.pb.h"
+#include "robotfilterstore.h"
+#include "visionframe.h"
 #include <QMap>
 #include <QPair>
 #include <QByteArray>
+#include <QVector>
+#include <memory>
 
 class BallTracker;
+class QThreadPool;
 class RobotFilter;
 class SSL_DetectionBall;
 class SSL_DetectionFrame;
@@ -39,17 +44,13 @@ class SSL_FieldLineSegment;
 class SSL_GeometryCameraCalibration;
 class FieldTransform;
 struct CameraInfo;
+struct RobotInfo;
+struct TrackerSnapshot;
 
 class Tracker
 {
 private:
-    typedef QMap<uint, QList<RobotFilter*> > RobotMap;
-    struct Packet {
-        Packet(const QByteArray &data, qint64 time, QString sender) : data(data), time(time), sender(sender) {}
-        QByteArray data;
-        qint64 time;
-        QString sender;
-    };
+    typedef RobotFilterStore RobotMap;
 
 public:
     Tracker(bool robotsOnly, bool isSpeedTracker);
@@ -60,28 +61,44 @@ public:
 public:
     void process(qint64 currentTime);
     Status worldState(qint64 currentTime, bool resetRaw);
+    // continues the prediction of the last call to worldState up to the given time,
+    // reuses its filter selection and references the geometry of current instead of copying it.
+    // The returned status is allocated on an arena and resets the raw data
+    Status predictWorldState(qint64 time, const Status &current);
 
     void setFlip(bool flip);
     void queuePacket(const QByteArray &packet, qint64 time, QString sender);
+    // the frame may be shared with other trackers
+    void queueFrame(const VisionFramePtr &frame);
     void queueRadioCommands(const QList<robot::RadioCommand> &radio_commands, qint64 time);
     void handleCommand(const amun::CommandTracking &command, qint64 time);
     void reset();
     void finishProcessing(); // has to be called after all calls to worldState for one frame
     void setGeometryUpdated() { m_geometryUpdated = true; }
     void setBallModel(const world::BallModel &ballModel) { m_ballModel.CopyFrom(ballModel); }
+    // the result is identical either way, disabling avoids the additional threads if many trackers run in parallel
+    void setParallelBallFilters(bool enabled) { m_parallelBallFilters = enabled; }
+
+    // copies the complete filter state, the snapshot can only be restored
+    // to the tracker it was taken from as the filters reference its camera information
+    std::shared_ptr<const TrackerSnapshot> snapshot() const;
+    void restore(const TrackerSnapshot &snapshot);
 
 private:
     void updateCamera(const SSL_GeometryCameraCalibration &c, QString sender);
 
-    void invalidateRobotFilter(QList<RobotFilter*> &filters, const qint64 maxTime, const qint64 maxTimeLast, qint64 currentTime);
+    void invalidateRobotFilter(RobotMap &map, RobotFilterStore::Hypotheses &filters, const qint64 maxTime, const qint64 maxTimeLast, qint64 currentTime);
     void invalidateBall(qint64 currentTime);
     void invalidateRobots(RobotMap &map, qint64 currentTime);
 
     QList<RobotFilter*> getBestRobots(qint64 currentTime, int desiredCamera);
     void trackBallDetections(const SSL_DetectionFrame &frame, qint64 receiveTime, qint64 visionProcessingDelay);
+    void updateBallFilters(qint64 time, const std::vector<VisionFrame> &frames, std::vector<int> &choices);
+    void pruneBallFilters();
     void trackRobot(RobotMap& robotMap, const SSL_DetectionRobot &robot, qint64 receiveTime, qint32 cameraId, qint64 visionProcessingDelay,
                     bool teamIsYellow);
 
+    void writeRobots(qint64 time, world::State *worldState, QVector<RobotInfo> &robotInfos);
     BallTracker* bestBallFilter();
     void prioritizeBallFilters();
 
@@ -102,15 +119,19 @@ private:
     world::BallModel m_ballModel;
 
     QMap<qint32, qint64> m_lastUpdateTime; // indexed by camera id
-    QList<Packet> m_visionPackets;
-
-    /** The last time a slow vision frame was received. Timestamp on a local clock */
-    qint64 m_lastSlowVisionFrame;
-    /** The number of slow vision frames received in the recent past */
-    int m_numSlowVisionFrames;
+    QList<VisionFramePtr> m_visionFrames;
+    // only used for packets passed to queuePacket
+    VisionFrameDecoder m_decoder;
 
     QList<BallTracker*> m_ballFilter;
     BallTracker* m_currentBallFilter;
+    // only created once there are enough ball hypotheses to update them in parallel
+    std::unique_ptr<QThreadPool> m_ballFilterPool;
+    bool m_parallelBallFilters = true;
+    // statistics since the creation of the tracker
+    int m_ballFiltersCreated = 0;
+    int m_ballFiltersPruned = 0;
+    int m_ballFilterSwitches = 0;
 
     RobotMap m_robotFilterYellow;
     RobotMap m_robotFilterBlue;
@@ -122,12 +143,17 @@ private:
     float m_aoi_y2;
 
     QList<QString> m_errorMessages;
-    QList<std::pair<SSL_WrapperPacket, qint64>> m_detectionWrappers;
+    QList<VisionFramePtr> m_detectionWrappers;
     std::unique_ptr<FieldTransform> m_fieldTransform;
 
     // if possible, select robots from this camera
     int m_desiredRobotCamera = -1;
 
+    // filters selected by the last call to worldState, only valid until the next call to process
+    QVector<RobotFilter*> m_selectedYellow;
+    QVector<RobotFilter*> m_selectedBlue;
+    bool m_hasSelection = false;
+
     // differences between tracker and speedtracker
     const bool m_robotsOnly;
     const qint64 m_resetTimeout;
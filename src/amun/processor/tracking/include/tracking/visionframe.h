@@ -0,0 +1,59 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef VISIONFRAME_H
+#define VISIONFRAME_H
+
+#include "protobuf/ssl_wrapper.pb.h"
+#include <QByteArray>
+#include <QSharedPointer>
+#include <QString>
+
+// a vision packet, which is decoded once and then shared by all trackers
+struct VisionFrame
+{
+    SSL_WrapperPacket wrapper;
+    // receive time on the local clock
+    qint64 time;
+    QString sender;
+    // time between capturing and sending the detection frame, 0 if there is no detection
+    qint64 visionProcessingTime;
+    // set on the frame for which the slow vision warning is issued
+    bool slowVisionWarning;
+};
+
+typedef QSharedPointer<const VisionFrame> VisionFramePtr;
+
+class VisionFrameDecoder
+{
+public:
+    // returns a null pointer if the packet is invalid
+    VisionFramePtr decode(const QByteArray &packet, qint64 time, const QString &sender);
+
+private:
+    bool isVisionProcessingSlow(qint64 visionProcessingTime, qint64 time);
+
+private:
+    /** The last time a slow vision frame was received. Timestamp on a local clock */
+    qint64 m_lastSlowVisionFrame = 0;
+    /** The number of slow vision frames received in the recent past */
+    int m_numSlowVisionFrames = 0;
+};
+
+#endif // VISIONFRAME_H
@@ -32,7 +32,8 @@ RobotFilter::RobotFilter(const SSL_DetectionRobot &robot, qint64 lastTime, bool
     m_teamIsYellow(teamIsYellow),
     m_kalman(observationFromDetection(robot)),
     m_futureKalman(observationFromDetection(robot)),
-    m_futureTime(0)
+    m_futureTime(0),
+    m_futureRadioCommandCount(0)
 {
     // we can only observe the position
     m_kalman->H(0, 0) = 1.0;
@@ -42,6 +43,43 @@ RobotFilter::RobotFilter(const SSL_DetectionRobot &robot, qint64 lastTime, bool
     resetFutureKalman();
 }
 
+void RobotFilter::reset(const SSL_DetectionRobot &robot, qint64 lastTime, bool teamIsYellow)
+{
+    m_lastTime = lastTime;
+    m_lastPrimaryTime = 0;
+    m_primaryCamera = -1;
+    m_frameCounter = 0;
+
+    m_id = robot.robot_id();
+    m_teamIsYellow = teamIsYellow;
+    m_lastRaw.clear();
+    m_measurements.clear();
+    m_lastRadioCommand = RadioCommand();
+    m_futureRadioCommand = RadioCommand();
+    m_visionFrames.clear();
+    m_radioCommands.clear();
+    m_futureRadioCommandCount = 0;
+
+    m_kalman.reset(observationFromDetection(robot));
+    m_kalman->H(0, 0) = 1.0;
+    m_kalman->H(1, 1) = 1.0;
+    m_kalman->H(2, 2) = 1.0;
+
+    resetFutureKalman();
+}
+
+RobotFilter::RadioCommand::RadioCommand(const robot::Command &command, qint64 time) :
+    time(time),
+    v_s(command.output1().v_s()),
+    v_f(command.output1().v_f()),
+    omega(command.output1().omega()),
+    kickPower(command.has_kick_power() ? command.kick_power() : 0),
+    chip(command.has_kick_style() && command.kick_style() == robot::Command::Chip),
+    linear(command.has_kick_style() && command.kick_style() == robot::Command::Linear),
+    dribblerActive(command.has_dribbler() && command.dribbler() > 0)
+{
+}
+
 RobotFilter::Kalman::Vector RobotFilter::observationFromDetection(const SSL_DetectionRobot &robot)
 {
     // translate from sslvision coordinate system
@@ -82,12 +120,12 @@ void RobotFilter::update(qint64 time)
         }
 
         // only apply radio commands that have reached the robot yet
-        foreach (const RadioCommand &command, m_radioCommands) {
-            const qint64 commandTime = command.second;
-            if (commandTime > frame.time) {
+        for (int i = 0; i < m_radioCommands.size(); i++) {
+            const RadioCommand &command = m_radioCommands.at(i);
+            if (command.time > frame.time) {
                 break;
             }
-            predict(commandTime, false, true, false, m_lastRadioCommand);
+            predict(command.time, false, true, false, m_lastRadioCommand);
             m_lastRadioCommand = command;
         }
         invalidateRobotCommand(frame.time);
@@ -102,18 +140,20 @@ void RobotFilter::update(qint64 time)
         // prediction is rebased on latest vision frame
         resetFutureKalman();
         m_futureRadioCommand = m_lastRadioCommand;
+        m_futureRadioCommandCount = 0;
     }
 
-    // only apply radio commands that have reached the robot yet
-    foreach (const RadioCommand &command, m_radioCommands) {
-        const qint64 commandTime = command.second;
-        if (commandTime > time) {
+    // only apply radio commands that have reached the robot yet,
+    // continue after the last one applied to the future prediction
+    for (; m_futureRadioCommandCount < m_radioCommands.size(); m_futureRadioCommandCount++) {
+        const RadioCommand &command = m_radioCommands.at(m_futureRadioCommandCount);
+        if (command.time > time) {
             break;
         }
         // only apply radio commands not used yet
-        if (commandTime > m_futureTime) {
+        if (command.time > m_futureTime) {
             // updates m_futureKalman
-            predict(commandTime, true, true, false, m_futureRadioCommand);
+            predict(command.time, true, true, false, m_futureRadioCommand);
             m_futureRadioCommand = command;
         }
     }
@@ -125,12 +165,9 @@ void RobotFilter::update(qint64 time)
 void RobotFilter::invalidateRobotCommand(qint64 time)
 {
     // cleanup outdated radio commands
-    while (!m_radioCommands.isEmpty()) {
-        const RadioCommand &command = m_radioCommands.first();
-        if (command.second > time) {
-            break;
-        }
+    while (!m_radioCommands.isEmpty() && m_radioCommands.first().time <= time) {
         m_radioCommands.removeFirst();
+        m_futureRadioCommandCount = std::max(0, m_futureRadioCommandCount - 1);
     }
 }
 
@@ -158,13 +195,13 @@ void RobotFilter::predict(qint64 time, bool updateFuture, bool permanentUpdate,
     kalman->F(5, 5) = 1;
     // clear control input
     kalman->u = Kalman::Vector::Zero();
-    if (time < cmd.second + 2 * PROCESSOR_TICK_DURATION) {
+    if (time < cmd.time + 2 * PROCESSOR_TICK_DURATION) {
         // radio commands are intended to be applied over 10ms
         float cmd_interval = (float)std::max(PROCESSOR_TICK_DURATION*1E-9, timeDiff);
-        float cmd_omega = cmd.first.output1().omega();
+        float cmd_omega = cmd.omega;
 
-        float cmd_v_s = cmd.first.output1().v_s();
-        float cmd_v_f = cmd.first.output1().v_f();
+        float cmd_v_s = cmd.v_s;
+        float cmd_v_f = cmd.v_f;
 
         // predict phi to execution end time
         float cmd_phi = phi + (omega + cmd_omega) / 2 * cmd_interval;
@@ -398,7 +435,10 @@ void RobotFilter::addVisionFrame(qint32 cameraId, const SSL_DetectionRobot &robo
 
 void RobotFilter::addRadioCommand(const robot::Command &radioCommand, qint64 time)
 {
-    m_radioCommands.append(qMakePair(radioCommand, time));
+    // without vision the buffer may overflow, which drops the oldest command
+    if (m_radioCommands.append(RadioCommand(radioCommand, time))) {
+        m_futureRadioCommandCount = std::max(0, m_futureRadioCommandCount - 1);
+    }
 }
 
 RobotInfo RobotFilter::getRobotInfo() const
@@ -416,11 +456,10 @@ RobotInfo RobotFilter::getRobotInfo() const
     phi = limitAngle(m_kalman->state()(2));
     result.pastDribblerPos = result.pastRobotPos + DRIBBLER_DIST * Eigen::Vector2f(cos(phi), sin(phi));
 
-    const auto& cmd = m_lastRadioCommand.first;
-    result.chipCommand = cmd.has_kick_style() && cmd.kick_style() == robot::Command::Chip;;
-    result.linearCommand = cmd.has_kick_style() && cmd.kick_style() == robot::Command::Linear;
-    result.dribblerActive = cmd.has_dribbler() && cmd.dribbler() > 0;
-    result.kickPower = cmd.has_kick_power() ? cmd.kick_power() : 0;
+    result.chipCommand = m_lastRadioCommand.chip;
+    result.linearCommand = m_lastRadioCommand.linear;
+    result.dribblerActive = m_lastRadioCommand.dribblerActive;
+    result.kickPower = m_lastRadioCommand.kickPower;
 
     result.identifier = m_id + (m_teamIsYellow ? 0 : 100);
 
@@ -27,6 +27,7 @@
 #include "protobuf/ssl_detection.pb.h"
 #include "protobuf/world.pb.h"
 #include "core/fieldtransform.h"
+#include "core/ringbuffer.h"
 #include <QList>
 #include <QMap>
 #include <QPair>
@@ -51,6 +52,8 @@ class RobotFilter : public Filter
 {
 public:
     RobotFilter(const SSL_DetectionRobot &robot, qint64 lastTime, bool teamIsYellow);
+    // reinitializes the filter as if it was newly constructed, reuses the allocated memory
+    void reset(const SSL_DetectionRobot &robot, qint64 lastTime, bool teamIsYellow);
 
     void update(qint64 time);
     void get(world::Robot *robot, const FieldTransform &transform, bool noRawData);
@@ -72,8 +75,23 @@ private:
         qint64 visionProcessingTime;
         bool switchCamera;
     };
-    typedef QPair<robot::Command, qint64> RadioCommand;
-    typedef KalmanFilter<6, 3> Kalman;
+    // the parts of a robot::Command used by the filter
+    struct RadioCommand
+    {
+        RadioCommand() = default;
+        RadioCommand(const robot::Command &command, qint64 time);
+        qint64 time = 0;
+        float v_s = 0;
+        float v_f = 0;
+        float omega = 0;
+        float kickPower = 0;
+        bool chip = false;
+        bool linear = false;
+        bool dribblerActive = false;
+    };
+    typedef KalmanFilter<6, 3, float> Kalman;
+    // radio commands are sent with 100 Hz, thus this covers a bit more than half a second
+    static const int RADIO_COMMAND_BUFFER_SIZE = 64;
 
     void resetFutureKalman();
     void predict(qint64 time, bool updateFuture, bool permanentUpdate, bool cameraSwitched, const RadioCommand &cmd);
@@ -99,6 +117,7 @@ private:
         KalmanHolder(const Kalman::Vector &init) : filter(std::make_unique<Kalman>(init)) {}
         KalmanHolder(const KalmanHolder &other) : filter(std::make_unique<Kalman>(*other.filter)) {}
         void operator=(const KalmanHolder &other) { *filter = *other.filter; }
+        void reset(const Kalman::Vector &init) { *filter = Kalman(init); }
         Kalman *operator->() { return filter.get(); }
         Kalman const *operator->() const { return filter.get(); }
 
@@ -113,7 +132,10 @@ private:
     RadioCommand m_lastRadioCommand;
     RadioCommand m_futureRadioCommand;
     QList<VisionFrame> m_visionFrames;
-    QList<RadioCommand> m_radioCommands;
+    // ringbuffer of the radio commands newer than the last vision frame, ordered by time
+    RingBuffer<RadioCommand, RADIO_COMMAND_BUFFER_SIZE> m_radioCommands;
+    // number of buffered radio commands already applied to m_futureKalman
+    int m_futureRadioCommandCount;
 };
 
 #endif // ROBOTFILTER_H
@@ -0,0 +1,114 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "robotfilterstore.h"
+#include "robotfilter.h"
+
+// SSL robot ids range from 0 to 15
+static const uint DEFAULT_ID_CAPACITY = 16;
+// usually there is one filter per camera in which the robot is visible
+static const int DEFAULT_HYPOTHESES_CAPACITY = 4;
+
+RobotFilterStore::RobotFilterStore()
+{
+    m_robots.reserve(DEFAULT_ID_CAPACITY);
+}
+
+RobotFilterStore::~RobotFilterStore() = default;
+
+RobotFilterStore::Hypotheses &RobotFilterStore::hypotheses(uint id)
+{
+    if (id >= m_robots.size()) {
+        const std::size_t oldSize = m_robots.size();
+        m_robots.resize(id + 1);
+        for (std::size_t i = oldSize; i < m_robots.size(); i++) {
+            m_robots[i].reserve(DEFAULT_HYPOTHESES_CAPACITY);
+        }
+    }
+    return m_robots[id];
+}
+
+const RobotFilterStore::Hypotheses *RobotFilterStore::find(uint id) const
+{
+    if (id >= m_robots.size()) {
+        return nullptr;
+    }
+    return &m_robots[id];
+}
+
+RobotFilter *RobotFilterStore::acquire()
+{
+    if (m_free.isEmpty()) {
+        return nullptr;
+    }
+    RobotFilter *filter = m_free.last();
+    m_free.removeLast();
+    return filter;
+}
+
+RobotFilter *RobotFilterStore::create(const SSL_DetectionRobot &robot, qint64 time, bool teamIsYellow)
+{
+    RobotFilter *filter = acquire();
+    if (filter) {
+        filter->reset(robot, time, teamIsYellow);
+        return filter;
+    }
+    m_storage.emplace_back(new RobotFilter(robot, time, teamIsYellow));
+    return m_storage.back().get();
+}
+
+RobotFilter *RobotFilterStore::duplicate(const RobotFilter &other)
+{
+    RobotFilter *filter = acquire();
+    if (filter) {
+        *filter = other;
+        return filter;
+    }
+    m_storage.emplace_back(new RobotFilter(other));
+    return m_storage.back().get();
+}
+
+void RobotFilterStore::release(RobotFilter *filter)
+{
+    m_free.append(filter);
+}
+
+void RobotFilterStore::clear()
+{
+    for (Hypotheses &list : m_robots) {
+        m_free.append(list);
+        list.clear();
+    }
+}
+
+void RobotFilterStore::assign(const RobotFilterStore &other)
+{
+    clear();
+    for (std::size_t id = 0; id < other.m_robots.size(); id++) {
+        const Hypotheses &filters = other.m_robots[id];
+        if (filters.isEmpty()) {
+            continue;
+        }
+        Hypotheses &list = hypotheses(id);
+        for (const RobotFilter *filter : filters) {
+            list.append(duplicate(*filter));
+        }
+    }
+}
@@ -26,9 +26,19 @@
 #include "protobuf/geometry.h"
 #include "core/fieldtransform.h"
 #include <QDebug>
+#include <QRunnable>
+#include <QThreadPool>
+#include <functional>
 #include <iostream>
 #include <limits>
 
+// upper bound for the number of ball hypotheses, the least promising ones are removed beyond it
+static const int MAX_BALL_FILTERS = 12;
+// below this number of ball hypotheses the overhead of parallel updates is larger than the gain
+static const int MIN_PARALLEL_BALL_FILTERS = 4;
+// the calling thread updates filters as well
+static const int BALL_FILTER_THREADS = 2;
+
 Tracker::Tracker(bool robotsOnly, bool isSpeedTracker) :
     m_cameraInfo(new CameraInfo),
     m_systemDelay(0),
@@ -36,8 +46,6 @@ Tracker::Tracker(bool robotsOnly, bool isSpeedTracker) :
     m_geometryUpdated(false),
     m_hasVisionData(false),
     m_virtualFieldEnabled(false),
-    m_lastSlowVisionFrame(0),
-    m_numSlowVisionFrames(0),
     m_currentBallFilter(nullptr),
     m_aoiEnabled(false),
     m_aoi_x1(0.0f),
@@ -59,6 +67,136 @@ Tracker::~Tracker()
     delete m_cameraInfo;
 }
 
+struct TrackerSnapshot
+{
+    qint64 systemDelay;
+    qint64 timeSinceLastReset;
+    qint64 timeToReset;
+
+    world::Geometry geometry;
+    world::Geometry virtualFieldGeometry;
+    bool geometryUpdated;
+    bool hasVisionData;
+    bool virtualFieldEnabled;
+    world::BallModel ballModel;
+
+    QMap<qint32, qint64> lastUpdateTime;
+    QList<VisionFramePtr> visionFrames;
+    VisionFrameDecoder decoder;
+    CameraInfo cameraInfo;
+    FieldTransform fieldTransform;
+
+    std::vector<std::unique_ptr<BallTracker>> ballFilter;
+    // index into ballFilter, -1 if there is no current ball filter
+    int currentBallFilter;
+    int ballFiltersCreated;
+    int ballFiltersPruned;
+    int ballFilterSwitches;
+
+    RobotFilterStore robotFilterYellow;
+    RobotFilterStore robotFilterBlue;
+
+    bool aoiEnabled;
+    float aoi_x1;
+    float aoi_y1;
+    float aoi_x2;
+    float aoi_y2;
+
+    QList<VisionFramePtr> detectionWrappers;
+    int desiredRobotCamera;
+};
+
+std::shared_ptr<const TrackerSnapshot> Tracker::snapshot() const
+{
+    auto snapshot = std::make_shared<TrackerSnapshot>();
+    snapshot->systemDelay = m_systemDelay;
+    snapshot->timeSinceLastReset = m_timeSinceLastReset;
+    snapshot->timeToReset = m_timeToReset;
+
+    snapshot->geometry.CopyFrom(m_geometry);
+    snapshot->virtualFieldGeometry.CopyFrom(m_virtualFieldGeometry);
+    snapshot->geometryUpdated = m_geometryUpdated;
+    snapshot->hasVisionData = m_hasVisionData;
+    snapshot->virtualFieldEnabled = m_virtualFieldEnabled;
+    snapshot->ballModel.CopyFrom(m_ballModel);
+
+    snapshot->lastUpdateTime = m_lastUpdateTime;
+    snapshot->visionFrames = m_visionFrames;
+    snapshot->decoder = m_decoder;
+    snapshot->cameraInfo = *m_cameraInfo;
+    snapshot->fieldTransform = *m_fieldTransform;
+
+    snapshot->ballFilter.reserve(m_ballFilter.size());
+    for (const BallTracker *filter : m_ballFilter) {
+        snapshot->ballFilter.emplace_back(new BallTracker(*filter));
+    }
+    // the current filter may already have been removed
+    snapshot->currentBallFilter = m_ballFilter.indexOf(m_currentBallFilter);
+    snapshot->ballFiltersCreated = m_ballFiltersCreated;
+    snapshot->ballFiltersPruned = m_ballFiltersPruned;
+    snapshot->ballFilterSwitches = m_ballFilterSwitches;
+
+    snapshot->robotFilterYellow.assign(m_robotFilterYellow);
+    snapshot->robotFilterBlue.assign(m_robotFilterBlue);
+
+    snapshot->aoiEnabled = m_aoiEnabled;
+    snapshot->aoi_x1 = m_aoi_x1;
+    snapshot->aoi_y1 = m_aoi_y1;
+    snapshot->aoi_x2 = m_aoi_x2;
+    snapshot->aoi_y2 = m_aoi_y2;
+
+    snapshot->detectionWrappers = m_detectionWrappers;
+    snapshot->desiredRobotCamera = m_desiredRobotCamera;
+    return snapshot;
+}
+
+void Tracker::restore(const TrackerSnapshot &snapshot)
+{
+    m_systemDelay = snapshot.systemDelay;
+    m_timeSinceLastReset = snapshot.timeSinceLastReset;
+    m_timeToReset = snapshot.timeToReset;
+
+    m_geometry.CopyFrom(snapshot.geometry);
+    m_virtualFieldGeometry.CopyFrom(snapshot.virtualFieldGeometry);
+    m_geometryUpdated = snapshot.geometryUpdated;
+    m_hasVisionData = snapshot.hasVisionData;
+    m_virtualFieldEnabled = snapshot.virtualFieldEnabled;
+    m_ballModel.CopyFrom(snapshot.ballModel);
+
+    m_lastUpdateTime = snapshot.lastUpdateTime;
+    m_visionFrames = snapshot.visionFrames;
+    m_decoder = snapshot.decoder;
+    *m_cameraInfo = snapshot.cameraInfo;
+    *m_fieldTransform = snapshot.fieldTransform;
+
+    qDeleteAll(m_ballFilter);
+    m_ballFilter.clear();
+    for (const auto &filter : snapshot.ballFilter) {
+        m_ballFilter.append(new BallTracker(*filter));
+    }
+    m_currentBallFilter = snapshot.currentBallFilter >= 0 ? m_ballFilter.at(snapshot.currentBallFilter) : nullptr;
+    m_ballFiltersCreated = snapshot.ballFiltersCreated;
+    m_ballFiltersPruned = snapshot.ballFiltersPruned;
+    m_ballFilterSwitches = snapshot.ballFilterSwitches;
+
+    m_robotFilterYellow.assign(snapshot.robotFilterYellow);
+    m_robotFilterBlue.assign(snapshot.robotFilterBlue);
+
+    m_aoiEnabled = snapshot.aoiEnabled;
+    m_aoi_x1 = snapshot.aoi_x1;
+    m_aoi_y1 = snapshot.aoi_y1;
+    m_aoi_x2 = snapshot.aoi_x2;
+    m_aoi_y2 = snapshot.aoi_y2;
+
+    m_detectionWrappers = snapshot.detectionWrappers;
+    m_desiredRobotCamera = snapshot.desiredRobotCamera;
+
+    // the selection references the replaced filters
+    m_hasSelection = false;
+    m_selectedYellow.clear();
+    m_selectedBlue.clear();
+}
+
 static bool isInAOI(float detectionX, float detectionY, const FieldTransform &transform, float x1, float y1, float x2, float y2)
 {
     float x = -detectionY / 1000.0f;
@@ -70,23 +208,20 @@ static bool isInAOI(float detectionX, float detectionY, const FieldTransform &tr
 
 void Tracker::reset()
 {
-    for (const QList<RobotFilter*>& list : m_robotFilterYellow) {
-        qDeleteAll(list);
-    }
+    // the filters are kept for reuse
     m_robotFilterYellow.clear();
-
-    for (const QList<RobotFilter*>& list : m_robotFilterBlue) {
-        qDeleteAll(list);
-    }
     m_robotFilterBlue.clear();
 
     qDeleteAll(m_ballFilter);
     m_ballFilter.clear();
 
     m_hasVisionData = false;
+    m_hasSelection = false;
+    m_selectedYellow.clear();
+    m_selectedBlue.clear();
     m_timeSinceLastReset = 0;
     m_lastUpdateTime.clear();
-    m_visionPackets.clear();
+    m_visionFrames.clear();
     m_cameraInfo->cameraPosition.clear();
     m_cameraInfo->focalLength.clear();
     m_cameraInfo->cameraSender.clear();
@@ -105,27 +240,27 @@ void Tracker::process(qint64 currentTime)
         m_timeSinceLastReset = currentTime;
     }
 
+    // the filters may be removed
+    m_hasSelection = false;
+
     // remove outdated ball and robot filters
     invalidateBall(currentTime);
     invalidateRobots(m_robotFilterYellow, currentTime);
     invalidateRobots(m_robotFilterBlue, currentTime);
 
-    for (const Packet &p : m_visionPackets) {
-        SSL_WrapperPacket wrapper;
-        if (!wrapper.ParseFromArray(p.data.data(), p.data.size())) {
-            continue;
-        }
+    for (const VisionFramePtr &frame : m_visionFrames) {
+        const SSL_WrapperPacket &wrapper = frame->wrapper;
 
         if (wrapper.has_geometry() && !m_robotsOnly) {
             convertFromSSlGeometry(wrapper.geometry().field(), m_geometry);
             for (int i = 0; i < wrapper.geometry().calib_size(); ++i) {
-                updateCamera(wrapper.geometry().calib(i), p.sender);
+                updateCamera(wrapper.geometry().calib(i), frame->sender);
             }
             m_geometryUpdated = true;
         }
 
         if (!m_robotsOnly) {
-            m_detectionWrappers.append({wrapper, p.time});
+            m_detectionWrappers.append(frame);
         }
 
         if (!wrapper.has_detection()) {
@@ -133,50 +268,22 @@ void Tracker::process(qint64 currentTime)
         }
 
         const SSL_DetectionFrame &detection = wrapper.detection();
-        const qint64 visionProcessingTime = (detection.t_sent() - detection.t_capture()) * 1E9;
-
-        /* Misconfigured or slow vision computers may produce detection frames
-         * with a large processing time. We discard these frames later since
-         * they are considered too old to be relevant.
-         */
-        auto isVisionProcessingSlow = [this, currentTime, visionProcessingTime]() -> bool {
-            constexpr qint64 VISION_WARN_TIME = 40 * 1E6; // 40ms to ns
-            if (visionProcessingTime >= VISION_WARN_TIME) {
-                m_numSlowVisionFrames++;
-                m_lastSlowVisionFrame = currentTime;
-            }
+        const qint64 visionProcessingTime = frame->visionProcessingTime;
 
-            /* There may be outliers on the vision computer. We only want to warn
-             * if the delay is continously high
-             */
-            if (m_lastSlowVisionFrame + 10E9 < currentTime) {
-                m_numSlowVisionFrames = 0;
-            }
-
-            /* There should be around 75 detections per second, warn if one third
-             * is bad (25 per second) for around five seconds in a ten second
-             * period
-             */
-            return m_numSlowVisionFrames > 125;
-        };
-
-        if (isVisionProcessingSlow()) {
+        if (frame->slowVisionWarning && !m_robotsOnly) {
             m_errorMessages.append(QString(
                 "<font color=\"red\">WARNING:</font> Multiple vision detection frames with a high processing time. These may be discarded."
             ));
-
-            // Reset to avoid log spam
-            m_numSlowVisionFrames = 0;
         }
 
         // time on the field for which the frame was captured as seen by this computers clock
-        const qint64 sourceTime = p.time - visionProcessingTime - m_systemDelay;
+        const qint64 sourceTime = frame->time - visionProcessingTime - m_systemDelay;
 
         // delayed reset to clear frames older than the reset command
         if (sourceTime > m_timeToReset) {
             m_timeToReset = std::numeric_limits<qint64>::max();
             reset();
-            // reset clears out m_visionPackets, we can not continue in the loop
+            // reset clears out m_visionFrames, we can not continue in the loop
             break;
         }
 
@@ -203,10 +310,10 @@ void Tracker::process(qint64 currentTime)
 
         m_lastUpdateTime[detection.camera_id()] = sourceTime;
     }
-    m_visionPackets.clear();
+    m_visionFrames.clear();
 }
 
-static RobotFilter* bestFilter(QList<RobotFilter*> &filters, int minFrameCount, int desiredCamera)
+static RobotFilter* bestFilter(RobotFilterStore::Hypotheses &filters, int minFrameCount, int desiredCamera)
 {
     // Get first filter of the correct camera that has the minFrameCount and move it to the front
     // This is required to ensure a stable result
@@ -252,7 +359,8 @@ void Tracker::prioritizeBallFilters()
         float sndDist = snd->cachedDistToCamera();
         return fstDist < sndDist;
     };
-    std::sort(m_ballFilter.begin(), m_ballFilter.end(), cmp);
+    // keep the order of filters with equal distance
+    std::stable_sort(m_ballFilter.begin(), m_ballFilter.end(), cmp);
 }
 
 BallTracker* Tracker::bestBallFilter()
@@ -276,6 +384,9 @@ BallTracker* Tracker::bestBallFilter()
             bestConfidence = confidence;
         }
     }
+    if (best != nullptr && m_currentBallFilter != nullptr && best != m_currentBallFilter) {
+        m_ballFilterSwitches++;
+    }
     m_currentBallFilter = best;
     return m_currentBallFilter;
 }
@@ -309,30 +420,29 @@ Status Tracker::worldState(qint64 currentTime, bool resetRaw)
         }
     }
 
-    QVector<RobotInfo> robotInfos;
-    robotInfos.reserve(m_robotFilterBlue.size() + m_robotFilterYellow.size());
+    m_selectedYellow.clear();
     for(RobotMap::iterator it = m_robotFilterYellow.begin(); it != m_robotFilterYellow.end(); ++it) {
         RobotFilter *robot = bestFilter(*it, minFrameCount, m_desiredRobotCamera);
         if (robot != nullptr) {
-            robot->update(currentTime);
-            robot->get(worldState->add_yellow(), *m_fieldTransform, false);
-            robotInfos.append(robot->getRobotInfo());
+            m_selectedYellow.append(robot);
         }
     }
-
+    m_selectedBlue.clear();
     for(RobotMap::iterator it = m_robotFilterBlue.begin(); it != m_robotFilterBlue.end(); ++it) {
         RobotFilter *robot = bestFilter(*it, minFrameCount, m_desiredRobotCamera);
         if (robot != nullptr) {
-            robot->update(currentTime);
-            robot->get(worldState->add_blue(), *m_fieldTransform, false);
-            robotInfos.append(robot->getRobotInfo());
+            m_selectedBlue.append(robot);
         }
     }
+    m_hasSelection = true;
+
+    QVector<RobotInfo> robotInfos;
+    writeRobots(currentTime, worldState, robotInfos);
 
     if (!m_robotsOnly) {
-        for (auto &data : m_detectionWrappers) {
-            worldState->add_vision_frames()->CopyFrom(data.first);
-            worldState->add_vision_frame_times(data.second);
+        for (const VisionFramePtr &frame : m_detectionWrappers) {
+            worldState->add_vision_frames()->CopyFrom(frame->wrapper);
+            worldState->add_vision_frame_times(frame->time);
         }
         m_detectionWrappers.clear();
 
@@ -375,6 +485,21 @@ Status Tracker::worldState(qint64 currentTime, bool resetRaw)
         filter->clearDebugValues();
     }
 #endif
+    if (!m_robotsOnly) {
+        amun::DebugValues *values = mutable_debug(&debug, status);
+        amun::DebugValue *debugValue = values->add_value();
+        debugValue->set_key("Ball hypotheses/count");
+        debugValue->set_float_value(m_ballFilter.size());
+        debugValue = values->add_value();
+        debugValue->set_key("Ball hypotheses/created");
+        debugValue->set_float_value(m_ballFiltersCreated);
+        debugValue = values->add_value();
+        debugValue->set_key("Ball hypotheses/pruned");
+        debugValue->set_float_value(m_ballFiltersPruned);
+        debugValue = values->add_value();
+        debugValue->set_key("Ball hypotheses/switches");
+        debugValue->set_float_value(m_ballFilterSwitches);
+    }
     if (m_errorMessages.size() > 0 && !m_robotsOnly) {
         for (const QString &message : m_errorMessages) {
             amun::StatusLog *log = mutable_debug(&debug, status)->add_log();
@@ -387,6 +512,62 @@ Status Tracker::worldState(qint64 currentTime, bool resetRaw)
     return status;
 }
 
+void Tracker::writeRobots(qint64 time, world::State *worldState, QVector<RobotInfo> &robotInfos)
+{
+    robotInfos.reserve(m_selectedYellow.size() + m_selectedBlue.size());
+    for (RobotFilter *robot : m_selectedYellow) {
+        robot->update(time);
+        robot->get(worldState->add_yellow(), *m_fieldTransform, false);
+        robotInfos.append(robot->getRobotInfo());
+    }
+    for (RobotFilter *robot : m_selectedBlue) {
+        robot->update(time);
+        robot->get(worldState->add_blue(), *m_fieldTransform, false);
+        robotInfos.append(robot->getRobotInfo());
+    }
+}
+
+Status Tracker::predictWorldState(qint64 time, const Status &current)
+{
+    Status status = Status::createArena();
+    if (!m_hasSelection) {
+        // fall back to a full update
+        status->CopyFrom(*worldState(time, true));
+        return status;
+    }
+
+    world::State *worldState = status->mutable_world_state();
+    worldState->set_time(time);
+    worldState->set_has_vision_data(m_hasVisionData);
+    worldState->set_system_delay(m_systemDelay);
+
+    // the filters continue their prediction from the last call to worldState
+    QVector<RobotInfo> robotInfos;
+    writeRobots(time, worldState, robotInfos);
+
+    if (!m_robotsOnly && m_currentBallFilter != nullptr) {
+        BallTracker *ball = m_currentBallFilter;
+        ball->update(time);
+        const qint64 lastCameraFrameTime = m_lastUpdateTime[ball->primaryCamera()];
+        ball->get(worldState->mutable_ball(), *m_fieldTransform, true, robotInfos, lastCameraFrameTime);
+    }
+
+    // the geometry doesn't change between both calls
+    if (!current.isNull() && current->has_geometry() && status.keepAlive(current)) {
+        status->unsafe_arena_set_allocated_geometry(const_cast<world::Geometry*>(&current->geometry()));
+    }
+
+    if (m_aoiEnabled) {
+        world::TrackingAOI *aoi = worldState->mutable_tracking_aoi();
+        aoi->set_x1(m_aoi_x1);
+        aoi->set_y1(m_aoi_y1);
+        aoi->set_x2(m_aoi_x2);
+        aoi->set_y2(m_aoi_y2);
+    }
+
+    return status;
+}
+
 void Tracker::finishProcessing()
 {
     m_geometryUpdated = false;
@@ -415,19 +596,21 @@ void Tracker::updateCamera(const SSL_GeometryCameraCalibration &c, QString sende
     m_cameraInfo->cameraSender[c.camera_id()] = sender;
 }
 
-void Tracker::invalidateRobotFilter(QList<RobotFilter*> &filters, const qint64 maxTime, const qint64 maxTimeLast, qint64 currentTime)
+void Tracker::invalidateRobotFilter(RobotMap &map, RobotFilterStore::Hypotheses &filters, const qint64 maxTime, const qint64 maxTimeLast, qint64 currentTime)
 {
     const int minFrameCount = 5;
 
     // remove outdated filters
-    QMutableListIterator<RobotFilter*> it(filters);
-    while (it.hasNext()) {
-        RobotFilter *filter = it.next();
+    int i = 0;
+    while (i < filters.size()) {
+        RobotFilter *filter = filters[i];
         // last robot has more time, but only if it's visible yet
         const qint64 timeLimit = (filters.size() > 1 || filter->frameCounter() < minFrameCount) ? maxTime : maxTimeLast;
         if (filter->lastUpdate() + timeLimit < currentTime) {
-            delete filter;
-            it.remove();
+            map.release(filter);
+            filters.remove(i);
+        } else {
+            i++;
         }
     }
 }
@@ -504,7 +687,7 @@ void Tracker::invalidateRobots(RobotMap &map, qint64 currentTime)
     // iterate over team
     for(RobotMap::iterator it = map.begin(); it != map.end(); ++it) {
         // remove outdated robots
-        invalidateRobotFilter(*it, maxTime, m_maxTimeLast, currentTime);
+        invalidateRobotFilter(map, *it, maxTime, m_maxTimeLast, currentTime);
     }
 }
 
@@ -590,15 +773,18 @@ void Tracker::trackBallDetections(const SSL_DetectionFrame &frame, qint64 receiv
         return;
     }
 
+    // from a given vision packet, each filter can only accept one detection,
+    // since it is not possible to see the true ball multiple times
+    std::vector<int> choices;
+    updateBallFilters(receiveTime, ballFrames, choices);
+
+    // the choices are applied in the order of the filters, thus the result doesn't depend on the update order
     bool detectionWasAccepted = false;
     std::vector<bool> acceptingFilterWithCamId(ballFrames.size(), false);
     std::vector<BallTracker*> acceptingFilterWithOtherCamId(ballFrames.size(), nullptr);
-    for (BallTracker *filter : m_ballFilter) {
-        filter->update(receiveTime);
-
-        // from a given vision packet, each filter can only accept one detection,
-        // since it is not possible to see the true ball multiple times
-        const int choice = filter->chooseDetection(ballFrames);
+    for (int f = 0; f < m_ballFilter.size(); f++) {
+        BallTracker *filter = m_ballFilter.at(f);
+        const int choice = choices[f];
         if (choice >= 0) {
             if (filter->primaryCamera() == cameraId) {
                 filter->addVisionFrame(ballFrames.at(choice));
@@ -624,9 +810,11 @@ void Tracker::trackBallDetections(const SSL_DetectionFrame &frame, qint64 receiv
                 bt = new BallTracker(ballFrames[i], m_cameraInfo, *m_fieldTransform, m_ballModel);
             }
             m_ballFilter.append(bt);
+            m_ballFiltersCreated++;
             bt->addVisionFrame(ballFrames[i]);
         }
     }
+    pruneBallFilters();
 
     if (detectionWasAccepted) {
         // only prioritize when at least one detection was accepted
@@ -634,10 +822,91 @@ void Tracker::trackBallDetections(const SSL_DetectionFrame &frame, qint64 receiv
     }
 }
 
+namespace {
+class BallFilterTask : public QRunnable
+{
+public:
+    explicit BallFilterTask(const std::function<void()> &task) : m_task(task) {}
+    void run() override { m_task(); }
+
+private:
+    std::function<void()> m_task;
+};
+}
+
+void Tracker::updateBallFilters(qint64 time, const std::vector<VisionFrame> &frames, std::vector<int> &choices)
+{
+    const int count = m_ballFilter.size();
+    choices.assign(count, -1);
+    // the filters only share read only data, each one is updated by exactly one thread
+    auto updateRange = [this, time, &frames, &choices](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            BallTracker *filter = m_ballFilter.at(i);
+            filter->update(time);
+            choices[i] = filter->chooseDetection(frames);
+        }
+    };
+
+    if (!m_parallelBallFilters || count < MIN_PARALLEL_BALL_FILTERS) {
+        updateRange(0, count);
+        return;
+    }
+
+    if (!m_ballFilterPool) {
+        m_ballFilterPool.reset(new QThreadPool);
+        m_ballFilterPool->setMaxThreadCount(BALL_FILTER_THREADS);
+    }
+    const int tasks = BALL_FILTER_THREADS + 1;
+    const int chunkSize = (count + tasks - 1) / tasks;
+    for (int begin = chunkSize; begin < count; begin += chunkSize) {
+        const int end = std::min(count, begin + chunkSize);
+        m_ballFilterPool->start(new BallFilterTask([&updateRange, begin, end]() {
+            updateRange(begin, end);
+        }));
+    }
+    updateRange(0, std::min(count, chunkSize));
+    m_ballFilterPool->waitForDone();
+}
+
+void Tracker::pruneBallFilters()
+{
+    if (m_ballFilter.size() <= MAX_BALL_FILTERS) {
+        return;
+    }
+
+    // the current filter is never removed, of the others prefer to keep
+    // established filters with recent updates and a high confidence.
+    // On ties the filters in front are kept, these were created earlier or are prioritized
+    QList<BallTracker*> candidates;
+    for (auto it = m_ballFilter.rbegin(); it != m_ballFilter.rend(); ++it) {
+        if (*it != m_currentBallFilter) {
+            candidates.append(*it);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](const BallTracker *f1, const BallTracker *f2) {
+        const bool established1 = f1->frameCounter() >= 3;
+        const bool established2 = f2->frameCounter() >= 3;
+        if (established1 != established2) {
+            return established2;
+        }
+        if (f1->lastUpdate() != f2->lastUpdate()) {
+            return f1->lastUpdate() < f2->lastUpdate();
+        }
+        return f1->confidence() < f2->confidence();
+    });
+
+    const int removeCount = m_ballFilter.size() - MAX_BALL_FILTERS;
+    for (int i = 0; i < removeCount; i++) {
+        m_ballFilter.removeOne(candidates.at(i));
+        delete candidates.at(i);
+    }
+    m_ballFiltersPruned += removeCount;
+}
+
 void Tracker::trackRobot(RobotMap &robotMap, const SSL_DetectionRobot &robot, qint64 receiveTime, qint32 cameraId,
                          qint64 visionProcessingDelay, bool teamIsYellow)
 {
-    if (!robot.has_robot_id()) {
+    if (!robot.has_robot_id() || robot.robot_id() > RobotFilterStore::MAX_ID) {
         return;
     }
 
@@ -656,7 +925,7 @@ void Tracker::trackRobot(RobotMap &robotMap, const SSL_DetectionRobot &robot, qi
     RobotFilter *totalClosest = nullptr;
     float totalClosestDist = MAX_DISTANCE;
 
-    QList<RobotFilter*>& list = robotMap[robot.robot_id()];
+    RobotFilterStore::Hypotheses &list = robotMap.hypotheses(robot.robot_id());
     for (RobotFilter *filter : list) {
         filter->update(receiveTime);
         const float dist = filter->distanceTo(robot);
@@ -680,7 +949,7 @@ void Tracker::trackRobot(RobotMap &robotMap, const SSL_DetectionRobot &robot, qi
     }
 
     if (!totalClosest) {
-        totalClosest = new RobotFilter(robot, receiveTime, teamIsYellow);
+        totalClosest = robotMap.create(robot, receiveTime, teamIsYellow);
         list.append(totalClosest);
         nearestFilterByCamera[cameraId] = {totalClosestDist, totalClosest};
     }
@@ -688,7 +957,7 @@ void Tracker::trackRobot(RobotMap &robotMap, const SSL_DetectionRobot &robot, qi
     const auto ownCamera = nearestFilterByCamera.find(cameraId);
     const bool createOwnCameraFilter = ownCamera == nearestFilterByCamera.end();
     if (createOwnCameraFilter) {
-        RobotFilter *filter = new RobotFilter(*totalClosest);
+        RobotFilter *filter = robotMap.duplicate(*totalClosest);
         list.append(filter);
         nearestFilterByCamera[cameraId] = {totalClosestDist, filter};
     }
@@ -701,7 +970,15 @@ void Tracker::trackRobot(RobotMap &robotMap, const SSL_DetectionRobot &robot, qi
 
 void Tracker::queuePacket(const QByteArray &packet, qint64 time, QString sender)
 {
-    m_visionPackets.append(Packet(packet, time, sender));
+    VisionFramePtr frame = m_decoder.decode(packet, time, sender);
+    if (frame) {
+        queueFrame(frame);
+    }
+}
+
+void Tracker::queueFrame(const VisionFramePtr &frame)
+{
+    m_visionFrames.append(frame);
     m_hasVisionData = true;
 }
 
@@ -715,8 +992,11 @@ void Tracker::queueRadioCommands(const QList<robot::RadioCommand> &radio_command
 
         // add radio responses to every available filter
         const RobotMap &teamMap = radioCommand.is_blue() ? m_robotFilterBlue : m_robotFilterYellow;
-        const QList<RobotFilter*>& list = teamMap.value(radioCommand.id());
-        for (RobotFilter *filter : list) {
+        const RobotFilterStore::Hypotheses *list = teamMap.find(radioCommand.id());
+        if (!list) {
+            continue;
+        }
+        for (RobotFilter *filter : *list) {
             filter->addRadioCommand(radioCommand.command(), time);
         }
     }
@@ -0,0 +1,69 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "visionframe.h"
+
+VisionFramePtr VisionFrameDecoder::decode(const QByteArray &packet, qint64 time, const QString &sender)
+{
+    QSharedPointer<VisionFrame> frame(new VisionFrame);
+    if (!frame->wrapper.ParseFromArray(packet.data(), packet.size())) {
+        return VisionFramePtr();
+    }
+    frame->time = time;
+    frame->sender = sender;
+    frame->visionProcessingTime = 0;
+    frame->slowVisionWarning = false;
+    if (frame->wrapper.has_detection()) {
+        const SSL_DetectionFrame &detection = frame->wrapper.detection();
+        frame->visionProcessingTime = (detection.t_sent() - detection.t_capture()) * 1E9;
+        frame->slowVisionWarning = isVisionProcessingSlow(frame->visionProcessingTime, time);
+    }
+    return frame;
+}
+
+bool VisionFrameDecoder::isVisionProcessingSlow(qint64 visionProcessingTime, qint64 time)
+{
+    /* Misconfigured or slow vision computers may produce detection frames
+     * with a large processing time. These are discarded by the tracker since
+     * they are considered too old to be relevant.
+     */
+    constexpr qint64 VISION_WARN_TIME = 40 * 1E6; // 40ms to ns
+    if (visionProcessingTime >= VISION_WARN_TIME) {
+        m_numSlowVisionFrames++;
+        m_lastSlowVisionFrame = time;
+    }
+
+    /* There may be outliers on the vision computer. We only want to warn
+     * if the delay is continously high
+     */
+    if (m_lastSlowVisionFrame + 10E9 < time) {
+        m_numSlowVisionFrames = 0;
+    }
+
+    /* There should be around 75 detections per second, warn if one third
+     * is bad (25 per second) for around five seconds in a ten second
+     * period
+     */
+    if (m_numSlowVisionFrames > 125) {
+        // Reset to avoid log spam
+        m_numSlowVisionFrames = 0;
+        return true;
+    }
+    return false;
+}
@@ -23,12 +23,22 @@
 #include "core/configuration.h"
 
 static const QString SENDER_NAME_FOR_REFEREE = "TrackingReplay";
+// log time between two tracking checkpoints
+static const qint64 CHECKPOINT_INTERVAL = 1000 * 1000 * 1000LL;
+// the oldest checkpoints are dropped beyond this, they also hold the statuses up to the next checkpoint
+static const int MAX_CHECKPOINTS = 120;
+// upper bound for the serialized size of all cached statuses
+static const int STATUS_CACHE_BYTES = 128 * 1024 * 1024;
 
 TrackingReplay::TrackingReplay(Timer *timer) :
     m_timer(timer),
     m_replayProcessor(timer, true),
     m_refereeExtractor(timer->currentTime()),
-    m_statusCache(2000)
+    m_statusCache(STATUS_CACHE_BYTES),
+    m_currentPacketKey(0),
+    m_lastTrackedTime(0),
+    m_retracking(false),
+    m_hasFixedBallModel(false)
 {
     connect(&m_replayProcessor, &Processor::sendStatus, this, &TrackingReplay::ammendStatus);
 
@@ -48,39 +58,212 @@ TrackingReplay::TrackingReplay(Timer *timer) :
     m_replayProcessor.handleCommand(command);
 }
 
+void TrackingReplay::setBallModel(const world::BallModel &ballModel)
+{
+    m_hasFixedBallModel = true;
+    Command command(new amun::Command);
+    command->mutable_tracking()->mutable_ball_model()->CopyFrom(ballModel);
+    m_replayProcessor.handleCommand(command);
+}
+
 void TrackingReplay::ammendStatus(const Status &status)
 {
+    if (m_retracking) {
+        return;
+    }
     status->set_time(m_timer->currentTime());
     if (!m_lastTrackingReplayGameState.isNull()) {
         // add game state information since the replay processor does not have the required data
         status->mutable_game_state()->CopyFrom(m_lastTrackingReplayGameState->game_state());
     }
     // yes, I also do not want to use smart pointers like this
-    m_statusCache.insert(m_currentPacketString, new Status(status));
+    m_statusCache.insert(m_currentPacketKey, new Status(status), status->ByteSize());
     emit gotStatus(status);
 }
 
 void TrackingReplay::handleStatus(const Status &status)
 {
-    const auto previousTime = m_timer->currentTime();
     m_timer->setTime(status->time(), 0);
 
-    // the time does not uniquely identify a status packet, therefore use its full string as identifier
-    // performance is not really a concern here, therefore serializing and hashing string is acceptable
-    const QString identifier = QString::fromStdString(status->SerializeAsString());
-    Status *cached = m_statusCache.object(identifier);
+    const quint64 key = cacheKey(status);
+    Status *cached = m_statusCache.object(key);
     if (cached != nullptr) {
         emit gotStatus(Status(*cached));
         return;
     }
     // since ammendStatus is called synchrenously, this is fine if a bit inelegant
-    m_currentPacketString = identifier;
+    m_currentPacketKey = key;
+
+    if (status->time() < m_lastTrackedTime || status->time() > m_lastTrackedTime + CHECKPOINT_INTERVAL) {
+        seek(status->time());
+        m_timer->setTime(status->time(), 0);
+    }
+    recordCheckpoint(status);
+    processStatus(status);
+    m_lastTrackedTime = status->time();
+}
+
+static void appendField(std::string &buffer, char tag, const google::protobuf::MessageLite &message)
+{
+    buffer.push_back(tag);
+    message.AppendToString(&buffer);
+}
+
+template<typename T>
+static void appendValue(std::string &buffer, char tag, T value)
+{
+    buffer.push_back(tag);
+    buffer.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
 
+quint64 TrackingReplay::cacheKey(const Status &status)
+{
+    // the time does not uniquely identify a status packet, therefore hash it together with
+    // every field that is used by the replay. Debug output and the previous tracking are skipped
+    m_keyBuffer.clear();
+    appendValue(m_keyBuffer, 't', status->time());
     if (status->has_game_state()) {
-        m_lastTrackingReplayGameState = status;
+        appendField(m_keyBuffer, 'g', status->game_state());
     }
-    if (previousTime > status->time()) {
-        m_replayProcessor.resetTracking();
+    if (status->has_team_blue()) {
+        appendField(m_keyBuffer, 'b', status->team_blue());
+    }
+    if (status->has_team_yellow()) {
+        appendField(m_keyBuffer, 'y', status->team_yellow());
+    }
+    if (status->has_geometry() && status->geometry().has_ball_model()) {
+        appendField(m_keyBuffer, 'm', status->geometry().ball_model());
+    }
+    for (const auto &command : status->radio_command()) {
+        appendField(m_keyBuffer, 'r', command);
+    }
+    if (status->has_world_state()) {
+        const world::State &state = status->world_state();
+        appendValue(m_keyBuffer, 'w', state.time());
+        if (state.has_system_delay()) {
+            appendValue(m_keyBuffer, 'd', state.system_delay());
+        }
+        for (const auto &vision : state.vision_frames()) {
+            appendField(m_keyBuffer, 'v', vision);
+        }
+        for (qint64 time : state.vision_frame_times()) {
+            appendValue(m_keyBuffer, 'f', time);
+        }
+        for (const auto &truth : state.reality()) {
+            appendField(m_keyBuffer, 's', truth);
+        }
+    }
+
+    // 64 bit FNV-1a
+    quint64 hash = 14695981039346656037ULL;
+    for (char c : m_keyBuffer) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void TrackingReplay::seek(qint64 time)
+{
+    // latest checkpoint before the time
+    auto it = m_checkpoints.upperBound(time);
+    if (it == m_checkpoints.begin()) {
+        if (time < m_lastTrackedTime) {
+            m_replayProcessor.resetTracking();
+        }
+        return;
+    }
+    --it;
+    // when jumping forward, the current state may be newer than the checkpoint
+    if (time > m_lastTrackedTime && it.key() <= m_lastTrackedTime) {
+        return;
+    }
+
+    m_replayProcessor.restoreTracking(it->snapshot);
+    m_retracking = true;
+    for (const Status &input : it->inputs) {
+        if (input->time() >= time) {
+            break;
+        }
+        m_timer->setTime(input->time(), 0);
+        processStatus(input);
+        m_lastTrackedTime = input->time();
+    }
+    m_retracking = false;
+}
+
+void TrackingReplay::recordCheckpoint(const Status &status)
+{
+    const qint64 time = status->time();
+    auto it = m_checkpoints.upperBound(time);
+    if (it != m_checkpoints.begin()) {
+        --it;
+        if (time < it.key() + CHECKPOINT_INTERVAL) {
+            // only extend the inputs if this status directly continues them, which is not the case after a seek
+            Checkpoint &checkpoint = it.value();
+            if (checkpoint.inputs.last()->time() == m_lastTrackedTime && time >= m_lastTrackedTime) {
+                checkpoint.inputs.append(trackingInput(status));
+            }
+            return;
+        }
+    }
+
+    // the snapshot holds the state before processing the status
+    Checkpoint checkpoint;
+    checkpoint.snapshot = m_replayProcessor.snapshotTracking();
+    checkpoint.inputs.append(trackingInput(status));
+    m_checkpoints.insert(time, checkpoint);
+    if (m_checkpoints.size() > MAX_CHECKPOINTS) {
+        // drop the checkpoint farthest away from the current position, never the one that was just inserted
+        if (time - m_checkpoints.firstKey() >= m_checkpoints.lastKey() - time) {
+            m_checkpoints.erase(m_checkpoints.begin());
+        } else {
+            m_checkpoints.erase(--m_checkpoints.end());
+        }
+    }
+}
+
+QList<qint64> TrackingReplay::checkpointTimes() const
+{
+    return m_checkpoints.keys();
+}
+
+Status TrackingReplay::trackingInput(const Status &status)
+{
+    // only keep the parts used by processStatus, the logged statuses also contain debug output and the tracking
+    Status input(new amun::Status);
+    input->set_time(status->time());
+    if (status->has_game_state()) {
+        input->mutable_game_state()->CopyFrom(status->game_state());
+    }
+    if (status->has_team_blue()) {
+        input->mutable_team_blue()->CopyFrom(status->team_blue());
+    }
+    if (status->has_team_yellow()) {
+        input->mutable_team_yellow()->CopyFrom(status->team_yellow());
+    }
+    if (status->has_geometry() && status->geometry().has_ball_model()) {
+        input->mutable_geometry()->mutable_ball_model()->CopyFrom(status->geometry().ball_model());
+    }
+    input->mutable_radio_command()->CopyFrom(status->radio_command());
+    if (status->has_world_state()) {
+        const world::State &state = status->world_state();
+        world::State *inputState = input->mutable_world_state();
+        inputState->set_time(state.time());
+        if (state.has_system_delay()) {
+            inputState->set_system_delay(state.system_delay());
+        }
+        inputState->mutable_vision_frames()->CopyFrom(state.vision_frames());
+        inputState->mutable_vision_frame_times()->CopyFrom(state.vision_frame_times());
+        inputState->mutable_reality()->CopyFrom(state.reality());
+    }
+    return input;
+}
+
+void TrackingReplay::processStatus(const Status &status)
+{
+    if (status->has_game_state()) {
+        m_lastTrackingReplayGameState = status;
     }
     if (status->has_team_blue()) {
         Command command(new amun::Command);
@@ -92,7 +275,7 @@ void TrackingReplay::handleStatus(const Status &status)
         command->mutable_set_team_yellow()->CopyFrom(status->team_yellow());
         m_replayProcessor.handleCommand(command);
     }
-    if (status->has_geometry() && status->geometry().has_ball_model()) {
+    if (status->has_geometry() && status->geometry().has_ball_model() && !m_hasFixedBallModel) {
         Command command(new amun::Command);
         command->mutable_tracking()->mutable_ball_model()->CopyFrom(status->geometry().ball_model());
         m_replayProcessor.handleCommand(command);
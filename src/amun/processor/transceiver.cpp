@@ -19,6 +19,7 @@
  *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
  ***************************************************************************/
 
+#include "core/latencytrace.h"
 #include "core/timer.h"
 #include "firmware-interface/radiocommand.h"
 #include "firmware-interface/transceiver2012.h"
@@ -820,6 +821,9 @@ void Transceiver::sendCommand(const QList<robot::RadioCommand> &commands, bool c
     }
 
     write(usb_packet.data(), usb_packet.size());
+    if (m_latencyTrace) {
+        m_latencyTrace->recordRadioSent(processingStart, LatencyTrace::now());
+    }
 
     // only restart timeout if not yet active
     if (!m_timeoutTimer->isActive()) {
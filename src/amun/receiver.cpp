@@ -22,7 +22,22 @@
 #include "core/timer.h"
 #include <QNetworkInterface>
 #include <QNetworkProxy>
+#include <QSocketNotifier>
 #include <QUdpSocket>
+#include <algorithm>
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <ctime>
+#include <unistd.h>
+#endif
+
+// maximal number of datagrams read with one system call
+static const int BATCH_SIZE = 16;
+static const int MAX_DATAGRAM_SIZE = 65536;
 
 /*!
  * \class Receiver
@@ -30,7 +45,8 @@
  * \brief UDP multicast receiver
  *
  * This class is designed to timestamp an incoming packet as early as possible
- * by being moved to a dedicated worker thread.
+ * by being moved to a dedicated worker thread. On Linux the packets are read
+ * in batches and timestamped by the kernel, which excludes the event loop delay.
  */
 
 /*!
@@ -41,6 +57,12 @@
  * \param sender The sender of the packet
  */
 
+/*!
+ * \fn void Receiver::gotPackets(const QList<ReceivedPacket> &packets)
+ * \brief This signal is emitted once for all packets read at the same time
+ * \param packets The received packets, in the order of arrival
+ */
+
 /*!
  * \brief Constructor
  * \param groupAddress Address of the multicast group to listen on
@@ -50,7 +72,9 @@ Receiver::Receiver(const QHostAddress &groupAddress, quint16 port, Timer *timer)
     m_groupAddress(groupAddress),
     m_port(port),
     m_socket(nullptr),
-    m_timer(timer)
+    m_timer(timer),
+    m_nativeSocket(-1),
+    m_notifier(nullptr)
 { }
 
 /*!
@@ -68,6 +92,10 @@ void Receiver::startListen()
 {
     stopListen();
 
+    if (listenNative()) {
+        return;
+    }
+
     m_socket = new QUdpSocket(this);
     // Proxying vision / referee packets won't work
     // ssh can't handle udp proxying
@@ -103,6 +131,73 @@ void Receiver::stopListen()
 {
     delete m_socket;
     m_socket = NULL;
+    delete m_notifier;
+    m_notifier = nullptr;
+#ifdef Q_OS_LINUX
+    if (m_nativeSocket >= 0) {
+        close(m_nativeSocket);
+    }
+#endif
+    m_nativeSocket = -1;
+}
+
+/*!
+ * \brief Create a socket which reports kernel receive timestamps
+ * \return false if the platform does not support it, the QUdpSocket is used instead
+ */
+bool Receiver::listenNative()
+{
+#ifdef Q_OS_LINUX
+    const int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return false;
+    }
+    const int enable = 1;
+    if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)) != 0) {
+        close(fd);
+        return false;
+    }
+    // equivalent to QUdpSocket::ShareAddress
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(m_port);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) != 0) {
+        // let the QUdpSocket report the error
+        close(fd);
+        return false;
+    }
+
+    m_nativeSocket = fd;
+    m_buffer.resize(BATCH_SIZE * MAX_DATAGRAM_SIZE);
+    m_notifier = new QSocketNotifier(fd, QSocketNotifier::Read, this);
+    connect(m_notifier, SIGNAL(activated(int)), SLOT(readNativeData()));
+
+    if (!m_groupAddress.isNull()) {
+        foreach (const QNetworkInterface& iface, QNetworkInterface::allInterfaces()) {
+            joinNative(iface);
+        }
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+void Receiver::joinNative(const QNetworkInterface &interface)
+{
+#ifdef Q_OS_LINUX
+    ip_mreqn request = {};
+    request.imr_multiaddr.s_addr = htonl(m_groupAddress.toIPv4Address());
+    request.imr_address.s_addr = htonl(INADDR_ANY);
+    request.imr_ifindex = interface.index();
+    // fails for interfaces without multicast support, just like QUdpSocket::joinMulticastGroup
+    setsockopt(m_nativeSocket, IPPROTO_IP, IP_ADD_MEMBERSHIP, &request, sizeof(request));
+#else
+    Q_UNUSED(interface);
+#endif
 }
 
 /*!
@@ -111,6 +206,10 @@ void Receiver::stopListen()
  */
 void Receiver::updateInterface(const QNetworkInterface& interface)
 {
+    if (m_nativeSocket >= 0 && !m_groupAddress.isNull()) {
+        joinNative(interface);
+        return;
+    }
     if (m_socket == nullptr) {
         return;
     }
@@ -131,9 +230,13 @@ void Receiver::updatePort(quint16 port)
         return;
     }
 
+    // a stopped receiver only remembers the port
+    const bool listening = m_socket != nullptr || m_nativeSocket >= 0;
     stopListen();
     m_port = port;
-    startListen();
+    if (listening) {
+        startListen();
+    }
 }
 
 /*!
@@ -141,11 +244,86 @@ void Receiver::updatePort(quint16 port)
  */
 void Receiver::readData()
 {
+    QList<ReceivedPacket> packets;
     while (m_socket->hasPendingDatagrams()) {
         QByteArray data;
         data.resize(m_socket->pendingDatagramSize());
         QHostAddress senderAdddress;
         m_socket->readDatagram(data.data(), data.size(), &senderAdddress);
-        emit gotPacket(data, m_timer->currentTime(), senderAdddress.toString());
+        packets.append({data, m_timer->currentTime(), senderAdddress.toString(), -1});
+    }
+    emitPackets(packets);
+}
+
+/*!
+ * \brief Read all pending packets with their kernel timestamps
+ */
+void Receiver::readNativeData()
+{
+#ifdef Q_OS_LINUX
+    QList<ReceivedPacket> packets;
+    mmsghdr messages[BATCH_SIZE];
+    iovec buffers[BATCH_SIZE];
+    sockaddr_in senders[BATCH_SIZE];
+    // large enough for the timestamp
+    char controls[BATCH_SIZE][CMSG_SPACE(sizeof(timespec))];
+
+    while (true) {
+        for (int i = 0; i < BATCH_SIZE; i++) {
+            buffers[i].iov_base = m_buffer.data() + i * MAX_DATAGRAM_SIZE;
+            buffers[i].iov_len = MAX_DATAGRAM_SIZE;
+            messages[i].msg_hdr = {};
+            messages[i].msg_hdr.msg_name = &senders[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(senders[i]);
+            messages[i].msg_hdr.msg_iov = &buffers[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+            messages[i].msg_hdr.msg_control = controls[i];
+            messages[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+        }
+        const int count = recvmmsg(m_nativeSocket, messages, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        if (count <= 0) {
+            break;
+        }
+
+        // the kernel timestamps use the realtime clock, only their age is converted to timer time
+        const qint64 now = m_timer->currentTime();
+        timespec realtimeNow;
+        clock_gettime(CLOCK_REALTIME, &realtimeNow);
+        const qint64 realtime = realtimeNow.tv_sec * 1000000000LL + realtimeNow.tv_nsec;
+
+        for (int i = 0; i < count; i++) {
+            const msghdr &header = messages[i].msg_hdr;
+            if (header.msg_flags & MSG_TRUNC) {
+                continue;
+            }
+            qint64 wakeupDelay = -1;
+            for (cmsghdr *control = CMSG_FIRSTHDR(&header); control != nullptr; control = CMSG_NXTHDR(const_cast<msghdr *>(&header), control)) {
+                if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPNS) {
+                    timespec stamp;
+                    memcpy(&stamp, CMSG_DATA(control), sizeof(stamp));
+                    wakeupDelay = std::max(0LL, realtime - (stamp.tv_sec * 1000000000LL + stamp.tv_nsec));
+                }
+            }
+            const qint64 time = wakeupDelay < 0 ? now : now - qint64(wakeupDelay * m_timer->scaling());
+            const QByteArray data(static_cast<const char *>(buffers[i].iov_base), messages[i].msg_len);
+            const QHostAddress sender(ntohl(senders[i].sin_addr.s_addr));
+            packets.append({data, time, sender.toString(), wakeupDelay});
+        }
+        if (count < BATCH_SIZE) {
+            break;
+        }
+    }
+    emitPackets(packets);
+#endif
+}
+
+void Receiver::emitPackets(const QList<ReceivedPacket> &packets)
+{
+    if (packets.isEmpty()) {
+        return;
+    }
+    for (const ReceivedPacket &packet : packets) {
+        emit gotPacket(packet.data, packet.time, packet.sender);
     }
+    emit gotPackets(packets);
 }
@@ -22,8 +22,11 @@
 #define RECEIVER_H
 
 #include <QUdpSocket>
+#include "core/receivedpacket.h"
 #include "protobuf/status.h"
+#include <vector>
 
+class QSocketNotifier;
 class Timer;
 
 class Receiver : public QObject
@@ -38,6 +41,8 @@ public:
 
 signals:
     void gotPacket(const QByteArray &data, qint64 time, QString sender);
+    // all packets that were read at once, emitted after gotPacket for each of them
+    void gotPackets(const QList<ReceivedPacket> &packets);
     void sendStatus(const Status &status);
 
 public slots:
@@ -48,12 +53,22 @@ public slots:
 
 private slots:
     void readData();
+    void readNativeData();
+
+private:
+    bool listenNative();
+    void joinNative(const QNetworkInterface &interface);
+    void emitPackets(const QList<ReceivedPacket> &packets);
 
 private:
     QHostAddress m_groupAddress;
     quint16 m_port;
     QUdpSocket *m_socket;
     Timer *m_timer;
+    // linux only, receives batches with kernel timestamps. -1 if the QUdpSocket is used
+    int m_nativeSocket;
+    QSocketNotifier *m_notifier;
+    std::vector<char> m_buffer;
 };
 
 #endif // RECEIVER_H
@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "bodysnapshot.h"
+
+using namespace camun::simulator;
+
+static void writeVector(const btVector3 &vector, SimulatorSnapshot::Vector *snapshot)
+{
+    snapshot->set_x(vector.x());
+    snapshot->set_y(vector.y());
+    snapshot->set_z(vector.z());
+}
+
+static btVector3 readVector(const SimulatorSnapshot::Vector &snapshot)
+{
+    return btVector3(snapshot.x(), snapshot.y(), snapshot.z());
+}
+
+void camun::simulator::writeTransform(const btTransform &transform, SimulatorSnapshot::Transform *snapshot)
+{
+    writeVector(transform.getOrigin(), snapshot->mutable_origin());
+    snapshot->clear_basis();
+    for (int row = 0;row<3;row++) {
+        for (int column = 0;column<3;column++) {
+            snapshot->add_basis(transform.getBasis()[row][column]);
+        }
+    }
+}
+
+btTransform camun::simulator::readTransform(const SimulatorSnapshot::Transform &snapshot)
+{
+    btTransform transform;
+    transform.setIdentity();
+    if (snapshot.basis_size() == 9) {
+        const auto &b = snapshot.basis();
+        transform.getBasis().setValue(b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7], b[8]);
+    }
+    transform.setOrigin(readVector(snapshot.origin()));
+    return transform;
+}
+
+void camun::simulator::writeBody(const btRigidBody *body, SimulatorSnapshot::RigidBody *snapshot)
+{
+    writeTransform(body->getWorldTransform(), snapshot->mutable_transform());
+    writeTransform(body->getInterpolationWorldTransform(), snapshot->mutable_interpolation_transform());
+    if (body->getMotionState()) {
+        btTransform transform;
+        body->getMotionState()->getWorldTransform(transform);
+        writeTransform(transform, snapshot->mutable_motion_state_transform());
+    }
+    writeVector(body->getLinearVelocity(), snapshot->mutable_linear_velocity());
+    writeVector(body->getAngularVelocity(), snapshot->mutable_angular_velocity());
+    writeVector(body->getInterpolationLinearVelocity(), snapshot->mutable_interpolation_linear_velocity());
+    writeVector(body->getInterpolationAngularVelocity(), snapshot->mutable_interpolation_angular_velocity());
+    snapshot->set_linear_damping(body->getLinearDamping());
+    snapshot->set_angular_damping(body->getAngularDamping());
+    snapshot->set_activation_state(body->getActivationState());
+    snapshot->set_deactivation_time(body->getDeactivationTime());
+    snapshot->set_hit_fraction(body->getHitFraction());
+}
+
+void camun::simulator::restoreBody(btRigidBody *body, const SimulatorSnapshot::RigidBody &snapshot)
+{
+    body->setWorldTransform(readTransform(snapshot.transform()));
+    body->setInterpolationWorldTransform(readTransform(snapshot.interpolation_transform()));
+    if (body->getMotionState() && snapshot.has_motion_state_transform()) {
+        body->getMotionState()->setWorldTransform(readTransform(snapshot.motion_state_transform()));
+    }
+    body->setLinearVelocity(readVector(snapshot.linear_velocity()));
+    body->setAngularVelocity(readVector(snapshot.angular_velocity()));
+    body->setInterpolationLinearVelocity(readVector(snapshot.interpolation_linear_velocity()));
+    body->setInterpolationAngularVelocity(readVector(snapshot.interpolation_angular_velocity()));
+    body->setDamping(snapshot.linear_damping(), snapshot.angular_damping());
+    body->forceActivationState(snapshot.activation_state());
+    body->setDeactivationTime(snapshot.deactivation_time());
+    body->setHitFraction(snapshot.hit_fraction());
+    body->updateInertiaTensor();
+}
@@ -0,0 +1,38 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef BODYSNAPSHOT_H
+#define BODYSNAPSHOT_H
+
+#include "protobuf/ssl_simulation_custom_erforce_snapshot.pb.h"
+#include <btBulletDynamicsCommon.h>
+
+namespace camun {
+    namespace simulator {
+        typedef sslsim::SimulatorSnapshotErForce SimulatorSnapshot;
+
+        void writeTransform(const btTransform &transform, SimulatorSnapshot::Transform *snapshot);
+        btTransform readTransform(const SimulatorSnapshot::Transform &snapshot);
+        void writeBody(const btRigidBody *body, SimulatorSnapshot::RigidBody *snapshot);
+        void restoreBody(btRigidBody *body, const SimulatorSnapshot::RigidBody &snapshot);
+    }
+}
+
+#endif // BODYSNAPSHOT_H
@@ -35,6 +35,8 @@ bool FastSimulator::goWithCallback(camun::simulator::Simulator* sim, Timer* t, q
         qint64 nextTime = std::min(now + maxSimulationStep, targetTime);
         t->setTime(nextTime, 0);
         sim->process();
+        // deliver the vision packets that became due in this step before the callback sees the new state
+        sim->sendVisionPackets();
         now = t->currentTime();
         if (now - lastCallbackTime >= 1e7) {
             callback();
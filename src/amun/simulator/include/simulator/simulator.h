@@ -24,11 +24,13 @@
 #include "protobuf/command.h"
 #include "protobuf/status.h"
 #include "protobuf/sslsim.h"
+#include "protobuf/ssl_simulation_custom_erforce_snapshot.pb.h"
 #include <QList>
 #include <QMap>
 #include <QPair>
 #include <QQueue>
 #include <QByteArray>
+#include <map>
 #include <tuple>
 #include <random>
 
@@ -71,6 +73,16 @@ public:
     Simulator& operator=(const Simulator&) = delete;
     void handleSimulatorTick(double timeStep);
     void seedPRGN(uint32_t seed);
+    // destroys the bullet world and rebuilds it from the snapshot, thus both continue identically.
+    // Every pointer into the simulator, e.g. to robots or the ball, is invalid afterwards
+    sslsim::SimulatorSnapshotErForce captureAndRebuild();
+    // requires the same configuration as for the snapshot, the timer must be reset by the caller
+    void restoreSnapshot(const sslsim::SimulatorSnapshotErForce &snapshot);
+    // sends every vision packet whose delivery time has been reached
+    void sendVisionPackets();
+    // the manually triggered simulator sends the vision packets without the vision delay,
+    // stamped with the time at which they are sent
+    void setImmediateVisionDelivery(bool immediate) { m_immediateVision = immediate; }
 
 signals:
     void gotPacket(const QByteArray &data, qint64 time, QString sender);
@@ -89,14 +101,15 @@ public slots:
     void safelyTeleportBall(const float x, const float y);
     void process();
 
-private slots:
-    void sendVisionPacket();
-
 private:
+    void createWorld();
+    void destroyWorld();
+    void restoreSnapshotRobots(RobotMap &robots, const google::protobuf::RepeatedPtrField<sslsim::SimulatorSnapshotErForce::Robot> &snapshot);
     void sendSSLSimErrorInternal(ErrorSource source);
     void resetFlipped(RobotMap &robots, float side);
     std::tuple<QList<QByteArray>, QByteArray, qint64> createVisionPacket();
     void resetVisionPackets();
+    void scheduleVisionPackets();
     void setTeam(RobotMap &list, float side, const robot::Team &team, QMap<uint32_t, robot::Specs>& specs);
     void moveBall(const sslsim::TeleportBall &ball);
     void moveRobot(const sslsim::TeleportRobot &robot);
@@ -107,9 +120,12 @@ private:
     typedef std::tuple<SSLSimRobotControl, qint64, bool> RadioCommand;
     SimulatorData *m_data;
     QQueue<RadioCommand> m_radioCommands;
-    QQueue<std::tuple<QList<QByteArray>, QByteArray, qint64>> m_visionPackets;
-    QQueue<QTimer *> m_visionTimers;
+    // pending vision packets and simulator truth, ordered by their delivery time
+    std::multimap<qint64, std::tuple<QList<QByteArray>, QByteArray, qint64>> m_visionPackets;
+    // armed for the earliest pending vision packet
+    QTimer *m_visionTimer;
     bool m_isPartial;
+    bool m_immediateVision;
     const Timer *m_timer;
     QTimer *m_trigger;
     qint64 m_time;
@@ -337,6 +337,24 @@ void SimBall::restoreState(const world::SimBall &ball)
     m_body->setAngularVelocity(angular);
 }
 
+void SimBall::writeSnapshot(SimulatorSnapshot::Ball *ball) const
+{
+    writeBody(m_body, ball->mutable_body());
+    if (m_move.ByteSize() > 0) {
+        ball->mutable_move()->CopyFrom(m_move);
+    }
+}
+
+void SimBall::restoreSnapshot(const SimulatorSnapshot::Ball &ball)
+{
+    restoreBody(m_body, ball.body());
+    if (ball.has_move()) {
+        m_move = ball.move();
+    } else {
+        m_move.Clear();
+    }
+}
+
 bool SimBall::isInvalid() const
 {
     const btTransform transform = m_body->getWorldTransform();
@@ -23,6 +23,7 @@
 
 #include "protobuf/command.pb.h"
 #include "protobuf/sslsim.h"
+#include "bodysnapshot.h"
 #include <btBulletDynamicsCommon.h>
 #include "simfield.h"
 #include <QObject>
@@ -64,6 +65,8 @@ public:
     btVector3 speed() const;
     void writeBallState(world::SimBall *ball) const;
     void restoreState(const world::SimBall &ball);
+    void writeSnapshot(SimulatorSnapshot::Ball *ball) const;
+    void restoreSnapshot(const SimulatorSnapshot::Ball &ball);
     btRigidBody *body() const { return m_body; }
     bool isInvalid() const;
 
@@ -695,6 +695,62 @@ void SimRobot::restoreState(const world::SimRobot &robot)
     m_body->setAngularVelocity(angular);
 }
 
+void SimRobot::writeSnapshot(SimulatorSnapshot::Robot *robot) const
+{
+    robot->mutable_specs()->CopyFrom(m_specs);
+    writeBody(m_body, robot->mutable_body());
+    writeBody(m_dribblerBody, robot->mutable_dribbler_body());
+    if (m_holdBallConstraint) {
+        writeTransform(m_holdBallConstraint->getAFrame(), robot->mutable_hold_ball()->mutable_frame_a());
+        writeTransform(m_holdBallConstraint->getBFrame(), robot->mutable_hold_ball()->mutable_frame_b());
+    }
+    if (m_move.has_id()) {
+        robot->mutable_move()->CopyFrom(m_move);
+    }
+    if (m_sslCommand.has_id()) {
+        robot->mutable_command()->CopyFrom(m_sslCommand);
+    }
+    robot->set_charge(m_charge);
+    robot->set_is_charged(m_isCharged);
+    robot->set_in_standby(m_inStandby);
+    robot->set_shoot_time(m_shootTime);
+    robot->set_command_time(m_commandTime);
+    robot->set_error_sum_v_s(error_sum_v_s);
+    robot->set_error_sum_v_f(error_sum_v_f);
+    robot->set_error_sum_omega(error_sum_omega);
+    robot->set_last_send_time(m_lastSendTime);
+}
+
+void SimRobot::restoreSnapshot(const SimulatorSnapshot::Robot &robot, SimBall *ball)
+{
+    restoreBody(m_body, robot.body());
+    restoreBody(m_dribblerBody, robot.dribbler_body());
+    if (robot.has_hold_ball()) {
+        m_holdBallConstraint.reset(new btHingeConstraint(*m_body, *ball->body(),
+                readTransform(robot.hold_ball().frame_a()), readTransform(robot.hold_ball().frame_b())));
+        m_world->addConstraint(m_holdBallConstraint.get(), true);
+    }
+    if (robot.has_move()) {
+        m_move = robot.move();
+    } else {
+        m_move.Clear();
+    }
+    if (robot.has_command()) {
+        m_sslCommand = robot.command();
+    } else {
+        m_sslCommand.Clear();
+    }
+    m_charge = robot.charge();
+    m_isCharged = robot.is_charged();
+    m_inStandby = robot.in_standby();
+    m_shootTime = robot.shoot_time();
+    m_commandTime = robot.command_time();
+    error_sum_v_s = robot.error_sum_v_s();
+    error_sum_v_f = robot.error_sum_v_f();
+    error_sum_omega = robot.error_sum_omega();
+    m_lastSendTime = robot.last_send_time();
+}
+
 void SimRobot::move(const sslsim::TeleportRobot &robot)
 {
     m_move = robot;
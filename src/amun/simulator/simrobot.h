@@ -24,6 +24,7 @@
 #include "protobuf/command.pb.h"
 #include "protobuf/robot.pb.h"
 #include "protobuf/sslsim.h"
+#include "bodysnapshot.h"
 #include <QList>
 #include <Eigen/Dense>
 #include <Eigen/QR>
@@ -60,6 +61,9 @@ public:
     void update(SSL_DetectionRobot *robot, float stddev_p, float stddev_phi, qint64 time, btVector3 positionOffset);
     void update(world::SimRobot *robot, SimBall *ball) const;
     void restoreState(const world::SimRobot &robot);
+    void writeSnapshot(SimulatorSnapshot::Robot *robot) const;
+    // the robot must be newly created, the ball is required to restore a held ball
+    void restoreSnapshot(const SimulatorSnapshot::Robot &robot, SimBall *ball);
     void move(const sslsim::TeleportRobot &robot);
     bool isFlipped();
     btVector3 position() const;
@@ -28,8 +28,11 @@
 #include "simfield.h"
 #include "simrobot.h"
 #include "erroraggregator.h"
+#include "bodysnapshot.h"
 #include <QTimer>
 #include <algorithm>
+#include <cmath>
+#include <sstream>
 #include <QtDebug>
 #include <QVector>
 
@@ -111,6 +114,7 @@ static void simulatorTickCallback(btDynamicsWorld *world, btScalar timeStep)
 
 Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool useManualTrigger) :
     m_isPartial(useManualTrigger),
+    m_immediateVision(false),
     m_timer(timer),
     m_time(0),
     m_lastSentStatusTime(0),
@@ -129,16 +133,12 @@ Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool
         connect(m_trigger, SIGNAL(timeout()), SLOT(process()));
     }
 
-    // setup bullet
-    m_data = new SimulatorData;
-    m_data->collision = new btDefaultCollisionConfiguration();
-    m_data->dispatcher = new btCollisionDispatcher(m_data->collision);
-    m_data->overlappingPairCache = new btDbvtBroadphase();
-    m_data->solver = new btSequentialImpulseConstraintSolver;
-    m_data->dynamicsWorld = new btDiscreteDynamicsWorld(m_data->dispatcher, m_data->overlappingPairCache, m_data->solver, m_data->collision);
-    m_data->dynamicsWorld->setGravity(btVector3(0.0f, 0.0f, -9.81f * SIMULATOR_SCALE));
-    m_data->dynamicsWorld->setInternalTickCallback(simulatorTickCallback, this, true);
+    m_visionTimer = new QTimer(this);
+    m_visionTimer->setTimerType(Qt::PreciseTimer);
+    m_visionTimer->setSingleShot(true);
+    connect(m_visionTimer, &QTimer::timeout, this, &Simulator::sendVisionPackets);
 
+    m_data = new SimulatorData;
     m_data->geometry.CopyFrom(setup.geometry());
     for (const auto& camera : setup.camera_setup()) {
         m_data->reportedCameraSetup.append(camera);
@@ -149,10 +149,8 @@ Simulator::Simulator(const Timer *timer, const amun::SimulatorSetup &setup, bool
         m_data->cameraPositions.append(truePosition);
     }
 
-    // add field and ball
-    m_data->field = new SimField(m_data->dynamicsWorld, m_data->geometry);
-    m_data->ball = new SimBall(&m_data->rng, m_data->dynamicsWorld);
-    connect(m_data->ball, &SimBall::sendSSLSimError, m_aggregator, &ErrorAggregator::aggregate);
+    // setup bullet with field and ball
+    createWorld();
     m_data->flip = false;
     m_data->stddevBall = 0.0f;
     m_data->stddevBallArea = 0.0f;
@@ -186,9 +184,31 @@ static void deleteAll(const Simulator::RobotMap& map) {
 Simulator::~Simulator()
 {
     resetVisionPackets();
+    destroyWorld();
+    delete m_data;
+}
+
+void Simulator::createWorld()
+{
+    m_data->collision = new btDefaultCollisionConfiguration();
+    m_data->dispatcher = new btCollisionDispatcher(m_data->collision);
+    m_data->overlappingPairCache = new btDbvtBroadphase();
+    m_data->solver = new btSequentialImpulseConstraintSolver;
+    m_data->dynamicsWorld = new btDiscreteDynamicsWorld(m_data->dispatcher, m_data->overlappingPairCache, m_data->solver, m_data->collision);
+    m_data->dynamicsWorld->setGravity(btVector3(0.0f, 0.0f, -9.81f * SIMULATOR_SCALE));
+    m_data->dynamicsWorld->setInternalTickCallback(simulatorTickCallback, this, true);
+
+    m_data->field = new SimField(m_data->dynamicsWorld, m_data->geometry);
+    m_data->ball = new SimBall(&m_data->rng, m_data->dynamicsWorld);
+    connect(m_data->ball, &SimBall::sendSSLSimError, m_aggregator, &ErrorAggregator::aggregate);
+}
 
+void Simulator::destroyWorld()
+{
     deleteAll(m_data->robotsBlue);
     deleteAll(m_data->robotsYellow);
+    m_data->robotsBlue.clear();
+    m_data->robotsYellow.clear();
     delete m_data->ball;
     delete m_data->field;
     delete m_data->dynamicsWorld;
@@ -196,7 +216,6 @@ Simulator::~Simulator()
     delete m_data->overlappingPairCache;
     delete m_data->dispatcher;
     delete m_data->collision;
-    delete m_data;
 }
 
 void Simulator::process()
@@ -206,11 +225,9 @@ void Simulator::process()
 
     const qint64 current_time = m_timer->currentTime();
 
-    // first: send vision packets in partial mode
+    // first: send vision packets in partial mode, FastSimulator also sends them after every step
     if (m_isPartial) {
-        while(m_visionPackets.size() > 0 && std::get<2>(m_visionPackets.head()) >= current_time) {
-            sendVisionPacket();
-        }
+        sendVisionPackets();
     }
 
     // collect responses from robots
@@ -273,23 +290,12 @@ void Simulator::process()
     if (m_lastSentStatusTime + 12500000 <= m_time) {
         auto data = createVisionPacket();
 
-
-
-        if (m_isPartial) {
-            std::get<2>(data) = m_time + m_visionDelay;
-            m_visionPackets.enqueue(data);
-        } else {
-            m_visionPackets.enqueue(data);
-            // timeout is in milliseconds
-            int timeout = m_visionDelay * 1E-6 / m_timeScaling;
-
-            // send after timeout, default timer mode, may jitter a bit
-            QTimer *timer = new QTimer();
-            timer->setTimerType(Qt::PreciseTimer);
-            timer->setSingleShot(true);
-            connect(timer, SIGNAL(timeout()), SLOT(sendVisionPacket()));
-            timer->start(timeout);
-            m_visionTimers.enqueue(timer);
+        // the manually triggered simulator only skips the vision delay if requested explicitly
+        std::get<2>(data) = m_isPartial && m_immediateVision ? m_time : m_time + m_visionDelay;
+        const auto inserted = m_visionPackets.emplace(std::get<2>(data), data);
+        // the vision delay may have been reduced, thus the new packet can be the first one
+        if (!m_isPartial && (!m_visionTimer->isActive() || inserted == m_visionPackets.begin())) {
+            scheduleVisionPackets();
         }
 
         m_lastSentStatusTime = m_time;
@@ -549,25 +555,39 @@ std::tuple<QList<QByteArray>, QByteArray, qint64> Simulator::createVisionPacket(
     return {data,d, 0};
 }
 
-void Simulator::sendVisionPacket()
+void Simulator::sendVisionPackets()
 {
-    auto currentVisionPackets = m_visionPackets.dequeue();
-    for (const QByteArray &data : std::get<0>(currentVisionPackets)) {
-        emit gotPacket(data, m_timer->currentTime(), "simulator"); // send "vision packet" and assume instant receiving
-        // the receive time may be a bit jittered just like a real transmission
-
+    const qint64 now = m_timer->currentTime();
+    while (!m_visionPackets.empty() && m_visionPackets.begin()->first <= now) {
+        const auto currentVisionPackets = std::move(m_visionPackets.begin()->second);
+        m_visionPackets.erase(m_visionPackets.begin());
+        // use the exact delivery time instead of the timer wakeup or the end of the simulated step
+        const qint64 receiveTime = m_isPartial && m_immediateVision ? now : std::get<2>(currentVisionPackets);
+        for (const QByteArray &data : std::get<0>(currentVisionPackets)) {
+            emit gotPacket(data, receiveTime, "simulator"); // send "vision packet" and assume instant receiving
+        }
+        emit sendRealData(std::get<1>(currentVisionPackets));
     }
-    emit sendRealData(std::get<1>(currentVisionPackets));
     if (!m_isPartial) {
-        QTimer *timer = m_visionTimers.dequeue();
-        timer->deleteLater();
+        scheduleVisionPackets();
     }
 }
 
+void Simulator::scheduleVisionPackets()
+{
+    if (m_visionPackets.empty() || m_timeScaling <= 0) {
+        m_visionTimer->stop();
+        return;
+    }
+    // the timer has millisecond resolution, round up to never send a packet early
+    const qint64 remaining = std::max<qint64>(0, m_visionPackets.begin()->first - m_timer->currentTime());
+    const int timeout = static_cast<int>(std::ceil(remaining * 1E-6 / m_timeScaling));
+    m_visionTimer->start(timeout);
+}
+
 void Simulator::resetVisionPackets()
 {
-    qDeleteAll(m_visionTimers);
-    m_visionTimers.clear();
+    m_visionTimer->stop();
     m_visionPackets.clear();
 }
 
@@ -870,6 +890,8 @@ void Simulator::handleCommand(const Command &command)
 
 void Simulator::setScaling(double scaling)
 {
+    // needed if scaling is set before simulator was enabled
+    m_timeScaling = scaling;
     if (scaling <= 0 || !m_enabled) {
         m_trigger->stop();
         // clear pending vision packets
@@ -879,20 +901,161 @@ void Simulator::setScaling(double scaling)
         const int t = 5 / scaling;
         m_trigger->start(qMax(1, t));
 
-        // The vision packet timings are wrong after a scaling change
-        // In addition if the new scaling is larger than the old one,
-        // this would cause the timers started after the scaling change
-        // to trigger before the old timers, what causes the deletion of
-        // the old timers before they are fired.
-        resetVisionPackets();
+        // the delivery times are on the scaled clock and stay valid, only the timeout changes
+        if (!m_isPartial) {
+            scheduleVisionPackets();
+        }
     }
-    // needed if scaling is set before simulator was enabled
-    m_timeScaling = scaling;
 }
 
 void Simulator::seedPRGN(uint32_t seed)
 {
     m_data->rng.seed(seed);
+    rand_shuffle_src.seed(seed);
+}
+
+static void writeRobots(const Simulator::RobotMap &robots, google::protobuf::RepeatedPtrField<SimulatorSnapshot::Robot> *snapshot)
+{
+    for (const auto &robot : robots) {
+        SimulatorSnapshot::Robot *robotSnapshot = snapshot->Add();
+        robotSnapshot->set_generation(robot.second);
+        robot.first->writeSnapshot(robotSnapshot);
+    }
+}
+
+static void writeSpecs(const QMap<uint32_t, robot::Specs> &specs, google::protobuf::RepeatedPtrField<robot::Specs> *snapshot)
+{
+    for (const robot::Specs &robotSpecs : specs) {
+        snapshot->Add()->CopyFrom(robotSpecs);
+    }
+}
+
+/*!
+ * \brief Captures the complete simulator state
+ *
+ * Bullet keeps caches between steps (contact points, broadphase pairs), which are not part of the snapshot.
+ * Therefore the simulator is rebuilt from the snapshot right away. Continuing from here and
+ * from every later \ref restoreSnapshot is then bit identical. As the bullet world, the robots
+ * and the ball are recreated, pointers to them must not be kept across this call.
+ */
+SimulatorSnapshot Simulator::captureAndRebuild()
+{
+    SimulatorSnapshot snapshot;
+    snapshot.set_time(m_time);
+    snapshot.set_last_sent_status_time(m_lastSentStatusTime);
+    snapshot.set_last_ball_send_time(m_lastBallSendTime);
+    for (const auto &frameNumber : m_lastFrameNumber) {
+        SimulatorSnapshot::FrameNumber *frame = snapshot.add_frame_numbers();
+        frame->set_camera_id(frameNumber.first);
+        frame->set_frame_number(frameNumber.second);
+    }
+    snapshot.set_charge(m_charge);
+    snapshot.set_flip(m_data->flip);
+
+    uint32_t s1, s2, s3;
+    m_data->rng.state(s1, s2, s3);
+    snapshot.set_rng_s1(s1);
+    snapshot.set_rng_s2(s2);
+    snapshot.set_rng_s3(s3);
+    std::ostringstream shuffleState;
+    shuffleState << rand_shuffle_src;
+    snapshot.set_shuffle_rng(shuffleState.str());
+
+    m_data->ball->writeSnapshot(snapshot.mutable_ball());
+    writeRobots(m_data->robotsBlue, snapshot.mutable_blue_robots());
+    writeRobots(m_data->robotsYellow, snapshot.mutable_yellow_robots());
+    writeSpecs(m_data->specsBlue, snapshot.mutable_blue_specs());
+    writeSpecs(m_data->specsYellow, snapshot.mutable_yellow_specs());
+
+    for (const RadioCommand &command : m_radioCommands) {
+        SimulatorSnapshot::RadioCommand *radioCommand = snapshot.add_radio_commands();
+        radioCommand->mutable_control()->CopyFrom(*std::get<0>(command));
+        radioCommand->set_processing_start(std::get<1>(command));
+        radioCommand->set_is_blue(std::get<2>(command));
+    }
+
+    for (const auto &packet : m_visionPackets) {
+        SimulatorSnapshot::VisionPacket *visionPacket = snapshot.add_vision_packets();
+        visionPacket->set_deadline(packet.first);
+        for (const QByteArray &data : std::get<0>(packet.second)) {
+            visionPacket->add_vision(data.toStdString());
+        }
+        visionPacket->set_truth(std::get<1>(packet.second).toStdString());
+        visionPacket->set_time(std::get<2>(packet.second));
+    }
+
+    restoreSnapshot(snapshot);
+    return snapshot;
+}
+
+void Simulator::restoreSnapshotRobots(RobotMap &robots, const google::protobuf::RepeatedPtrField<SimulatorSnapshot::Robot> &snapshot)
+{
+    for (const SimulatorSnapshot::Robot &robot : snapshot) {
+        // start at the stored position to avoid overlaps with the robots created before
+        const btVector3 position = readTransform(robot.body().transform()).getOrigin() / SIMULATOR_SCALE;
+        SimRobot *simRobot = new SimRobot(&m_data->rng, robot.specs(), m_data->dynamicsWorld, btVector3(position.x(), position.y(), 0), 0.0f);
+        simRobot->setDribbleMode(m_data->dribblePerfect);
+        connect(simRobot, &SimRobot::sendSSLSimError, m_aggregator, &ErrorAggregator::aggregate);
+        simRobot->restoreSnapshot(robot, m_data->ball);
+        robots[robot.specs().id()] = {simRobot, robot.generation()};
+    }
+}
+
+/*!
+ * \brief Continues from a snapshot taken with \ref captureAndRebuild
+ *
+ * The simulator configuration has to be the same as when taking the snapshot.
+ * The caller is responsible to set the timer back to the snapshot time.
+ */
+void Simulator::restoreSnapshot(const SimulatorSnapshot &snapshot)
+{
+    // rebuild bullet from scratch, its caches would otherwise influence the continuation
+    destroyWorld();
+    createWorld();
+
+    m_time = snapshot.time();
+    m_lastSentStatusTime = snapshot.last_sent_status_time();
+    m_lastBallSendTime = snapshot.last_ball_send_time();
+    m_lastFrameNumber.clear();
+    for (const SimulatorSnapshot::FrameNumber &frame : snapshot.frame_numbers()) {
+        m_lastFrameNumber[frame.camera_id()] = frame.frame_number();
+    }
+    m_charge = snapshot.charge();
+    m_data->flip = snapshot.flip();
+
+    m_data->rng.setState(snapshot.rng_s1(), snapshot.rng_s2(), snapshot.rng_s3());
+    std::istringstream shuffleState(snapshot.shuffle_rng());
+    shuffleState >> rand_shuffle_src;
+
+    m_data->ball->restoreSnapshot(snapshot.ball());
+    m_data->specsBlue.clear();
+    for (const robot::Specs &specs : snapshot.blue_specs()) {
+        m_data->specsBlue[specs.id()] = specs;
+    }
+    m_data->specsYellow.clear();
+    for (const robot::Specs &specs : snapshot.yellow_specs()) {
+        m_data->specsYellow[specs.id()] = specs;
+    }
+    restoreSnapshotRobots(m_data->robotsBlue, snapshot.blue_robots());
+    restoreSnapshotRobots(m_data->robotsYellow, snapshot.yellow_robots());
+
+    m_radioCommands.clear();
+    for (const SimulatorSnapshot::RadioCommand &command : snapshot.radio_commands()) {
+        SSLSimRobotControl control(new sslsim::RobotControl(command.control()));
+        m_radioCommands.enqueue(std::make_tuple(control, command.processing_start(), command.is_blue()));
+    }
+
+    resetVisionPackets();
+    for (const SimulatorSnapshot::VisionPacket &packet : snapshot.vision_packets()) {
+        QList<QByteArray> vision;
+        for (const std::string &data : packet.vision()) {
+            vision.append(QByteArray::fromStdString(data));
+        }
+        m_visionPackets.emplace(packet.deadline(), std::make_tuple(vision, QByteArray::fromStdString(packet.truth()), packet.time()));
+    }
+    if (!m_isPartial && m_enabled) {
+        scheduleVisionPackets();
+    }
 }
 
 static bool overlapCheck(const btVector3& p0, const float& r0, const btVector3& p1, const float& r1)
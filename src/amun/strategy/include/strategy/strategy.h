@@ -44,6 +44,7 @@ namespace v8 {
     class Platform;
 }
 class InspectorHandler;
+class LatencyTrace;
 class CompilerRegistry;
 class ProtobufFileSaver;
 
@@ -60,6 +61,7 @@ public:
     Strategy& operator=(const Strategy&) = delete;
     void resetIsReplay() { m_scriptState.isReplay = false; }
     void setEnabled(bool enable) { m_isEnabled = enable; }
+    void setLatencyTrace(LatencyTrace *trace) { m_latencyTrace = trace; }
     void tryProcess();
 
     void compileIfNecessary(const QString &initFile);
@@ -80,6 +82,7 @@ public slots:
 
 private slots:
     void process();
+    void performIdleTasks();
     void reload();
     void sendCommand(const Command &command);
     void loadStateChanged(amun::StatusStrategy::STATE state);
@@ -90,13 +93,13 @@ private:
     void loadScript(const QString &filename, const QString &entryPoint, bool loadUnderlying = true);
     void close();
     void triggerDebugger();
-    void fail(const QString &error, const amun::UserInput & userInput = amun::UserInput(), double pathPlanning = 0, double totalTime = 0);
+    void fail(const QString &error, double pathPlanning = 0, double totalTime = 0);
     void setStrategyStatus(Status &status, amun::StatusStrategy::STATE state);
     Status takeStrategyDebugStatus();
     amun::DebugSource debugSource() const;
     void createDummyTeam();
     bool updateTeam(const robot::Team &team, StrategyType teamType, bool isReplayTeam);
-    world::State assembleWorldState();
+    void setExecutionState(Status &status);
 
 private:
     StrategyPrivate * const m_p;
@@ -114,6 +117,11 @@ private:
     QString m_entryPoint;
 
     QTimer *m_idleTimer;
+    QTimer *m_gcTimer;
+    qint64 m_lastProcessStart = 0;
+    // estimated time between two strategy runs in nanoseconds
+    qint64 m_framePeriod = 0;
+    LatencyTrace *m_latencyTrace = nullptr;
     QTimer *m_reloadTimer;
     bool m_autoReload;
     bool m_strategyFailed;
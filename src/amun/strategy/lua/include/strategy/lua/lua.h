@@ -25,12 +25,14 @@
 #include <QString>
 #include <QStringList>
 #include <Eigen/Dense>
+#include <vector>
 #include "strategy/script/abstractstrategyscript.h"
 #include "strategy/script/strategytype.h"
 
 class DebugHelper;
 class FileWatcher;
 class Lua;
+class LuaProfileSampler;
 class ScriptState;
 
 Lua *getStrategyThread(lua_State *state);
@@ -43,6 +45,7 @@ public:
     static bool canHandle(const QString &filename);
     ~Lua() override;
     bool canHandleDynamic(const QString &filename) const override { return Lua::canHandle(filename); }
+    void performIdleTasks(double budget) override;
 
 public:
     bool triggerDebugger() override;
@@ -51,6 +54,11 @@ public:
     void watch(const QString &filename);
     QString debuggerRead();
     bool debuggerWrite(const QString& line);
+    // called from the sampling hook
+    bool takeProfileSampleRequest();
+    void recordProfileSample(lua_State *state);
+    // must be called before replacing the lua hook
+    void stopProfileSampler();
 protected:
     void loadScript(const QString &filename, const QString &entryPoint) override;
     bool process(double &pathPlanning) override;
@@ -62,6 +70,8 @@ private:
     void setupPackageLoader();
     void replaceLuaFunction(const char *module, const char *key, lua_CFunction replacement);
     void removeLuaFunction(const char *module, const char *key);
+    void updateProfileSampler();
+    void addProfileSamples();
 
 private slots:
     void requestRecording();
@@ -72,6 +82,9 @@ private:
 
     qint64 m_startTime;
 
+    LuaProfileSampler *m_profileSampler;
+    // leaf node of each stack sample taken during the current run
+    std::vector<quint32> m_profileSamples;
 };
 
 #endif // LUA_H
@@ -27,6 +27,9 @@
 #include "strategy/script/debughelper.h"
 #include "strategy/script/filewatcher.h"
 #include "strategy/script/scriptstate.h"
+#include <QThread>
+#include <atomic>
+#include <cstring>
 
 Lua *getStrategyThread(lua_State *state)
 {
@@ -277,6 +280,50 @@ static void luaDebugHook(lua_State *state, lua_Debug *ar)
     }
 }
 
+// LuaJIT 2.0 has no builtin sampling profiler (jit.profile requires 2.1). Instead the
+// sampler thread requests a sample every millisecond, which is taken by a count hook on
+// the strategy thread. The hooks are only ever changed by the strategy thread.
+// As compiled traces don't run hooks, the samples are biased towards interpreted code.
+class LuaProfileSampler : public QThread
+{
+public:
+    LuaProfileSampler() : m_stop(false), m_active(false), m_requested(false) {}
+    void stop() { m_stop = true; wait(); }
+    void setActive(bool active) { m_requested = false; m_active = active; }
+    bool takeRequest() { return m_requested.exchange(false); }
+
+protected:
+    void run() override;
+
+private:
+    std::atomic<bool> m_stop;
+    std::atomic<bool> m_active;
+    std::atomic<bool> m_requested;
+};
+
+// instructions between two calls of the profiling hook
+static const int PROFILE_HOOK_COUNT = 10000;
+
+static void luaProfileHook(lua_State *state, lua_Debug *ar)
+{
+    Lua *strategy = getStrategyThread(state);
+    if (strategy->takeProfileSampleRequest()) {
+        strategy->recordProfileSample(state);
+        // samples are requested every millisecond while the strategy runs, often enough for the timeout
+        luaDebugHook(state, ar);
+    }
+}
+
+void LuaProfileSampler::run()
+{
+    while (!m_stop) {
+        QThread::usleep(1000);
+        if (m_active) {
+            m_requested = true;
+        }
+    }
+}
+
 static void luaKillHook(lua_State *state, lua_Debug */*ar*/)
 {
     lua_getfield(state, LUA_REGISTRYINDEX, "ExitCode");
@@ -289,12 +336,14 @@ static int luaInstallKillHook(lua_State* state)
     int exitCode = luaL_optinteger(state, 1, 0);
     lua_pushinteger(state, exitCode);
     lua_setfield(state, LUA_REGISTRYINDEX, "ExitCode");
+    getStrategyThread(state)->stopProfileSampler();
     lua_sethook(state, luaKillHook, LUA_MASKCALL | LUA_MASKRET | LUA_MASKLINE | LUA_MASKCOUNT, 1);
     return 0;
 }
 
 Lua::Lua(const Timer *timer, StrategyType type, ScriptState& scriptState, bool debugEnabled) :
-    AbstractStrategyScript (timer, type, scriptState)
+    AbstractStrategyScript (timer, type, scriptState),
+    m_profileSampler(nullptr)
 {
     // create lua instance and load libraries
     m_state = luaL_newstate();
@@ -336,6 +385,7 @@ bool Lua::canHandle(const QString &filename)
 
 Lua::~Lua()
 {
+    stopProfileSampler();
     lua_close(m_state);
 }
 
@@ -385,6 +435,81 @@ void Lua::loadScript(const QString &filename, const QString &entryPoint)
     emit changeLoadState(amun::StatusStrategy::RUNNING);
 }
 
+void Lua::stopProfileSampler()
+{
+    if (m_profileSampler) {
+        m_profileSampler->stop();
+        delete m_profileSampler;
+        m_profileSampler = nullptr;
+        // the sampling hook must not outlive the sampler
+        if (lua_gethook(m_state) == luaProfileHook) {
+            lua_sethook(m_state, luaDebugHook, LUA_MASKCOUNT, 1000000);
+        }
+    }
+}
+
+void Lua::updateProfileSampler()
+{
+    // the debugger installs its own hooks
+    const bool enabled = m_scriptState.isContinuousProfiling && !m_scriptState.isDebugEnabled
+            && lua_gethook(m_state) != luaKillHook;
+    if (enabled && !m_profileSampler) {
+        m_profileSampler = new LuaProfileSampler;
+        m_profileSampler->start();
+        // the sampling hook also checks for the timeout, thus it only replaces the timeout hook
+        if (lua_gethook(m_state) == luaDebugHook) {
+            lua_sethook(m_state, luaProfileHook, LUA_MASKCOUNT, PROFILE_HOOK_COUNT);
+        }
+    } else if (!enabled && m_profileSampler) {
+        stopProfileSampler();
+        m_profileAggregator.clear();
+    }
+}
+
+bool Lua::takeProfileSampleRequest()
+{
+    return m_profileSampler && m_profileSampler->takeRequest();
+}
+
+void Lua::recordProfileSample(lua_State *state)
+{
+    const int MAX_DEPTH = 64;
+    quint32 functions[MAX_DEPTH];
+    int depth = 0;
+    lua_Debug ar;
+    while (depth < MAX_DEPTH && lua_getstack(state, depth, &ar)) {
+        lua_getinfo(state, "Sn", &ar);
+        const char *name = ar.name ? ar.name : (ar.what && strcmp(ar.what, "main") == 0 ? "(main)" : "(anonymous)");
+        functions[depth] = m_profileAggregator.functionId(name, ar.short_src, ar.linedefined);
+        depth++;
+    }
+    if (depth == 0) {
+        return;
+    }
+    quint32 node = ProfileAggregator::NO_PARENT;
+    for (int i = depth - 1; i >= 0; i--) {
+        node = m_profileAggregator.nodeId(node, functions[i]);
+    }
+    m_profileSamples.push_back(node);
+}
+
+void Lua::addProfileSamples()
+{
+    if (m_profileSampler) {
+        m_profileSampler->setActive(false);
+    }
+    if (m_profileSamples.empty()) {
+        return;
+    }
+    // the samples are taken in equal intervals, thus they share the run time equally
+    const float duration = (Timer::systemTime() - m_startTime) * 1E-9f / m_profileSamples.size();
+    const qint64 currentTime = time();
+    for (quint32 node : m_profileSamples) {
+        m_profileAggregator.addSample(currentTime, node, duration);
+    }
+    m_profileSamples.clear();
+}
+
 bool Lua::process(double &pathPlanning)
 {
     // used to check for script timeout
@@ -394,9 +519,17 @@ bool Lua::process(double &pathPlanning)
     lua_pushnumber(m_state, 0);
     lua_setfield(m_state, LUA_REGISTRYINDEX, "PathPlanning");
 
+    updateProfileSampler();
+    m_profileSamples.clear();
+    if (m_profileSampler) {
+        m_profileSampler->setActive(true);
+    }
+
     // execute entry point
     lua_getfield(m_state, LUA_REGISTRYINDEX, "EntryPoint");
-    if (lua_pcall(m_state, 0, 0, 1)) {
+    const bool failed = lua_pcall(m_state, 0, 0, 1) != 0;
+    addProfileSamples();
+    if (failed) {
         m_errorMsg = lua_tostring(m_state, -1);
         return false;
     }
@@ -409,6 +542,17 @@ bool Lua::process(double &pathPlanning)
     return true;
 }
 
+void Lua::performIdleTasks(double budget)
+{
+    const qint64 deadline = Timer::systemTime() + qint64(budget * 1E9);
+    // run incremental collection steps, stop once a cycle is completed
+    while (Timer::systemTime() < deadline) {
+        if (lua_gc(m_state, LUA_GCSTEP, 0)) {
+            break;
+        }
+    }
+}
+
 bool Lua::triggerDebugger()
 {
     if (!m_hasDebugger || !m_scriptState.isDebugEnabled) {
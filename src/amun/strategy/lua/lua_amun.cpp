@@ -211,30 +211,67 @@ static int amunAddVisualizationCircle(lua_State *state)
     return 0;
 }
 
-static int amunAddDebug(lua_State *state)
+template<typename DebugValueType>
+static void setDebugValue(lua_State *state, int index, DebugValueType *value)
 {
-    Lua *thread = getStrategyThread(state);
-    amun::DebugValue *value = thread->addDebug();
-    value->set_key(luaL_checkstring(state, 1));
-
-    switch (lua_type(state, 2)) {
+    switch (lua_type(state, index)) {
     case LUA_TNUMBER:
-        value->set_float_value(lua_tonumber(state, 2));
+        value->set_float_value(lua_tonumber(state, index));
         break;
 
     case LUA_TBOOLEAN:
-        value->set_bool_value(lua_toboolean(state, 2));
+        value->set_bool_value(lua_toboolean(state, index));
         break;
 
     case LUA_TSTRING:
-        value->set_string_value(lua_tostring(state, 2));
+        value->set_string_value(lua_tostring(state, index));
         break;
 
     case LUA_TNIL:
         value->set_string_value("<nil>");
         break;
     }
+}
 
+static int amunAddDebug(lua_State *state)
+{
+    Lua *thread = getStrategyThread(state);
+    amun::DebugValue *value = thread->addDebug();
+    value->set_key(luaL_checkstring(state, 1));
+    setDebugValue(state, 2, value);
+    return 0;
+}
+
+static int amunRegisterDebugKey(lua_State *state)
+{
+    Lua *thread = getStrategyThread(state);
+    size_t length;
+    const char *key = luaL_checklstring(state, 1, &length);
+    lua_pushinteger(state, thread->registerDebugKey(std::string(key, length)));
+    return 1;
+}
+
+static int amunAddDebugBatch(lua_State *state)
+{
+    Lua *thread = getStrategyThread(state);
+    luaL_checktype(state, 1, LUA_TTABLE);
+    luaL_checktype(state, 2, LUA_TTABLE);
+    // the tables may be reused between frames, thus only the first count entries are valid
+    const int count = luaL_optint(state, 3, lua_objlen(state, 1));
+
+    for (int i = 1; i <= count; i++) {
+        lua_rawgeti(state, 1, i);
+        const lua_Integer handle = lua_tointeger(state, -1);
+        lua_pop(state, 1);
+        if (handle < 0 || !thread->isValidDebugHandle(handle)) {
+            luaL_error(state, "Invalid debug key handle");
+            return 0;
+        }
+
+        lua_rawgeti(state, 2, i);
+        setDebugValue(state, -1, thread->addDebugHandleValue(handle));
+        lua_pop(state, 1);
+    }
     return 0;
 }
 
@@ -437,6 +474,8 @@ static const luaL_Reg amunMethods[] = {
     {"addVisualization",    amunAddVisualization},
     {"addVisualizationCircle", amunAddVisualizationCircle},
     {"addDebug",            amunAddDebug},
+    {"registerDebugKey",    amunRegisterDebugKey},
+    {"addDebugBatch",       amunAddDebugBatch},
     {"addPlot",             amunAddPlot},
     {"sendGameControllerMessage",   amunSendGameControllerMessage},
     {"getGameControllerMessage",    amunGetGameControllerMessage},
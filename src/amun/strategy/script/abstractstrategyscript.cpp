@@ -55,9 +55,47 @@ amun::DebugValues* AbstractStrategyScript::setDebugValues(amun::DebugValues* dV)
 {
     amun::DebugValues* out = m_debugValues;
     m_debugValues = dV;
+    if (out) {
+        writeDebugKeyTable(out);
+        writeProfile(out);
+    }
     return out;
 }
 
+void AbstractStrategyScript::writeProfile(amun::DebugValues *debugValues)
+{
+    if (!m_scriptState.isContinuousProfiling) {
+        return;
+    }
+    const qint64 currentTime = time();
+    if (m_profileAggregator.shouldPublish(currentTime)) {
+        m_profileAggregator.fillProfile(currentTime, debugValues->mutable_profile());
+    }
+}
+
+void AbstractStrategyScript::writeDebugKeyTable(amun::DebugValues *debugValues)
+{
+    if (m_debugKeys.empty()) {
+        return;
+    }
+    // the table is also repeated once per second, otherwise seeking in a log
+    // could end up without any way to resolve the handles
+    const qint64 currentTime = time();
+    if (!m_debugKeysChanged && currentTime - m_lastDebugKeyTableTime < 1000 * 1000 * 1000LL
+            && currentTime >= m_lastDebugKeyTableTime) {
+        return;
+    }
+    m_debugKeysChanged = false;
+    m_lastDebugKeyTableTime = currentTime;
+
+    debugValues->mutable_debug_key()->Reserve(m_debugKeys.size());
+    for (std::size_t i = 0; i < m_debugKeys.size(); i++) {
+        amun::DebugKey *key = debugValues->add_debug_key();
+        key->set_handle(i);
+        key->set_key(m_debugKeys[i]);
+    }
+}
+
 bool AbstractStrategyScript::chooseEntryPoint(QString entryPoint)
 {
     // cleanup entrypoints list
@@ -103,6 +141,26 @@ amun::DebugValue *AbstractStrategyScript::addDebug()
     return m_debugValues->add_value();
 }
 
+quint32 AbstractStrategyScript::registerDebugKey(const std::string &key)
+{
+    auto it = m_debugKeyHandles.find(key);
+    if (it != m_debugKeyHandles.end()) {
+        return it->second;
+    }
+    const quint32 handle = m_debugKeys.size();
+    m_debugKeys.push_back(key);
+    m_debugKeyHandles.emplace(key, handle);
+    m_debugKeysChanged = true;
+    return handle;
+}
+
+amun::DebugHandleValue *AbstractStrategyScript::addDebugHandleValue(quint32 handle)
+{
+    amun::DebugHandleValue *value = m_debugValues->add_handle_value();
+    value->set_handle(handle);
+    return value;
+}
+
 amun::PlotValue *AbstractStrategyScript::addPlot()
 {
     return m_debugValues->add_plot();
@@ -121,7 +179,7 @@ void AbstractStrategyScript::setCommands(const QList<RobotCommandInfo> &commands
     }
     // movement commands are immediatelly forwarded to the processor
     // that is while the strategy is still running
-    emit sendStrategyCommands(m_type == StrategyType::BLUE, commands, m_worldState.time());
+    emit sendStrategyCommands(m_type == StrategyType::BLUE, commands, worldState().time());
 }
 
 bool AbstractStrategyScript::sendCommand(const Command &command)
@@ -160,14 +218,15 @@ void AbstractStrategyScript::loadScript(const QString &filename, const QString &
     }
 }
 
-bool AbstractStrategyScript::process(double &pathPlanning, const world::State &worldState, const amun::GameState &refereeState, const amun::UserInput &userInput)
+bool AbstractStrategyScript::process(double &pathPlanning, const Status &executionStatus)
 {
     Q_ASSERT(!m_entryPoint.isNull());
+    Q_ASSERT(executionStatus->execution_state().vision_frames_size() == 0);
 
-    m_worldState.CopyFrom(worldState);
-    m_worldState.clear_vision_frames();
-    m_refereeState.CopyFrom(refereeState);
-    m_userInput.CopyFrom(userInput);
+    m_executionStatus = executionStatus;
+    m_worldState = &executionStatus->execution_state();
+    m_refereeState = &executionStatus->execution_game_state();
+    m_userInput = &executionStatus->execution_user_input();
 
     return process(pathPlanning);
 }
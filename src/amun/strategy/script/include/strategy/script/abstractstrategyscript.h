@@ -30,6 +30,7 @@
 #include "protobuf/status.h"
 #include "protobuf/userinput.pb.h"
 #include "protobuf/world.pb.h"
+#include "profileaggregator.h"
 #include "strategytype.h"
 #include <QObject>
 #include <QString>
@@ -37,6 +38,9 @@
 #include <QDir>
 #include <QList>
 #include <QThread>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 class DebugHelper;
 class Timer;
@@ -59,7 +63,9 @@ public:
     // errors are reported via changeLoadState. If an error occured, the error msg can be retrieved via errorMsg()
     void loadScript(const QString &filename, const QString &entryPoint, const world::Geometry &geometry, const robot::Team &team, bool loadUnderlying);
     // must only be called after loadScript was executed successfully
-    bool process(double &pathPlanning, const world::State &worldState, const amun::GameState &refereeState, const amun::UserInput &userInput);
+    // executionStatus has to contain the execution state, game state and user input for this strategy,
+    // these are referenced until the next call and thus must not be modified
+    bool process(double &pathPlanning, const Status &executionStatus);
     virtual bool triggerDebugger();
     virtual void startProfiling() {}
     virtual void endProfiling(const std::string &filename) {}
@@ -67,6 +73,11 @@ public:
     virtual bool canHandleDynamic(const QString &filename) const = 0;
     // may not be called before calling loadScript at least once
     virtual void compileIfNecessary() {}
+    // called while waiting for the next world state, may be used for garbage collection
+    // budget is the available time in seconds
+    virtual void performIdleTasks(double budget) { Q_UNUSED(budget); }
+    // time spent pausing for the garbage collector during the last run of process, in seconds
+    virtual double garbageCollectionTime() const { return 0; }
 
     const ScriptState& state() const { return m_scriptState; };
     ScriptState& state() { return m_scriptState; };
@@ -99,6 +110,10 @@ public:
     amun::Visualization *addVisualization();
     void removeVisualizations();
     amun::DebugValue *addDebug();
+    // registers the debug key once and returns a handle, which can be used with addDebugHandleValue
+    quint32 registerDebugKey(const std::string &key);
+    bool isValidDebugHandle(quint32 handle) const { return handle < m_debugKeys.size(); }
+    amun::DebugHandleValue *addDebugHandleValue(quint32 handle);
     amun::PlotValue *addPlot();
     amun::RobotValue *addRobotValue();
     void setCommands(const QList<RobotCommandInfo> &commands);
@@ -107,9 +122,9 @@ public:
     void sendMixedTeam(const QByteArray &info);
     const world::Geometry& geometry() const { return m_geometry; }
     const robot::Team& team() const { return m_team; }
-    const world::State& worldState() const { return m_worldState; }
-    const amun::GameState& refereeState() const { return m_refereeState; }
-    const amun::UserInput& userInput() const { return m_userInput; }
+    const world::State& worldState() const { return m_worldState ? *m_worldState : world::State::default_instance(); }
+    const amun::GameState& refereeState() const { return m_refereeState ? *m_refereeState : amun::GameState::default_instance(); }
+    const amun::UserInput& userInput() const { return m_userInput ? *m_userInput : amun::UserInput::default_instance(); }
     bool isBlue() const { return m_type == StrategyType::BLUE; }
     StrategyType getStrategyType() const { return m_type; }
     QDir baseDir() const { return m_baseDir; }
@@ -147,15 +162,29 @@ protected:
 
     world::Geometry m_geometry;
     robot::Team m_team;
-    world::State m_worldState;
-    amun::GameState m_refereeState;
-    amun::UserInput m_userInput;
+    // keeps the referenced messages alive
+    Status m_executionStatus;
+    const world::State *m_worldState = nullptr;
+    const amun::GameState *m_refereeState = nullptr;
+    const amun::UserInput *m_userInput = nullptr;
 
     std::shared_ptr<StrategyGameControllerMediator> m_gameControllerConnection;
 
     CompilerRegistry* m_compilerRegistry;
+    // filled by the implementations while continuous profiling is enabled
+    ProfileAggregator m_profileAggregator;
+private:
+    void writeDebugKeyTable(amun::DebugValues *debugValues);
+    void writeProfile(amun::DebugValues *debugValues);
+
 private:
     amun::DebugValues* m_debugValues = nullptr;
+
+    // index is the handle of the key
+    std::vector<std::string> m_debugKeys;
+    std::unordered_map<std::string, quint32> m_debugKeyHandles;
+    bool m_debugKeysChanged = false;
+    qint64 m_lastDebugKeyTableTime = 0;
 };
 
 #endif // ABSTRACTSTRATEGYSCRIPT_H
@@ -44,7 +44,8 @@ public slots:
     virtual void compile() = 0;
 signals:
     void started();
-    void success();
+    // message may contain additional information, such as compile timings
+    void success(const QString &message);
     void error(const QString &message);
     void warning(const QString &message);
 };
@@ -0,0 +1,73 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef PROFILEAGGREGATOR_H
+#define PROFILEAGGREGATOR_H
+
+#include "protobuf/debug.pb.h"
+#include <QtGlobal>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Aggregates call stack samples of a strategy over a rolling time window
+class ProfileAggregator
+{
+public:
+    static const quint32 NO_PARENT = ~0u;
+
+    quint32 functionId(const std::string &name, const std::string &file, int line);
+    // parent is the node of the calling function or NO_PARENT for the outermost frame
+    quint32 nodeId(quint32 parent, quint32 function);
+    // node is the innermost frame of the sample, duration is given in seconds
+    void addSample(qint64 time, quint32 node, float duration);
+    // returns true once per publish interval
+    bool shouldPublish(qint64 time);
+    void fillProfile(qint64 time, amun::StrategyProfile *profile);
+    void clear();
+
+private:
+    struct Function {
+        std::string name;
+        std::string file;
+        int line;
+    };
+
+    struct Node {
+        quint32 parent;
+        quint32 function;
+    };
+
+    struct Sample {
+        qint64 time;
+        quint32 node;
+        float duration;
+    };
+
+    std::vector<Function> m_functions;
+    std::unordered_map<std::string, quint32> m_functionIds;
+    // node ids are assigned in creation order, thus a parent always has a smaller id than its children
+    std::vector<Node> m_nodes;
+    std::unordered_map<quint64, quint32> m_nodeIds;
+    std::deque<Sample> m_samples;
+    qint64 m_lastPublish = 0;
+};
+
+#endif // PROFILEAGGREGATOR_H
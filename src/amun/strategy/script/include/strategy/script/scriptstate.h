@@ -39,6 +39,7 @@ public:
     bool isTournamentMode = false;
     bool isDebugEnabled = false;
     bool isRunningInLogplayer = false;
+    bool isContinuousProfiling = false;
     Status currentStatus; // used for replay tests
     ProtobufFileSaver *pathInputSaver = nullptr;
 };
@@ -0,0 +1,157 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "profileaggregator.h"
+#include <algorithm>
+
+const quint32 ProfileAggregator::NO_PARENT;
+
+// the profile covers the last ten seconds and is published once per second
+static const qint64 PROFILE_WINDOW = 10 * 1000 * 1000 * 1000LL;
+static const qint64 PUBLISH_INTERVAL = 1000 * 1000 * 1000LL;
+// functions and call tree nodes below this share of the total time are omitted
+static const float MIN_TIME_SHARE = 0.002f;
+static const std::size_t MAX_FUNCTIONS = 100;
+
+quint32 ProfileAggregator::functionId(const std::string &name, const std::string &file, int line)
+{
+    std::string key = file + ":" + std::to_string(line) + ":" + name;
+    auto it = m_functionIds.find(key);
+    if (it != m_functionIds.end()) {
+        return it->second;
+    }
+    const quint32 id = m_functions.size();
+    m_functions.push_back({name, file, line});
+    m_functionIds.emplace(std::move(key), id);
+    return id;
+}
+
+quint32 ProfileAggregator::nodeId(quint32 parent, quint32 function)
+{
+    const quint64 key = (quint64(parent) << 32) | function;
+    auto it = m_nodeIds.find(key);
+    if (it != m_nodeIds.end()) {
+        return it->second;
+    }
+    const quint32 id = m_nodes.size();
+    m_nodes.push_back({parent, function});
+    m_nodeIds.emplace(key, id);
+    return id;
+}
+
+void ProfileAggregator::addSample(qint64 time, quint32 node, float duration)
+{
+    Q_ASSERT(node < m_nodes.size());
+    m_samples.push_back({time, node, duration});
+}
+
+bool ProfileAggregator::shouldPublish(qint64 time)
+{
+    if (time - m_lastPublish < PUBLISH_INTERVAL && time >= m_lastPublish) {
+        return false;
+    }
+    m_lastPublish = time;
+    return true;
+}
+
+void ProfileAggregator::fillProfile(qint64 time, amun::StrategyProfile *profile)
+{
+    while (!m_samples.empty() && m_samples.front().time < time - PROFILE_WINDOW) {
+        m_samples.pop_front();
+    }
+
+    std::vector<float> nodeTime(m_nodes.size(), 0);
+    std::vector<float> selfTime(m_functions.size(), 0);
+    std::vector<float> functionTime(m_functions.size(), 0);
+    // avoids counting recursive calls more than once per sample
+    std::vector<std::size_t> lastSample(m_functions.size(), ~std::size_t(0));
+    float totalTime = 0;
+    for (std::size_t i = 0; i < m_samples.size(); i++) {
+        const Sample &sample = m_samples[i];
+        totalTime += sample.duration;
+        selfTime[m_nodes[sample.node].function] += sample.duration;
+        for (quint32 node = sample.node; node != NO_PARENT; node = m_nodes[node].parent) {
+            nodeTime[node] += sample.duration;
+            const quint32 function = m_nodes[node].function;
+            if (lastSample[function] != i) {
+                lastSample[function] = i;
+                functionTime[function] += sample.duration;
+            }
+        }
+    }
+
+    profile->set_window(PROFILE_WINDOW * 1E-9f);
+    profile->set_total_time(totalTime);
+
+    const float minTime = totalTime * MIN_TIME_SHARE;
+    std::vector<quint32> functions;
+    for (quint32 i = 0; i < m_functions.size(); i++) {
+        if (functionTime[i] > 0 && functionTime[i] >= minTime) {
+            functions.push_back(i);
+        }
+    }
+    std::stable_sort(functions.begin(), functions.end(), [&selfTime](quint32 a, quint32 b) {
+        return selfTime[a] > selfTime[b];
+    });
+    if (functions.size() > MAX_FUNCTIONS) {
+        functions.resize(MAX_FUNCTIONS);
+    }
+
+    const quint32 MISSING = ~0u;
+    std::vector<quint32> functionIndex(m_functions.size(), MISSING);
+    for (quint32 function : functions) {
+        functionIndex[function] = profile->function_size();
+        const Function &f = m_functions[function];
+        amun::ProfileFunction *pf = profile->add_function();
+        pf->set_name(f.name);
+        if (!f.file.empty()) {
+            pf->set_file(f.file);
+            pf->set_line(f.line);
+        }
+        pf->set_self_time(selfTime[function]);
+        pf->set_total_time(functionTime[function]);
+    }
+
+    // a node is only kept if its parent is kept, which always precedes it
+    std::vector<quint32> nodeIndex(m_nodes.size(), MISSING);
+    for (quint32 i = 0; i < m_nodes.size(); i++) {
+        const Node &node = m_nodes[i];
+        if (nodeTime[i] == 0 || nodeTime[i] < minTime || functionIndex[node.function] == MISSING
+                || (node.parent != NO_PARENT && nodeIndex[node.parent] == MISSING)) {
+            continue;
+        }
+        nodeIndex[i] = profile->node_size();
+        amun::ProfileNode *pn = profile->add_node();
+        pn->set_function(functionIndex[node.function]);
+        if (node.parent != NO_PARENT) {
+            pn->set_parent(nodeIndex[node.parent]);
+        }
+        pn->set_total_time(nodeTime[i]);
+    }
+}
+
+void ProfileAggregator::clear()
+{
+    m_functions.clear();
+    m_functionIds.clear();
+    m_nodes.clear();
+    m_nodeIds.clear();
+    m_samples.clear();
+    m_lastPublish = 0;
+}
@@ -23,11 +23,13 @@
 #include "strategy.h"
 #include "strategy/script/debughelper.h"
 #include "strategy/script/compilerregistry.h"
+#include "core/latencytrace.h"
 #include "core/timer.h"
 #include "config/config.h"
 #include "protobuf/geometry.h"
 #include "protobuf/ssl_game_controller_team.pb.h"
 #include "protobuf/robot.h"
+#include "protobuf/world.h"
 #include "google/protobuf/util/delimited_message_util.h"
 #include <QCoreApplication>
 #include <QDateTime>
@@ -117,6 +119,12 @@ Strategy::Strategy(const Timer *timer, StrategyType type, DebugHelper *helper, C
     m_idleTimer->setInterval(0);
     connect(m_idleTimer, SIGNAL(timeout()), SLOT(process()));
 
+    // used to run garbage collection etc. once all pending messages are handled
+    m_gcTimer = new QTimer(this);
+    m_gcTimer->setSingleShot(true);
+    m_gcTimer->setInterval(0);
+    connect(m_gcTimer, SIGNAL(timeout()), SLOT(performIdleTasks()));
+
     // delay automatic reload for 100 ms
     m_reloadTimer = new QTimer(this);
     m_reloadTimer->setSingleShot(true);
@@ -283,6 +291,11 @@ void Strategy::handleCommand(const Command &command)
             }
         }
 
+        if (cmd->has_continuous_profiling()) {
+            // takes effect with the next strategy run, no reload required
+            m_scriptState.isContinuousProfiling = cmd->continuous_profiling();
+        }
+
         if (cmd->has_tournament_mode() && m_scriptState.isTournamentMode != cmd->tournament_mode()) {
             m_scriptState.isTournamentMode = cmd->tournament_mode();
             reloadStrategy = true;
@@ -357,51 +370,95 @@ void Strategy::sendMixedTeamInfo(const QByteArray &data)
     m_p->mixedTeamData = data;
 }
 
-world::State Strategy::assembleWorldState()
+void Strategy::setExecutionState(Status &status)
 {
+    const Status &current = m_scriptState.currentStatus;
+    // the received status is never modified, thus its messages can be referenced instead of copied
+    // this requires an arena allocated status, which then keeps the received status alive
+    const bool canReference = status.keepAlive(current);
+
     // assemble world state for this strategy
     // depending on the strategy type, the tracking with or without trajectory information is used for robots
-    world::State worldState;
-    if (m_scriptState.currentStatus->execution_state().IsInitialized()) {
-        worldState = m_scriptState.currentStatus->execution_state();
+    const world::State &sourceState = current->execution_state().IsInitialized()
+            ? current->execution_state() : current->world_state();
+    const bool replaceYellow = !current->execution_state().IsInitialized() && m_type != StrategyType::YELLOW
+            && sourceState.simple_tracking_yellow_size() > 0;
+    const bool replaceBlue = !current->execution_state().IsInitialized() && m_type != StrategyType::BLUE
+            && sourceState.simple_tracking_blue_size() > 0;
+    const bool replaceBall = !current->execution_state().IsInitialized() && m_type == StrategyType::AUTOREF
+            && sourceState.has_simple_tracking_ball();
+    if (canReference && !replaceYellow && !replaceBlue && !replaceBall && sourceState.vision_frames_size() == 0) {
+        status->unsafe_arena_set_allocated_execution_state(const_cast<world::State*>(&sourceState));
+    } else if (canReference) {
+        // the teams differ per strategy, only the list of robots is created for every strategy
+        referenceWorldState(status->mutable_execution_state(), sourceState, replaceYellow, replaceBlue, replaceBall);
     } else {
-        worldState = m_scriptState.currentStatus->world_state();
-        if (m_type != StrategyType::YELLOW && worldState.simple_tracking_yellow_size() > 0) {
-            worldState.clear_yellow();
-            worldState.mutable_yellow()->CopyFrom(worldState.simple_tracking_yellow());
+        world::State *worldState = status->mutable_execution_state();
+        worldState->CopyFrom(sourceState);
+        worldState->clear_vision_frames();
+        if (replaceYellow) {
+            worldState->mutable_yellow()->CopyFrom(sourceState.simple_tracking_yellow());
+        }
+        if (replaceBlue) {
+            worldState->mutable_blue()->CopyFrom(sourceState.simple_tracking_blue());
         }
-        if (m_type != StrategyType::BLUE && worldState.simple_tracking_blue_size() > 0) {
-            worldState.clear_blue();
-            worldState.mutable_blue()->CopyFrom(worldState.simple_tracking_blue());
+        if (replaceBall) {
+            worldState->mutable_ball()->CopyFrom(sourceState.simple_tracking_ball());
+        }
+    }
+
+    const amun::GameState &gameState = current->execution_game_state().IsInitialized()
+            ? current->execution_game_state() : current->game_state();
+    if (canReference) {
+        status->unsafe_arena_set_allocated_execution_game_state(const_cast<amun::GameState*>(&gameState));
+    } else {
+        status->mutable_execution_game_state()->CopyFrom(gameState);
+    }
+
+    if (current->has_execution_user_input()) {
+        if (canReference) {
+            status->unsafe_arena_set_allocated_execution_user_input(const_cast<amun::UserInput*>(&current->execution_user_input()));
+        } else {
+            status->mutable_execution_user_input()->CopyFrom(current->execution_user_input());
         }
-        if (m_type == StrategyType::AUTOREF && worldState.has_simple_tracking_ball()) {
-            worldState.mutable_ball()->CopyFrom(worldState.simple_tracking_ball());
+    } else {
+        amun::UserInput *userInput = status->mutable_execution_user_input();
+        if (m_type == StrategyType::BLUE) {
+            userInput->CopyFrom(current->user_input_blue());
+        } else if (m_type == StrategyType::YELLOW) {
+            userInput->CopyFrom(current->user_input_yellow());
         }
+        // autoref has no user input
+        userInput->mutable_move_command()->CopyFrom(m_lastMoveCommand.move_command());
     }
-    return worldState;
 }
 
 void Strategy::tryProcess()
 {
     if (!m_scriptState.currentStatus.isNull() && m_scriptState.currentStatus->game_state().IsInitialized()
             && m_scriptState.currentStatus->world_state().IsInitialized()) {
+        // the status is handled now, no need to process it again once idle
+        m_idleTimer->stop();
         process();
     }
 }
 
-static void addTimingInfos(Status& s, double pathPlanning, double totalTime, StrategyType type) {
+static void addTimingInfos(Status& s, double pathPlanning, double totalTime, double gcTime, StrategyType type) {
     // publish timings and debug output
     amun::Timing *timing = s->mutable_timing();
     if (type == StrategyType::BLUE) {
         timing->set_blue_total(totalTime);
         timing->set_blue_path(pathPlanning);
+        timing->set_blue_gc(gcTime);
         s->set_blue_running(true);
     } else if (type == StrategyType::YELLOW) {
         timing->set_yellow_total(totalTime);
         timing->set_yellow_path(pathPlanning);
+        timing->set_yellow_gc(gcTime);
         s->set_yellow_running(true);
     } else if (type == StrategyType::AUTOREF) {
         timing->set_autoref_total(totalTime);
+        timing->set_autoref_gc(gcTime);
         s->set_autoref_running(true);
     }
 }
@@ -423,35 +480,38 @@ void Strategy::process()
     Q_ASSERT(m_scriptState.currentStatus->world_state().IsInitialized()
             || m_scriptState.currentStatus->execution_state().IsInitialized());
 
+    // only the live strategies take part in the latency trace
+    const bool tracing = m_latencyTrace && m_type != StrategyType::AUTOREF
+            && !m_scriptState.isRunningInLogplayer && !m_scriptState.isReplay
+            && m_scriptState.currentStatus->has_world_state();
+    const qint64 traceId = tracing ? m_scriptState.currentStatus->world_state().time() : 0;
+    if (tracing) {
+        m_latencyTrace->record(traceId, LatencyTrace::StrategyStart, LatencyTrace::now());
+    }
+
     double pathPlanning = 0;
     qint64 startTime = Timer::systemTime();
 
-    amun::UserInput userInput;
-    if (m_scriptState.currentStatus->has_execution_user_input()) {
-        userInput.CopyFrom(m_scriptState.currentStatus->execution_user_input());
-    } else {
-        if (m_type == StrategyType::BLUE) {
-            userInput.CopyFrom(m_scriptState.currentStatus->user_input_blue());
-        } else if (m_type == StrategyType::YELLOW) {
-            userInput.CopyFrom(m_scriptState.currentStatus->user_input_yellow());
-        }
-        // autoref has no user input
-        userInput.mutable_move_command()->CopyFrom(m_lastMoveCommand.move_command());
+    // gaps of more than 100 ms are not part of the regular strategy frames
+    const qint64 period = startTime - m_lastProcessStart;
+    if (m_lastProcessStart != 0 && period > 0 && period < 100 * 1000 * 1000) {
+        m_framePeriod = m_framePeriod == 0 ? period : (m_framePeriod * 7 + period) / 8;
     }
+    m_lastProcessStart = startTime;
 
-    // assemble world state for this strategy
-    // depending on the strategy type, the tracking with or without trajectory information is used for robots
-    world::State worldState = assembleWorldState();
-
-    const auto &usedGameState = m_scriptState.currentStatus->execution_game_state().IsInitialized()
-            ? m_scriptState.currentStatus->execution_game_state()
-            : m_scriptState.currentStatus->game_state();
+    // the execution state is written directly into the status which collects
+    // the debug output of this run, the strategy references it from there
+    setExecutionState(m_debugStatus);
 
+    const amun::GameState &usedGameState = m_debugStatus->execution_game_state();
     if (usedGameState.has_goals_flipped()) {
         m_scriptState.isFlipped = usedGameState.goals_flipped();
     }
 
-    if (m_strategy->process(pathPlanning, worldState, usedGameState, userInput)) {
+    if (m_strategy->process(pathPlanning, m_debugStatus)) {
+        if (tracing) {
+            m_latencyTrace->record(traceId, LatencyTrace::StrategyDone, LatencyTrace::now());
+        }
         if (!m_p->mixedTeamData.isNull()) {
             int bytesSent = m_udpSenderSocket->writeDatagram(m_p->mixedTeamData, m_p->mixedTeamHost, m_p->mixedTeamPort);
             int origSize = m_p->mixedTeamData.size();
@@ -467,17 +527,27 @@ void Strategy::process()
 
         // publish timings and debug output
         Status status = takeStrategyDebugStatus();
-        addTimingInfos(status, pathPlanning, totalTime, m_type);
-        status->mutable_execution_state()->CopyFrom(worldState);
-        status->mutable_execution_state()->clear_vision_frames();
-        status->mutable_execution_game_state()->CopyFrom(m_scriptState.currentStatus->execution_game_state().IsInitialized()
-                                                            ? m_scriptState.currentStatus->execution_game_state()
-                                                            : m_scriptState.currentStatus->game_state());
-        status->mutable_execution_user_input()->CopyFrom(userInput);
+        addTimingInfos(status, pathPlanning, totalTime, m_strategy->garbageCollectionTime(), m_type);
         emit sendStatus(status);
+
+        m_gcTimer->start();
     } else {
         double totalTime = (Timer::systemTime() - startTime) * 1E-9;
-        fail(m_strategy->errorMsg(), userInput, pathPlanning, totalTime);
+        fail(m_strategy->errorMsg(), pathPlanning, totalTime);
+    }
+}
+
+void Strategy::performIdleTasks()
+{
+    // don't delay the next strategy run
+    if (!m_strategy || m_strategyFailed || m_idleTimer->isActive() || m_framePeriod == 0) {
+        return;
+    }
+    // keep a safety margin as the next status may arrive early
+    const qint64 margin = 2 * 1000 * 1000;
+    const qint64 budget = m_lastProcessStart + m_framePeriod - margin - Timer::systemTime();
+    if (budget > 1000 * 1000) {
+        m_strategy->performIdleTasks(budget * 1E-9);
     }
 }
 
@@ -572,7 +642,7 @@ void Strategy::loadScript(const QString &filename, const QString &entryPoint, bo
             takeStrategyDebugStatus();
 #ifdef V8_FOUND
         } else if (Typescript::canHandle(filename)) {
-            Typescript *t = new Typescript(m_timer, m_type, m_scriptState, m_compilerRegistry);
+            Typescript *t = new Typescript(m_timer, m_type, m_scriptState, m_compilerRegistry, static_platform.get());
             m_strategy = t;
             // insert m_debugStatus into m_strategy
             // this has to happen before newDebuggagleStrategy is called
@@ -632,7 +702,7 @@ void Strategy::triggerDebugger()
     }
 }
 
-void Strategy::fail(const QString &error, const amun::UserInput & userInput, double pathPlanning, double totalTime)
+void Strategy::fail(const QString &error, double pathPlanning, double totalTime)
 {
     if (m_type == StrategyType::BLUE || m_type == StrategyType::YELLOW) {
         emit sendHalt(m_type == StrategyType::BLUE);
@@ -640,12 +710,11 @@ void Strategy::fail(const QString &error, const amun::UserInput & userInput, dou
 
     // update status
     Status status = takeStrategyDebugStatus();
-    addTimingInfos(status, pathPlanning, totalTime, m_type);
+    addTimingInfos(status, pathPlanning, totalTime, m_strategy ? m_strategy->garbageCollectionTime() : 0, m_type);
     setStrategyStatus(status, amun::StatusStrategy::FAILED);
-    if (!m_scriptState.currentStatus.isNull()) {
-        status->mutable_execution_game_state()->CopyFrom(m_scriptState.currentStatus->game_state());
-        status->mutable_execution_state()->CopyFrom(assembleWorldState());
-        status->mutable_execution_user_input()->CopyFrom(userInput);
+    // already set if the strategy failed during process
+    if (!m_scriptState.currentStatus.isNull() && !status->has_execution_state()) {
+        setExecutionState(status);
     }
 
     // log error
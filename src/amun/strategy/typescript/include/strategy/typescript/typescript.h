@@ -25,6 +25,7 @@
 
 #include <QString>
 #include <QMap>
+#include <QHash>
 #include <QTextStream>
 #include <QAtomicInt>
 #include <v8.h>
@@ -47,7 +48,7 @@ class Typescript : public AbstractStrategyScript
 {
     Q_OBJECT
 public:
-    Typescript(const Timer *timer, StrategyType type, ScriptState& scriptState, CompilerRegistry* registry);
+    Typescript(const Timer *timer, StrategyType type, ScriptState& scriptState, CompilerRegistry* registry, v8::Platform *platform);
 
     static bool canHandle(const QString &filename);
     ~Typescript() override;
@@ -58,6 +59,8 @@ public:
     bool canReloadInPlace() const override { return  true; }
     bool canHandleDynamic(const QString &filename) const override { return Typescript::canHandle(filename); }
     void compileIfNecessary() override;
+    void performIdleTasks(double budget) override;
+    double garbageCollectionTime() const override { return m_gcTime; }
 
     // functions used for debugging v8
     void disableTimeoutOnce(); // disables script timeout for the currently running strategy frame
@@ -84,6 +87,11 @@ private:
     bool loadModule(QString name);
     v8::ScriptOrigin *scriptOriginFromFileName(QString name);
     static void saveNode(QTextStream &file, const v8::CpuProfileNode *node, QString functionStack);
+    void updateContinuousProfiling();
+    void addContinuousProfile(const v8::CpuProfile *profile);
+    quint32 continuousProfileNode(const v8::CpuProfileNode *node, QHash<const v8::CpuProfileNode*, quint32> &nodeIds);
+    static void gcPrologue(v8::Isolate *isolate, v8::GCType type, v8::GCCallbackFlags flags, void *data);
+    static void gcEpilogue(v8::Isolate *isolate, v8::GCType type, v8::GCCallbackFlags flags, void *data);
     void clearRequireCache();
     void createGlobalScope();
 
@@ -99,13 +107,14 @@ private slots:
     void onCompileStarted();
     void onCompileWarning(const QString &message);
     void onCompileError(const QString &message);
-    void onCompileSuccess();
+    void onCompileSuccess(const QString &message);
 
     void handleDebug(const amun::DebugValue &debug);
     void handleLog(const QString &text);
     void handleVisualization(const amun::Visualization &vis);
 
 private:
+    v8::Platform *m_platform;
     v8::Isolate* m_isolate;
     // The isolate does not take ownership of the allocator.
     // Hence it needs to be stored and deleted manually.
@@ -118,6 +127,8 @@ private:
     v8::Persistent<v8::Context> m_context;
     v8::Persistent<v8::Function> m_function;
     double m_totalPathTime;
+    qint64 m_gcStartTime;
+    double m_gcTime;
 
     QList<QMap<QString, v8::Global<v8::Value>*>> m_requireCache;
     v8::Persistent<v8::FunctionTemplate> m_requireTemplate;
@@ -126,6 +137,10 @@ private:
     int m_executionCounter;
 
     v8::CpuProfiler *m_profiler;
+    v8::CpuProfiler *m_continuousProfiler;
+    // alternates between two profile titles, see updateContinuousProfiling
+    bool m_continuousProfileSlot;
+    qint64 m_continuousProfileStart;
     CheckForScriptTimeout *m_checkForScriptTimeout;
     QThread *m_timeoutCheckerThread;
     QList<v8::ScriptOrigin*> m_scriptOrigins;
@@ -444,16 +444,10 @@ static void amunAddPolygonSimple(const FunctionCallbackInfo<Value>& args)
     }
 }
 
-static void amunAddDebug(const FunctionCallbackInfo<Value>& args)
+template<typename DebugValueType>
+static void setDebugValue(Isolate *isolate, Local<Value> value, DebugValueType *debugValue)
 {
-    Isolate* isolate = args.GetIsolate();
-    Typescript *t = static_cast<Typescript*>(Local<External>::Cast(args.Data())->Value());
-    amun::DebugValue *debugValue = t->addDebug();
-    String::Utf8Value key(isolate, args[0]);
-    debugValue->set_key(*key);
-
     Local<Context> context = isolate->GetCurrentContext();
-    Local<Value> value = args[1];
     if (value->IsNumber()) {
         debugValue->set_float_value(float(value->NumberValue(context).ToChecked()));
     } else if (value->IsBoolean()) {
@@ -467,6 +461,61 @@ static void amunAddDebug(const FunctionCallbackInfo<Value>& args)
     }
 }
 
+static void amunAddDebug(const FunctionCallbackInfo<Value>& args)
+{
+    Isolate* isolate = args.GetIsolate();
+    Typescript *t = static_cast<Typescript*>(Local<External>::Cast(args.Data())->Value());
+    amun::DebugValue *debugValue = t->addDebug();
+    String::Utf8Value key(isolate, args[0]);
+    debugValue->set_key(*key);
+
+    setDebugValue(isolate, args[1], debugValue);
+}
+
+static void amunRegisterDebugKey(const FunctionCallbackInfo<Value>& args)
+{
+    Isolate* isolate = args.GetIsolate();
+    Typescript *t = static_cast<Typescript*>(Local<External>::Cast(args.Data())->Value());
+    if (args.Length() != 1 || !args[0]->IsString()) {
+        throwError(isolate, "registerDebugKey takes one string");
+        return;
+    }
+    String::Utf8Value key(isolate, args[0]);
+    args.GetReturnValue().Set(Integer::NewFromUnsigned(isolate, t->registerDebugKey(std::string(*key, key.length()))));
+}
+
+static void amunAddDebugBatch(const FunctionCallbackInfo<Value>& args)
+{
+    Isolate* isolate = args.GetIsolate();
+    Typescript *t = static_cast<Typescript*>(Local<External>::Cast(args.Data())->Value());
+    if (args.Length() < 2 || !args[0]->IsArray() || !args[1]->IsArray()) {
+        throwError(isolate, "addDebugBatch takes an array of handles and an array of values");
+        return;
+    }
+    Local<Context> context = isolate->GetCurrentContext();
+    Local<Array> handles = Local<Array>::Cast(args[0]);
+    Local<Array> values = Local<Array>::Cast(args[1]);
+    const uint32_t count = args.Length() > 2 && args[2]->IsUint32()
+            ? std::min(args[2]->Uint32Value(context).ToChecked(), handles->Length())
+            : handles->Length();
+    if (values->Length() < count) {
+        throwError(isolate, "Less values than handles");
+        return;
+    }
+    for (uint32_t i = 0;i < count;i++) {
+        Local<Value> handleValue = handles->Get(context, i).ToLocalChecked();
+        uint32_t handle = 0;
+        if (handleValue->IsUint32()) {
+            handle = handleValue->Uint32Value(context).ToChecked();
+        }
+        if (!handleValue->IsUint32() || !t->isValidDebugHandle(handle)) {
+            throwError(isolate, "Invalid debug key handle");
+            return;
+        }
+        setDebugValue(isolate, values->Get(context, i).ToLocalChecked(), t->addDebugHandleValue(handle));
+    }
+}
+
 static void amunAddPlot(const FunctionCallbackInfo<Value>& args)
 {
     Isolate* isolate = args.GetIsolate();
@@ -792,6 +841,8 @@ void registerAmunJsCallbacks(Isolate *isolate, Local<Object> global, Typescript
         { "addPathSimple",      amunAddPathSimple},
         { "addPolygonSimple",   amunAddPolygonSimple},
         { "addDebug",           amunAddDebug},
+        { "registerDebugKey",   amunRegisterDebugKey},
+        { "addDebugBatch",      amunAddDebugBatch},
         { "addPlot",            amunAddPlot},
         { "getPerformanceMode", amunGetPerformanceMode},
         { "setCommand",         amunSetCommand},
@@ -56,6 +56,7 @@ InternalTypescriptCompiler::~InternalTypescriptCompiler()
         // don't use an Isolate::Scope since we need to Exit before Dispose
         m_isolate->Enter();
         m_requireNamespace.reset();
+        m_compileFunction.Reset();
         m_context.Reset();
         // This is needed for a full gc as the isolate is beeing disposed.
         // The JS memory is reclaimed easily, but its c++ callbacks are never called.
@@ -120,8 +121,8 @@ void InternalTypescriptCompiler::initializeEnvironment()
         Local<Array> argv = createStringArray(m_isolate, {
             QCoreApplication::applicationFilePath(),
             m_compilerPath,
-            "--pretty", "false", "--incremental", "true",
-            "--outDir", "built/built-tmp/"
+            // only load the compiler, the compilation itself is started by INCREMENTAL_DRIVER
+            "--version"
         });
         addObjectField(m_isolate, process, "argv", argv);
     }
@@ -251,6 +252,142 @@ void InternalTypescriptCompiler::stdoutCallback(const FunctionCallbackInfo<Value
     }
 }
 
+// Keeps the builder program and the parsed source files alive between compilations.
+// Only changed files are parsed again, the builder then only checks and emits the affected files.
+// The build state is additionally persisted in the .tsbuildinfo file of the output directory,
+// which allows an incremental compilation after restarting.
+static const char *INCREMENTAL_DRIVER = R"JS(
+(function (ts, configFileName, outDir) {
+    var sourceFileCache = new Map();
+    var builderProgram;
+
+    return function () {
+        var startTime = Date.now();
+        var reportDiagnostic = ts.createDiagnosticReporter(ts.sys, false);
+        var parseHost = Object.create(ts.sys);
+        parseHost.onUnRecoverableConfigFileDiagnostic = reportDiagnostic;
+        var config = ts.getParsedCommandLineOfConfigFile(configFileName, { outDir: outDir, incremental: true }, parseHost);
+        if (!config) {
+            return { exitStatus: ts.ExitStatus.InvalidProject_OutputsSkipped, summary: "" };
+        }
+
+        var host = ts.createIncrementalCompilerHost(config.options, ts.sys);
+        var getSourceFile = host.getSourceFile;
+        host.getSourceFile = function (fileName, languageVersion, onError, shouldCreateNewSourceFile) {
+            var text = host.readFile(fileName);
+            var cached = sourceFileCache.get(fileName);
+            if (!shouldCreateNewSourceFile && cached && cached.text === text && cached.languageVersion === languageVersion) {
+                return cached.sourceFile;
+            }
+            var sourceFile = getSourceFile.call(host, fileName, languageVersion, onError, shouldCreateNewSourceFile);
+            sourceFileCache.set(fileName, { text: text, languageVersion: languageVersion, sourceFile: sourceFile });
+            return sourceFile;
+        };
+
+        builderProgram = ts.createEmitAndSemanticDiagnosticsBuilderProgram(config.fileNames, config.options, host,
+            builderProgram || ts.readBuilderProgram(config.options, host),
+            ts.getConfigFileParsingDiagnostics(config), config.projectReferences);
+
+        // check each affected file separately to measure the time spent on it,
+        // the diagnostics are cached by the builder and reported afterwards
+        var timings = new Map();
+        var lastTime = Date.now();
+        var affected;
+        while ((affected = builderProgram.getSemanticDiagnosticsOfNextAffectedFile()) !== undefined) {
+            var now = Date.now();
+            if (affected.affected.fileName !== undefined) {
+                timings.set(affected.affected.fileName, now - lastTime);
+            }
+            lastTime = now;
+        }
+
+        lastTime = Date.now();
+        var writeFile = function (fileName, data, writeByteOrderMark, onError, sourceFiles) {
+            var now = Date.now();
+            if (sourceFiles && sourceFiles.length === 1) {
+                var source = sourceFiles[0].fileName;
+                timings.set(source, (timings.get(source) || 0) + now - lastTime);
+            }
+            ts.sys.writeFile(fileName, data, writeByteOrderMark);
+            lastTime = Date.now();
+        };
+        var exitStatus = ts.emitFilesAndReportErrorsAndGetExitStatus(builderProgram, reportDiagnostic,
+            function (s) { ts.sys.write(s + ts.sys.newLine); }, undefined, writeFile);
+
+        // forget files, which are no longer part of the program
+        var usedFiles = new Set(builderProgram.getProgram().getSourceFiles().map(function (f) { return f.fileName; }));
+        sourceFileCache.forEach(function (value, fileName) {
+            if (!usedFiles.has(fileName)) {
+                sourceFileCache.delete(fileName);
+            }
+        });
+
+        var sorted = [];
+        timings.forEach(function (time, fileName) { sorted.push({ fileName: fileName, time: time }); });
+        sorted.sort(function (a, b) { return b.time - a.time; });
+        var summary = "Compiled " + timings.size + " of " + usedFiles.size + " files in " + (Date.now() - startTime) + " ms";
+        var baseDir = ts.getDirectoryPath(configFileName);
+        sorted.slice(0, 5).forEach(function (entry) {
+            summary += "\n    " + ts.getRelativePathFromDirectory(baseDir, entry.fileName, false) + ": " + entry.time + " ms";
+        });
+        return { exitStatus: exitStatus, summary: summary };
+    };
+})
+)JS";
+
+bool InternalTypescriptCompiler::loadCompiler(QString &errorMsg)
+{
+    Local<Context> context = m_isolate->GetCurrentContext();
+
+    QFile compilerFile(m_compilerPath);
+    if (!compilerFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        errorMsg = "Could not open compiler";
+        return false;
+    }
+    QByteArray compilerBytes = compilerFile.readAll();
+
+    TryCatch tryCatch(m_isolate);
+    // as tsc is started with --version, this only defines the ts namespace
+    Local<Script> script;
+    if (!Script::Compile(context, v8string(m_isolate, compilerBytes)).ToLocal(&script)
+            || script->Run(context).IsEmpty()) {
+        errorMsg = *String::Utf8Value(m_isolate, tryCatch.StackTrace(context).ToLocalChecked());
+        return false;
+    }
+    m_stdout.clear();
+
+    Local<Script> driverScript;
+    Local<Value> driver;
+    Local<Value> ts;
+    if (!Script::Compile(context, v8string(m_isolate, INCREMENTAL_DRIVER)).ToLocal(&driverScript)
+            || !driverScript->Run(context).ToLocal(&driver)
+            || !context->Global()->Get(context, v8string(m_isolate, "ts")).ToLocal(&ts)) {
+        errorMsg = *String::Utf8Value(m_isolate, tryCatch.StackTrace(context).ToLocalChecked());
+        return false;
+    }
+    if (!driver->IsFunction() || !ts->IsObject()) {
+        errorMsg = "Could not set up incremental compilation";
+        return false;
+    }
+
+    Local<Value> arguments[] = {
+        ts,
+        v8string(m_isolate, m_tsconfig.absoluteFilePath()),
+        v8string(m_isolate, m_tsconfig.dir().absolutePath() + "/built/built-tmp/")
+    };
+    Local<Value> compileFunction;
+    if (!Local<Function>::Cast(driver)->Call(context, context->Global(), 3, arguments).ToLocal(&compileFunction)) {
+        errorMsg = *String::Utf8Value(m_isolate, tryCatch.StackTrace(context).ToLocalChecked());
+        return false;
+    }
+    if (!compileFunction->IsFunction()) {
+        errorMsg = "Could not set up incremental compilation";
+        return false;
+    }
+    m_compileFunction.Reset(m_isolate, Local<Function>::Cast(compileFunction));
+    return true;
+}
+
 std::pair<InternalTypescriptCompiler::CompileResult, QString> InternalTypescriptCompiler::performCompilation()
 {
     if (!m_isolate) {
@@ -262,38 +399,54 @@ std::pair<InternalTypescriptCompiler::CompileResult, QString> InternalTypescript
     Local<Context> context = m_context.Get(m_isolate);
     Context::Scope contextScope(context);
 
-    QFile compilerFile(m_compilerPath);
-    if (!compilerFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        return { CompileResult::Error, "Could not open compiler" };
+    if (m_compileFunction.IsEmpty()) {
+        QString errorMsg;
+        if (!loadCompiler(errorMsg)) {
+            return { CompileResult::Error, errorMsg };
+        }
     }
-    QByteArray compilerBytes = compilerFile.readAll();
-
 
-    Local<String> source = v8string(m_isolate, compilerBytes);
-    Local<Script> script;
     TryCatch tryCatch(m_isolate);
-    if (!Script::Compile(context, source).ToLocal(&script)) {
-        String::Utf8Value errorMsg(m_isolate, tryCatch.StackTrace(context).ToLocalChecked());
-        return { CompileResult::Error, *errorMsg };
-    }
-    Local<Value> exitCodeValue;
+    Local<Function> compileFunction = m_compileFunction.Get(m_isolate);
+    Local<Value> resultValue;
     running = true;
-    bool exitcodeValid = script->Run(context).ToLocal(&exitCodeValue);
-    if (running) {
-        handleExitcode(
-            exitcodeValid,
-            exitcodeValid
-                ? exitCodeValue->Int32Value(context).ToChecked()
-                : -1
-        );
-    } else {
+    bool resultValid = compileFunction->Call(context, context->Global(), 0, nullptr).ToLocal(&resultValue)
+            && resultValue->IsObject();
+    if (!running) {
+        // the compiler called process.exit, its exit code was already handled
         m_isolate->CancelTerminateExecution();
+        m_compileFunction.Reset();
+        return m_lastResult;
     }
+    running = false;
     if (tryCatch.HasTerminated() || tryCatch.HasCaught()) {
         String::Utf8Value errorMsg(m_isolate, tryCatch.StackTrace(context).ToLocalChecked());
+        // the builder state may be inconsistent, start from the persisted build info next time
+        m_compileFunction.Reset();
         return { CompileResult::Error, *errorMsg };
     }
 
+    int32_t exitcode = -1;
+    QString summary;
+    if (resultValid) {
+        Local<Object> result = Local<Object>::Cast(resultValue);
+        Local<Value> exitcodeValue;
+        Local<Value> summaryValue;
+        resultValid = result->Get(context, v8string(m_isolate, "exitStatus")).ToLocal(&exitcodeValue)
+                && exitcodeValue->Int32Value(context).To(&exitcode);
+        if (result->Get(context, v8string(m_isolate, "summary")).ToLocal(&summaryValue) && summaryValue->IsString()) {
+            summary = *String::Utf8Value(m_isolate, summaryValue);
+        }
+    }
+    handleExitcode(resultValid, exitcode);
+
+    // report the compile timings along with the diagnostics
+    if (!summary.isEmpty()) {
+        if (!m_lastResult.second.isEmpty()) {
+            m_lastResult.second += "<br/>";
+        }
+        m_lastResult.second += summary.replace("\n", "<br/>");
+    }
     return m_lastResult;
 }
 
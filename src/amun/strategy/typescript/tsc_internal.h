@@ -52,6 +52,8 @@ private:
     static void exitCompilation(const v8::FunctionCallbackInfo<v8::Value>& args);
     static void stdoutCallback(const v8::FunctionCallbackInfo<v8::Value>& args);
 
+    // loads tsc and prepares the incremental compilation
+    bool loadCompiler(QString &errorMsg);
     // WARNING: this function is NOT re-entrant
     std::pair<CompileResult, QString> performCompilation() override;
     void handleExitcode(bool exitcodeValid, int exitcode);
@@ -61,6 +63,8 @@ private:
     // Hence it needs to be stored and deleted manually.
     std::unique_ptr<v8::ArrayBuffer::Allocator> m_arrayAllocator;
     v8::Global<v8::Context> m_context;
+    // keeps the builder program alive between compilations
+    v8::Global<v8::Function> m_compileFunction;
 
     std::unique_ptr<Node::ObjectContainer> m_requireNamespace;
     bool running = false;
@@ -23,6 +23,8 @@
 #include <QFileInfo>
 #include <QDebug>
 #include <QThread>
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include <v8.h>
 #include <libplatform/libplatform.h>
@@ -33,6 +35,7 @@
 #include "js_amun.h"
 #include "js_path.h"
 #include "checkforscripttimeout.h"
+#include "core/timer.h"
 #include "inspectorholder.h"
 #include "internaldebugger.h"
 #include "inspectorserver.h"
@@ -47,11 +50,17 @@ using namespace v8helper;
 // use this to silence a warn_unused_result warning
 template <typename T> inline void USE(T&&) {}
 
-Typescript::Typescript(const Timer *timer, StrategyType type, ScriptState& scriptState, CompilerRegistry* registry) :
+Typescript::Typescript(const Timer *timer, StrategyType type, ScriptState& scriptState, CompilerRegistry* registry, Platform *platform) :
     AbstractStrategyScript (timer, type, scriptState, registry),
+    m_platform(platform),
+    m_gcStartTime(0),
+    m_gcTime(0),
     m_requireCache({{}}),
     m_executionCounter(0),
     m_profiler (nullptr),
+    m_continuousProfiler(nullptr),
+    m_continuousProfileSlot(false),
+    m_continuousProfileStart(0),
     m_scriptIdCounter(0),
     m_luaState(nullptr)
 {
@@ -61,6 +70,8 @@ Typescript::Typescript(const Timer *timer, StrategyType type, ScriptState& scrip
     m_isolate = Isolate::New(create_params);
     m_isolate->SetRAILMode(PERFORMANCE_LOAD);
     m_isolate->Enter();
+    m_isolate->AddGCPrologueCallback(gcPrologue, this);
+    m_isolate->AddGCEpilogueCallback(gcEpilogue, this);
 
     // creates its own QThread and moves to it
     m_checkForScriptTimeout = new CheckForScriptTimeout(m_isolate, m_timeoutCounter);
@@ -100,10 +111,16 @@ Typescript::~Typescript()
         m_profiler->Dispose();
         m_profiler = nullptr;
     }
+    if (m_continuousProfiler != nullptr) {
+        m_continuousProfiler->Dispose();
+        m_continuousProfiler = nullptr;
+    }
     clearRequireCache();
     m_function.Reset();
     m_requireTemplate.Reset();
     m_context.Reset();
+    m_isolate->RemoveGCPrologueCallback(gcPrologue, this);
+    m_isolate->RemoveGCEpilogueCallback(gcEpilogue, this);
     m_isolate->Exit();
     m_isolate->Dispose();
     if (m_luaState) {
@@ -628,8 +645,11 @@ void Typescript::onCompileError(const QString &message)
     }
 }
 
-void Typescript::onCompileSuccess()
+void Typescript::onCompileSuccess(const QString &message)
 {
+    if (!message.isEmpty()) {
+        log(message);
+    }
     loadTypescript(m_filename, m_requestedEntrypoint);
 }
 
@@ -821,12 +841,102 @@ void Typescript::saveNode(QTextStream &file, const CpuProfileNode *node, QString
     }
 }
 
+static const char *CONTINUOUS_PROFILE_TITLES[2] = { "continuous-a", "continuous-b" };
+static const int CONTINUOUS_SAMPLING_INTERVAL = 1000; // in microseconds
+static const qint64 CONTINUOUS_PROFILE_DURATION = 1000 * 1000 * 1000LL;
+
+quint32 Typescript::continuousProfileNode(const CpuProfileNode *node, QHash<const CpuProfileNode*, quint32> &nodeIds)
+{
+    auto it = nodeIds.find(node);
+    if (it != nodeIds.end()) {
+        return it.value();
+    }
+    const CpuProfileNode *parent = node->GetParent();
+    // the root node itself is not part of any call stack
+    const quint32 parentId = (parent == nullptr || parent->GetParent() == nullptr) ? ProfileAggregator::NO_PARENT
+            : continuousProfileNode(parent, nodeIds);
+    std::string name = node->GetFunctionNameStr();
+    if (name.empty()) {
+        name = "(anonymous)";
+    }
+    const quint32 function = m_profileAggregator.functionId(name, node->GetScriptResourceNameStr(), node->GetLineNumber());
+    const quint32 id = m_profileAggregator.nodeId(parentId, function);
+    nodeIds.insert(node, id);
+    return id;
+}
+
+void Typescript::addContinuousProfile(const CpuProfile *profile)
+{
+    QHash<const CpuProfileNode*, quint32> nodeIds;
+    const qint64 currentTime = time();
+    int64_t lastTimestamp = profile->GetStartTime();
+    for (int i = 0; i < profile->GetSamplesCount(); i++) {
+        // the timestamps are given in microseconds, gaps between strategy runs are not attributed
+        const int64_t timestamp = profile->GetSampleTimestamp(i);
+        const int64_t duration = std::min<int64_t>(timestamp - lastTimestamp, 2 * CONTINUOUS_SAMPLING_INTERVAL);
+        lastTimestamp = timestamp;
+
+        const CpuProfileNode *node = profile->GetSample(i);
+        // time outside of the strategy is reported as (program) or (idle)
+        if (node == nullptr || node->GetParent() == nullptr || (node->GetScriptId() == 0
+                && (strcmp(node->GetFunctionNameStr(), "(program)") == 0 || strcmp(node->GetFunctionNameStr(), "(idle)") == 0))) {
+            continue;
+        }
+        m_profileAggregator.addSample(currentTime, continuousProfileNode(node, nodeIds), std::max<int64_t>(duration, 0) * 1E-6f);
+    }
+}
+
+void Typescript::updateContinuousProfiling()
+{
+    // the offline profiler takes precedence
+    const bool enabled = m_scriptState.isContinuousProfiling && m_profiler == nullptr;
+    if (!enabled) {
+        if (m_continuousProfiler != nullptr) {
+            HandleScope handleScope(m_isolate);
+            CpuProfile *profile = m_continuousProfiler->StopProfiling(v8string(m_isolate, CONTINUOUS_PROFILE_TITLES[m_continuousProfileSlot]));
+            if (profile) {
+                profile->Delete();
+            }
+            m_continuousProfiler->Dispose();
+            m_continuousProfiler = nullptr;
+            m_profileAggregator.clear();
+        }
+        return;
+    }
+
+    HandleScope handleScope(m_isolate);
+    const qint64 now = Timer::systemTime();
+    if (m_continuousProfiler == nullptr) {
+        m_continuousProfiler = CpuProfiler::New(m_isolate);
+        m_continuousProfiler->SetSamplingInterval(CONTINUOUS_SAMPLING_INTERVAL);
+        m_continuousProfiler->StartProfiling(v8string(m_isolate, CONTINUOUS_PROFILE_TITLES[m_continuousProfileSlot]), true);
+        m_continuousProfileStart = now;
+        return;
+    }
+    if (now - m_continuousProfileStart < CONTINUOUS_PROFILE_DURATION) {
+        return;
+    }
+
+    // start the next profile before stopping the current one, otherwise the profiler would shut down its sampler thread
+    const bool lastSlot = m_continuousProfileSlot;
+    m_continuousProfileSlot = !m_continuousProfileSlot;
+    m_continuousProfiler->StartProfiling(v8string(m_isolate, CONTINUOUS_PROFILE_TITLES[m_continuousProfileSlot]), true);
+    m_continuousProfileStart = now;
+    CpuProfile *profile = m_continuousProfiler->StopProfiling(v8string(m_isolate, CONTINUOUS_PROFILE_TITLES[lastSlot]));
+    if (profile) {
+        addContinuousProfile(profile);
+        profile->Delete();
+    }
+}
+
 void Typescript::startProfiling()
 {
     HandleScope handleScope(m_isolate);
     m_profiler = CpuProfiler::New(m_isolate);
     m_profiler->SetSamplingInterval(200);
     m_profiler->StartProfiling(v8string(m_isolate, "profile"));
+    // the continuous profiler is paused while the offline profile is recorded
+    updateContinuousProfiling();
 }
 
 void Typescript::endProfiling(const std::string &filename)
@@ -845,12 +955,31 @@ void Typescript::endProfiling(const std::string &filename)
     m_profiler = nullptr;
 }
 
+void Typescript::gcPrologue(Isolate *, GCType, GCCallbackFlags, void *data)
+{
+    static_cast<Typescript*>(data)->m_gcStartTime = Timer::systemTime();
+}
+
+void Typescript::gcEpilogue(Isolate *, GCType, GCCallbackFlags, void *data)
+{
+    Typescript *t = static_cast<Typescript*>(data);
+    t->m_gcTime += (Timer::systemTime() - t->m_gcStartTime) * 1E-9;
+}
+
+void Typescript::performIdleTasks(double budget)
+{
+    // the deadline is relative to the monotonic clock of the platform
+    m_isolate->IdleNotificationDeadline(m_platform->MonotonicallyIncreasingTime() + budget);
+}
+
 bool Typescript::process(double &pathPlanning)
 {
     m_executionCounter++;
     m_timeoutCounter.store(m_executionCounter);
 
     m_totalPathTime = 0;
+    // only count the collections done while the strategy is running
+    m_gcTime = 0;
 
     HandleScope handleScope(m_isolate);
     Local<Context> context = Local<Context>::New(m_isolate, m_context);
@@ -863,6 +992,7 @@ bool Typescript::process(double &pathPlanning)
     if (buildStackTrace(context, m_errorMsg, tryCatch)) {
         m_isolate->CancelTerminateExecution();
     }
+    updateContinuousProfiling();
     if (tryCatch.HasTerminated() || tryCatch.HasCaught()) {
         return false;
     }
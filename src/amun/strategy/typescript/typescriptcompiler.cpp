@@ -175,7 +175,7 @@ void TypescriptCompiler::doCompile()
 
     switch (result.first) {
     case CompileResult::Success:
-        emit success();
+        emit success(result.second);
         break;
     case CompileResult::Warning:
         emit warning(result.second);
@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "visioningest.h"
+#include "receiver.h"
+#include "processor/visioningestqueue.h"
+#include "tracking/visionframe.h"
+#include <QThread>
+
+#ifdef Q_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// above the default of all other threads, but below kernel threads like the network interrupts
+static const int INGEST_PRIORITY = 10;
+
+VisionIngest::VisionIngest(const QHostAddress &groupAddress, quint16 port, Timer *timer, const std::shared_ptr<VisionIngestQueue> &queue) :
+    m_receiver(new Receiver(groupAddress, port, timer)),
+    m_decoder(new VisionFrameDecoder),
+    m_queue(queue)
+{
+    // moves to the ingest thread together with this object
+    m_receiver->setParent(this);
+    connect(m_receiver, &Receiver::gotPackets, this, &VisionIngest::handlePackets);
+    connect(m_receiver, &Receiver::sendStatus, this, &VisionIngest::sendStatus);
+}
+
+VisionIngest::~VisionIngest() = default;
+
+void VisionIngest::start()
+{
+#ifdef Q_OS_LINUX
+    // real time scheduling requires CAP_SYS_NICE or a matching rtprio limit, otherwise keep the normal policy
+    sched_param param = {};
+    param.sched_priority = INGEST_PRIORITY;
+    if (pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) != 0) {
+        QThread::currentThread()->setPriority(QThread::TimeCriticalPriority);
+    }
+    // the last core, the remaining threads are usually started on the first ones
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(QThread::idealThreadCount() - 1, &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+#else
+    QThread::currentThread()->setPriority(QThread::TimeCriticalPriority);
+#endif
+
+    m_receiver->startListen();
+}
+
+void VisionIngest::updateInterface(const QNetworkInterface &interface)
+{
+    m_receiver->updateInterface(interface);
+}
+
+void VisionIngest::updatePort(quint16 port)
+{
+    m_receiver->updatePort(port);
+}
+
+void VisionIngest::handlePackets(const QList<ReceivedPacket> &packets)
+{
+    bool pushed = false;
+    for (const ReceivedPacket &packet : packets) {
+        IngestedVisionFrame ingested;
+        ingested.frame = m_decoder->decode(packet.data, packet.time, packet.sender);
+        if (!ingested.frame) {
+            continue;
+        }
+        ingested.time = packet.time;
+        ingested.wakeupDelay = packet.wakeupDelay;
+        if (m_queue->frames.push(ingested)) {
+            pushed = true;
+        } else {
+            // the processor is far behind, newer frames are more useful than a complete history
+            m_queue->dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // pairs with the sequentially consistent store of the consumer, see Processor::drainVisionIngestQueue
+    if (pushed && !m_queue->notified.exchange(true, std::memory_order_seq_cst)) {
+        emit framesAvailable();
+    }
+}
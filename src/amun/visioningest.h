@@ -0,0 +1,67 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef VISIONINGEST_H
+#define VISIONINGEST_H
+
+#include "core/receivedpacket.h"
+#include "protobuf/status.h"
+#include <QObject>
+#include <memory>
+
+class QHostAddress;
+class QNetworkInterface;
+class Receiver;
+class Timer;
+class VisionFrameDecoder;
+struct VisionIngestQueue;
+
+// receives and decodes vision packets on a dedicated thread and passes the frames to the processor
+class VisionIngest : public QObject
+{
+    Q_OBJECT
+
+public:
+    VisionIngest(const QHostAddress &groupAddress, quint16 port, Timer *timer, const std::shared_ptr<VisionIngestQueue> &queue);
+    ~VisionIngest() override;
+    VisionIngest(const VisionIngest&) = delete;
+    VisionIngest& operator=(const VisionIngest&) = delete;
+
+signals:
+    // emitted once the queue has new frames, the processor has to drain it completely
+    void framesAvailable();
+    void sendStatus(const Status &status);
+
+public slots:
+    // must be called from the ingest thread
+    void start();
+    void updateInterface(const QNetworkInterface &interface);
+    void updatePort(quint16 port);
+
+private slots:
+    void handlePackets(const QList<ReceivedPacket> &packets);
+
+private:
+    Receiver *m_receiver;
+    std::unique_ptr<VisionFrameDecoder> m_decoder;
+    std::shared_ptr<VisionIngestQueue> m_queue;
+};
+
+#endif // VISIONINGEST_H
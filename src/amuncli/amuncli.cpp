@@ -19,12 +19,14 @@
  ***************************************************************************/
 
 #include "amun/amunclient.h"
+#include "amun/lockstepamun.h"
 #include "testtools/connector.h"
 
 #include <clocale>
 #include <QCoreApplication>
 #include <QCommandLineParser>
 #include <QProcessEnvironment>
+#include <memory>
 
 int main(int argc, char* argv[])
 {
@@ -56,6 +58,8 @@ int main(int argc, char* argv[])
     QCommandLineOption realismConfig("realism", "Simulator realism configuration (short file name without the .txt)", "realism");
     QCommandLineOption silent("silent", "Do not print any messages");
     QCommandLineOption forceStart({"f", "force-start"}, "Force start the game immediately (Kickoff will be used otherwise)");
+    QCommandLineOption lockstep("lockstep", "Run simulator, processor and strategies in a single deterministic loop as fast as possible. Ignores the simulation speed, the autoref is not supported");
+    QCommandLineOption seedOption("seed", "Simulator seed in lockstep mode. Defaults to 42", "seed", "42");
     parser.addOption(strategyColorConfig);
     parser.addOption(debugOption);
     parser.addOption(simulatorConfig);
@@ -72,6 +76,8 @@ int main(int argc, char* argv[])
     parser.addOption(realismConfig);
     parser.addOption(silent);
     parser.addOption(forceStart);
+    parser.addOption(lockstep);
+    parser.addOption(seedOption);
 
     // parse command line, handles --version
     parser.process(app);
@@ -96,17 +102,41 @@ int main(int argc, char* argv[])
     bool debug = parser.isSet(debugOption);
     int simulationRunningTime = parser.value(simulationTime).toInt();
     int numRobots = parser.value(numberOfRobots).toInt();
+    bool useLockstep = parser.isSet(lockstep);
+    bool seedValid;
+    quint32 seed = parser.value(seedOption).toUInt(&seedValid);
+
+    if (useLockstep && parser.isSet(autorefInitScript)) {
+        std::cerr <<"The autoref requires the game controller, which can not run in lockstep mode"<<std::endl;
+        exit(1);
+    }
+    if (!seedValid) {
+        std::cerr <<"The seed must be a non-negative integer!"<<std::endl;
+        exit(1);
+    }
+    if (!useLockstep && parser.isSet(seedOption)) {
+        std::cerr <<"The seed is only used in lockstep mode"<<std::endl;
+        exit(1);
+    }
 
     Connector connector;
 
     // compile the strategy beforehand to avoid using old compiles
     connector.compileStrategy(app, initScript);
 
-    AmunClient amun;
-    amun.start(true);
-
-    connector.connect(&connector, &Connector::sendCommand, &amun, &AmunClient::sendCommand);
-    connector.connect(&amun, &AmunClient::gotStatus, &connector, &Connector::handleStatus);
+    std::unique_ptr<AmunClient> amun;
+    std::unique_ptr<LockstepAmun> lockstepAmun;
+    if (useLockstep) {
+        lockstepAmun.reset(new LockstepAmun(seed));
+        connector.connect(&connector, &Connector::sendCommand, lockstepAmun.get(), &LockstepAmun::handleCommand);
+        connector.connect(lockstepAmun.get(), &LockstepAmun::gotStatus, &connector, &Connector::handleStatus);
+    } else {
+        amun.reset(new AmunClient);
+        amun->start(true);
+
+        connector.connect(&connector, &Connector::sendCommand, amun.get(), &AmunClient::sendCommand);
+        connector.connect(amun.get(), &AmunClient::gotStatus, &connector, &Connector::handleStatus);
+    }
 
     if (parser.isSet(recordLog)) {
         bool record = true;
@@ -164,6 +194,9 @@ int main(int argc, char* argv[])
     }
 
     connector.start();
+    if (lockstepAmun) {
+        lockstepAmun->start();
+    }
 
     return app.exec();
 }
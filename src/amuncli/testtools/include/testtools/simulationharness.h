@@ -0,0 +1,61 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef SIMULATIONHARNESS_H
+#define SIMULATIONHARNESS_H
+
+#include "core/timer.h"
+#include "core/vector.h"
+#include "protobuf/command.h"
+#include "protobuf/sslsim.h"
+#include "simulator/simulator.h"
+
+#include <functional>
+#include <map>
+
+// runs the simulator with manual triggering for scripted scenarios in tests and benchmarks
+class SimulationHarness
+{
+public:
+    SimulationHarness(uint32_t seed, int blueRobots, int yellowRobots, const RealismConfigErForce &realism);
+    SimulationHarness(const SimulationHarness&) = delete;
+    SimulationHarness& operator=(const SimulationHarness&) = delete;
+
+    // afterStep is called after every simulator step, once the radio commands for it were sent
+    void simulate(float seconds, const std::function<void()> &afterStep = {});
+    // this drive command stays active until a new one is given to the robot
+    void driveRobot(bool isBlue, int id, Vector localVelocity, float angular, bool enableDribbler = false, float kickSpeed = 0, float kickAngle = 0);
+    void teleportRobot(bool isBlue, int id, Vector position, Vector lookDirection);
+    void teleportBall(Vector position, Vector velocity);
+
+    camun::simulator::Simulator &simulator() { return m_simulator; }
+    const Timer &timer() const { return m_timer; }
+
+private:
+    static amun::SimulatorSetup createDefaultSetup();
+    void loadRobots(int blue, int yellow);
+
+private:
+    Timer m_timer;
+    camun::simulator::Simulator m_simulator;
+    std::map<std::pair<bool, int>, SSLSimRobotControl> m_robotCommands;
+};
+
+#endif // SIMULATIONHARNESS_H
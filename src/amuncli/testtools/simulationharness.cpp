@@ -0,0 +1,115 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "simulationharness.h"
+#include "core/configuration.h"
+#include "core/coordinates.h"
+#include "simulator/fastsimulator.h"
+
+SimulationHarness::SimulationHarness(uint32_t seed, int blueRobots, int yellowRobots, const RealismConfigErForce &realism) :
+    m_simulator(&m_timer, createDefaultSetup(), true)
+{
+    m_timer.setScaling(0);
+    m_timer.setTime(1234, 0);
+    m_simulator.seedPRGN(seed);
+    loadRobots(blueRobots, yellowRobots);
+
+    Command c(new amun::Command);
+    c->mutable_simulator()->set_enable(true);
+    c->mutable_transceiver()->set_charge(true);
+    c->mutable_simulator()->mutable_realism_config()->CopyFrom(realism);
+    m_simulator.handleCommand(c);
+}
+
+amun::SimulatorSetup SimulationHarness::createDefaultSetup()
+{
+    amun::SimulatorSetup setup;
+    loadConfiguration("cpptests/simulator-2020", &setup, false);
+    return setup;
+}
+
+void SimulationHarness::loadRobots(int blue, int yellow)
+{
+    robot::Generation specs;
+    loadConfiguration("cpptests/robots-generation-2020", &specs, true);
+
+    Command command(new amun::Command);
+    for (int i = 0;i<blue;i++) {
+        auto robot = command->mutable_set_team_blue()->add_robot();
+        robot->CopyFrom(specs.default_());
+        robot->set_id(i);
+    }
+    for (int i = 0;i<yellow;i++) {
+        auto robot = command->mutable_set_team_yellow()->add_robot();
+        robot->CopyFrom(specs.default_());
+        robot->set_id(i);
+    }
+    m_simulator.handleCommand(command);
+}
+
+void SimulationHarness::simulate(float seconds, const std::function<void()> &afterStep)
+{
+    FastSimulator::goDeltaCallback(&m_simulator, &m_timer, seconds * 1e9, [this, &afterStep](){
+        for (const auto &command : m_robotCommands) {
+            m_simulator.handleRadioCommands(command.second, command.first.first, 0);
+        }
+        if (afterStep) {
+            afterStep();
+        }
+    });
+}
+
+void SimulationHarness::driveRobot(bool isBlue, int id, Vector localVelocity, float angular, bool enableDribbler, float kickSpeed, float kickAngle)
+{
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    auto* cmd = control->add_robot_commands();
+    cmd->set_id(id);
+    auto * localVel = cmd->mutable_move_command()->mutable_local_velocity();
+    localVel->set_forward(localVelocity.x);
+    localVel->set_left(localVelocity.y);
+    localVel->set_angular(angular);
+    cmd->set_dribbler_speed(enableDribbler ? 100 : 0);
+    cmd->set_kick_speed(kickSpeed);
+    cmd->set_kick_angle(kickAngle);
+    m_robotCommands[{isBlue, id}] = control;
+}
+
+void SimulationHarness::teleportRobot(bool isBlue, int id, Vector position, Vector lookDirection)
+{
+    Command command(new amun::Command);
+    auto teleport = command->mutable_simulator()->mutable_ssl_control()->add_teleport_robot();
+    teleport->mutable_id()->set_id(id);
+    teleport->mutable_id()->set_team(isBlue ? gameController::Team::BLUE : gameController::Team::YELLOW);
+    coordinates::toVision(position, *teleport);
+    teleport->set_v_x(0);
+    teleport->set_v_y(0);
+    teleport->set_v_angular(0);
+    teleport->set_orientation(-lookDirection.normalized().angle());
+    m_simulator.handleCommand(command);
+}
+
+void SimulationHarness::teleportBall(Vector position, Vector velocity)
+{
+    Command command(new amun::Command);
+    auto teleport = command->mutable_simulator()->mutable_ssl_control()->mutable_teleport_ball();
+    coordinates::toVision(position, *teleport);
+    coordinates::toVisionVelocity(velocity, *teleport);
+    m_simulator.handleCommand(command);
+}
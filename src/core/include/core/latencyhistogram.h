@@ -0,0 +1,61 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <QString>
+#include <QVector>
+#include <array>
+
+namespace amun { class DebugValues; }
+
+// histogram of latencies, by default between 0 and 25 ms with a resolution of 0.25 ms
+class LatencyHistogram
+{
+public:
+    static const int PERCENTILE_COUNT = 3;
+
+    // larger latencies are collected in an overflow bucket
+    explicit LatencyHistogram(qint64 bucketSize = 250 * 1000, int bucketCount = 100);
+
+    void add(qint64 latency);
+    void clear();
+    int count() const { return m_count; }
+    // in milliseconds, 0 if the histogram is empty
+    float percentile(float p) const;
+    // adds the count and common percentiles below the given prefix
+    void writePercentiles(amun::DebugValues *debug, const QString &prefix) const;
+
+    // stores the count and percentiles of the collected latencies and clears the histogram.
+    // Publishing the last window avoids recomputing the percentiles on every write
+    void finishWindow();
+    int windowCount() const { return m_windowCount; }
+    void writeWindow(amun::DebugValues *debug, const QString &prefix) const;
+
+private:
+    qint64 m_bucketSize;
+    QVector<int> m_buckets;
+    int m_count;
+    int m_windowCount;
+    std::array<float, PERCENTILE_COUNT> m_windowPercentiles;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef LATENCYTRACE_H
+#define LATENCYTRACE_H
+
+#include "latencyhistogram.h"
+#include <QFile>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+#include <array>
+
+namespace amun { class DebugValues; }
+
+// Collects timestamps for the stages a vision frame passes until the
+// resulting radio commands are sent. A trace is identified by the world
+// state time of the strategy status of a processor iteration and is
+// started by its ProcessingStart stage, other stages without a trace are ignored.
+// All methods are thread safe.
+class LatencyTrace
+{
+public:
+    enum Stage {
+        VisionReceived,
+        ProcessingStart,
+        TrackingDone,
+        StrategyStart,
+        StrategyDone,
+        CommandsReceived,
+        RadioQueued,
+        RadioSent,
+        STAGE_COUNT
+    };
+
+    LatencyTrace();
+    ~LatencyTrace();
+    LatencyTrace(const LatencyTrace&) = delete;
+    LatencyTrace& operator=(const LatencyTrace&) = delete;
+
+    // monotonic timestamp in nanoseconds
+    static qint64 now();
+
+    // the strategy stages keep the earliest start and the latest end of all strategies
+    void record(qint64 traceId, Stage stage, qint64 time);
+    // the radio commands of a processor iteration contain the strategy commands of the given traces
+    void recordRadioQueued(qint64 processingStart, const QVector<qint64> &traceIds, qint64 time);
+    void recordRadioSent(qint64 processingStart, qint64 time);
+
+    // percentiles of the time spent in each stage, they are only updated once per second
+    void writeStatistics(amun::DebugValues *debug, qint64 time);
+    // writes every trace that reached all stages as a line of csv, an empty filename stops the export
+    bool setExportFile(const QString &filename);
+
+private:
+    struct Trace {
+        Trace() { times.fill(-1); }
+        std::array<qint64, STAGE_COUNT> times;
+    };
+
+    void complete(const Trace &trace);
+    void completeOutdated(qint64 time);
+
+private:
+    QMutex m_mutex;
+    QMap<qint64, Trace> m_traces;
+    // maps the processing start to the traces of the sent radio commands
+    QMap<qint64, QVector<qint64>> m_radioTraces;
+    // the first entry is the total latency, then the duration of every stage
+    std::array<LatencyHistogram, STAGE_COUNT> m_histograms;
+    qint64 m_windowStart;
+    QFile m_exportFile;
+};
+
+#endif // LATENCYTRACE_H
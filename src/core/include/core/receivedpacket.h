@@ -0,0 +1,39 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef RECEIVEDPACKET_H
+#define RECEIVEDPACKET_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+// datagram as delivered by a receiver
+struct ReceivedPacket
+{
+    QByteArray data;
+    // timer time of the arrival, based on the kernel timestamp if available
+    qint64 time;
+    QString sender;
+    // delay between the arrival and reading the packet in user space, -1 if unknown
+    qint64 wakeupDelay;
+};
+
+#endif // RECEIVEDPACKET_H
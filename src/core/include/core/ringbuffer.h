@@ -0,0 +1,75 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef RINGBUFFER_H
+#define RINGBUFFER_H
+
+#include <array>
+#include <cassert>
+
+// fixed capacity queue without allocations, index 0 is the oldest element
+template<typename T, int N>
+class RingBuffer
+{
+public:
+    static constexpr int capacity() { return N; }
+    int size() const { return m_count; }
+    bool isEmpty() const { return m_count == 0; }
+    bool isFull() const { return m_count == N; }
+
+    const T &at(int index) const
+    {
+        assert(index >= 0 && index < m_count);
+        return m_data[(m_start + index) % N];
+    }
+    const T &first() const { return at(0); }
+
+    // a full buffer drops its oldest element, returns whether that happened
+    bool append(const T &value)
+    {
+        const bool overflow = isFull();
+        if (overflow) {
+            removeFirst();
+        }
+        m_data[(m_start + m_count) % N] = value;
+        m_count++;
+        return overflow;
+    }
+
+    void removeFirst()
+    {
+        assert(m_count > 0);
+        m_start = (m_start + 1) % N;
+        m_count--;
+    }
+
+    void clear()
+    {
+        m_start = 0;
+        m_count = 0;
+    }
+
+private:
+    std::array<T, N> m_data;
+    int m_start = 0;
+    int m_count = 0;
+};
+
+#endif // RINGBUFFER_H
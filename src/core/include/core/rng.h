@@ -31,6 +31,8 @@ public:
 
 public:
     void seed(uint32_t seed);
+    void state(uint32_t &s1, uint32_t &s2, uint32_t &s3) const;
+    void setState(uint32_t s1, uint32_t s2, uint32_t s3);
     uint32_t uniformInt();
     double uniform();
     double uniformPositive();
@@ -0,0 +1,90 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// lock-free ring buffer for exactly one producer and one consumer thread
+template<typename T>
+class SpscQueue
+{
+public:
+    // the capacity is rounded up to the next power of two
+    explicit SpscQueue(std::size_t capacity) :
+        m_head(0),
+        m_tail(0)
+    {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        m_buffer.resize(size);
+        m_mask = size - 1;
+    }
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    std::size_t capacity() const { return m_buffer.size(); }
+
+    // producer only, returns false if the queue is full
+    bool push(T value)
+    {
+        const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) == m_buffer.size()) {
+            return false;
+        }
+        m_buffer[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // consumer only, returns false if the queue is empty
+    bool pop(T &value)
+    {
+        const std::size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        // release the slot content immediately, the producer only overwrites it later
+        value = std::move(m_buffer[head & m_mask]);
+        m_buffer[head & m_mask] = T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    std::vector<T> m_buffer;
+    std::size_t m_mask;
+    // separate cache lines, otherwise both threads keep invalidating each other
+    alignas(64) std::atomic<std::size_t> m_head;
+    alignas(64) std::atomic<std::size_t> m_tail;
+};
+
+#endif // SPSCQUEUE_H
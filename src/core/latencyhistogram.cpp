@@ -0,0 +1,98 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "latencyhistogram.h"
+#include "protobuf/debug.pb.h"
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram(qint64 bucketSize, int bucketCount) :
+    m_bucketSize(bucketSize),
+    m_buckets(bucketCount + 1, 0),
+    m_count(0),
+    m_windowCount(0),
+    m_windowPercentiles{}
+{
+}
+
+void LatencyHistogram::add(qint64 latency)
+{
+    const int bucket = qBound<qint64>(0, latency / m_bucketSize, m_buckets.size() - 1);
+    m_buckets[bucket]++;
+    m_count++;
+}
+
+void LatencyHistogram::clear()
+{
+    m_buckets.fill(0);
+    m_count = 0;
+}
+
+float LatencyHistogram::percentile(float p) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+    const int target = std::max(1, static_cast<int>(std::ceil(m_count * p)));
+    int sum = 0;
+    for (int i = 0; i < m_buckets.size(); i++) {
+        sum += m_buckets[i];
+        if (sum >= target) {
+            // report the upper bound of the bucket
+            return (i + 1) * m_bucketSize * 1E-6f;
+        }
+    }
+    return m_buckets.size() * m_bucketSize * 1E-6f;
+}
+
+static void addValue(amun::DebugValues *debug, const QString &key, float value)
+{
+    amun::DebugValue *debugValue = debug->add_value();
+    debugValue->set_key(key.toStdString());
+    debugValue->set_float_value(value);
+}
+
+static const float PERCENTILES[LatencyHistogram::PERCENTILE_COUNT] = { 0.5f, 0.9f, 0.99f };
+static const char *PERCENTILE_NAMES[LatencyHistogram::PERCENTILE_COUNT] = { "/p50", "/p90", "/p99" };
+
+void LatencyHistogram::writePercentiles(amun::DebugValues *debug, const QString &prefix) const
+{
+    addValue(debug, prefix + "/count", m_count);
+    for (int i = 0; i < PERCENTILE_COUNT; i++) {
+        addValue(debug, prefix + PERCENTILE_NAMES[i], percentile(PERCENTILES[i]));
+    }
+}
+
+void LatencyHistogram::finishWindow()
+{
+    m_windowCount = m_count;
+    for (int i = 0; i < PERCENTILE_COUNT; i++) {
+        m_windowPercentiles[i] = percentile(PERCENTILES[i]);
+    }
+    clear();
+}
+
+void LatencyHistogram::writeWindow(amun::DebugValues *debug, const QString &prefix) const
+{
+    addValue(debug, prefix + "/count", m_windowCount);
+    for (int i = 0; i < PERCENTILE_COUNT; i++) {
+        addValue(debug, prefix + PERCENTILE_NAMES[i], m_windowPercentiles[i]);
+    }
+}
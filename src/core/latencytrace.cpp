@@ -0,0 +1,197 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "latencytrace.h"
+#include <QMutexLocker>
+#include <QTextStream>
+#include <algorithm>
+#include <chrono>
+
+// traces are completed after this time even if not every stage was reached
+static const qint64 TRACE_TIMEOUT = 1000 * 1000 * 1000;
+// 0.5 ms resolution up to 100 ms
+static const qint64 BUCKET_SIZE = 500 * 1000;
+static const int BUCKET_COUNT = 200;
+// the percentiles are only recomputed after this time
+static const qint64 STATISTICS_WINDOW = 1000 * 1000 * 1000;
+
+static const char *STAGE_NAMES[LatencyTrace::STAGE_COUNT] = {
+    "vision received", "processing start", "tracking done", "strategy start",
+    "strategy done", "commands received", "radio queued", "radio sent"
+};
+// the duration of a stage is measured from the end of its predecessor,
+// commands are already sent while the strategy is still running
+static const int PREVIOUS_STAGE[LatencyTrace::STAGE_COUNT] = {
+    -1,
+    LatencyTrace::VisionReceived,
+    LatencyTrace::ProcessingStart,
+    LatencyTrace::TrackingDone,
+    LatencyTrace::StrategyStart,
+    LatencyTrace::StrategyStart,
+    LatencyTrace::CommandsReceived,
+    LatencyTrace::RadioQueued
+};
+
+LatencyTrace::LatencyTrace() :
+    m_windowStart(0)
+{
+    m_histograms.fill(LatencyHistogram(BUCKET_SIZE, BUCKET_COUNT));
+}
+
+LatencyTrace::~LatencyTrace()
+{
+    m_exportFile.close();
+}
+
+qint64 LatencyTrace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void LatencyTrace::record(qint64 traceId, Stage stage, qint64 time)
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_traces.find(traceId);
+    if (it == m_traces.end()) {
+        // without the processor, e.g. in replays, the stages can't be attributed to a vision frame
+        if (stage != ProcessingStart) {
+            return;
+        }
+        it = m_traces.insert(traceId, Trace());
+    }
+    qint64 &stageTime = it->times[stage];
+    if (stageTime == -1 || (stage == StrategyStart && time < stageTime)
+            || ((stage == StrategyDone || stage == CommandsReceived) && time > stageTime)) {
+        stageTime = time;
+    }
+    completeOutdated(time);
+}
+
+void LatencyTrace::recordRadioQueued(qint64 processingStart, const QVector<qint64> &traceIds, qint64 time)
+{
+    QMutexLocker locker(&m_mutex);
+    QVector<qint64> &radioTraces = m_radioTraces[processingStart];
+    for (qint64 traceId : traceIds) {
+        auto it = m_traces.find(traceId);
+        if (it != m_traces.end() && it->times[RadioQueued] == -1) {
+            it->times[RadioQueued] = time;
+            radioTraces.append(traceId);
+        }
+    }
+    if (radioTraces.isEmpty()) {
+        m_radioTraces.remove(processingStart);
+    }
+}
+
+void LatencyTrace::recordRadioSent(qint64 processingStart, qint64 time)
+{
+    QMutexLocker locker(&m_mutex);
+    const QVector<qint64> traceIds = m_radioTraces.take(processingStart);
+    for (qint64 traceId : traceIds) {
+        auto it = m_traces.find(traceId);
+        if (it != m_traces.end()) {
+            it->times[RadioSent] = time;
+            complete(*it);
+            m_traces.erase(it);
+        }
+    }
+    // the transceiver may skip commands
+    while (!m_radioTraces.isEmpty() && m_radioTraces.firstKey() < processingStart) {
+        m_radioTraces.erase(m_radioTraces.begin());
+    }
+}
+
+void LatencyTrace::completeOutdated(qint64 time)
+{
+    // every trace starts with the processing, thus the oldest one is always first
+    while (!m_traces.isEmpty() && m_traces.first().times[ProcessingStart] + TRACE_TIMEOUT <= time) {
+        complete(m_traces.first());
+        m_traces.erase(m_traces.begin());
+    }
+}
+
+void LatencyTrace::complete(const Trace &trace)
+{
+    for (int i = 1; i < STAGE_COUNT; i++) {
+        const qint64 time = trace.times[i];
+        const qint64 previous = trace.times[PREVIOUS_STAGE[i]];
+        if (time != -1 && previous != -1) {
+            m_histograms[i].add(time - previous);
+        }
+    }
+    // the total latency is only known once the commands have left
+    const qint64 end = (trace.times[RadioSent] != -1) ? trace.times[RadioSent] : trace.times[RadioQueued];
+    if (trace.times[VisionReceived] != -1 && end != -1) {
+        m_histograms[0].add(end - trace.times[VisionReceived]);
+    }
+
+    const bool incomplete = std::find(trace.times.begin(), trace.times.end(), -1) != trace.times.end();
+    if (m_exportFile.isOpen() && !incomplete) {
+        QTextStream stream(&m_exportFile);
+        for (int i = 0; i < STAGE_COUNT; i++) {
+            if (i > 0) {
+                stream << ",";
+            }
+            stream << trace.times[i];
+        }
+        stream << "\n";
+    }
+}
+
+void LatencyTrace::writeStatistics(amun::DebugValues *debug, qint64 time)
+{
+    QMutexLocker locker(&m_mutex);
+    if (time >= m_windowStart + STATISTICS_WINDOW) {
+        m_windowStart = time;
+        for (LatencyHistogram &histogram : m_histograms) {
+            histogram.finishWindow();
+        }
+    }
+    // stages which were not reached, e.g. without a strategy or radio, are left out
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        if (m_histograms[i].windowCount() == 0) {
+            continue;
+        }
+        const QString prefix = (i == 0) ? QString("Latency trace/total") : QString("Latency trace/%1 %2").arg(i).arg(STAGE_NAMES[i]);
+        m_histograms[i].writeWindow(debug, prefix);
+    }
+}
+
+bool LatencyTrace::setExportFile(const QString &filename)
+{
+    QMutexLocker locker(&m_mutex);
+    m_exportFile.close();
+    if (filename.isEmpty()) {
+        return true;
+    }
+    m_exportFile.setFileName(filename);
+    if (!m_exportFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return false;
+    }
+    QTextStream stream(&m_exportFile);
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        if (i > 0) {
+            stream << ",";
+        }
+        stream << QString(STAGE_NAMES[i]).replace(' ', '_');
+    }
+    stream << "\n";
+    return true;
+}
@@ -69,6 +69,26 @@ void RNG::seed(uint32_t s)
     }
 }
 
+/*!
+ * \brief Read the complete generator state
+ */
+void RNG::state(uint32_t &s1, uint32_t &s2, uint32_t &s3) const
+{
+    s1 = m_s1;
+    s2 = m_s2;
+    s3 = m_s3;
+}
+
+/*!
+ * \brief Continue with a state previously read using \ref state
+ */
+void RNG::setState(uint32_t s1, uint32_t s2, uint32_t s3)
+{
+    m_s1 = s1;
+    m_s2 = s2;
+    m_s3 = s3;
+}
+
 /*!
  * \brief Generate a random integer in the range [0, 2^32-1]
  * \return A random number drawn from a uniform distribution [0, 2^32-1]
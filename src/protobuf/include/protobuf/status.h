@@ -59,6 +59,17 @@ public:
             return m_arenaStatus;
     }
 
+    // keeps other alive for the lifetime of this status
+    // this allows referencing messages of other without copying them
+    // only possible if this status is allocated on an arena
+    bool keepAlive(const Status &other) const {
+        if (m_arena.isNull()) {
+            return false;
+        }
+        m_arena->Own(new Status(other));
+        return true;
+    }
+
     static Status createArena() {
         google::protobuf::ArenaOptions options;
         options.initial_block_size = 512;
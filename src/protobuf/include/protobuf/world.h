@@ -0,0 +1,30 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "protobuf/world.pb.h"
+
+// creates a shallow copy of source without the vision frames, which references the messages of source.
+// target has to be allocated on an arena, source must outlive target and must not be modified meanwhile.
+// The robots of a team and the ball are optionally taken from the simple tracking
+void referenceWorldState(world::State *target, const world::State &source, bool simpleYellow, bool simpleBlue, bool simpleBall);
+
+#endif // WORLD_H
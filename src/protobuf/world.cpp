@@ -0,0 +1,78 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "world.h"
+#include <cassert>
+
+template <typename T>
+static void referenceMessages(google::protobuf::RepeatedPtrField<T> *target, const google::protobuf::RepeatedPtrField<T> &source)
+{
+    target->Reserve(source.size());
+    for (const T &message : source) {
+        target->UnsafeArenaAddAllocated(const_cast<T*>(&message));
+    }
+}
+
+template <typename T>
+static T *referenceMessage(const T &message)
+{
+    return const_cast<T*>(&message);
+}
+
+void referenceWorldState(world::State *target, const world::State &source, bool simpleYellow, bool simpleBlue, bool simpleBall)
+{
+    // every field except the vision frames has to be handled below
+    assert(world::State::descriptor()->field_count() == 17);
+    assert(target->GetArena() != nullptr);
+
+    target->set_time(source.time());
+    const world::Ball *ball = simpleBall ? (source.has_simple_tracking_ball() ? &source.simple_tracking_ball() : nullptr)
+                                         : (source.has_ball() ? &source.ball() : nullptr);
+    if (ball) {
+        target->unsafe_arena_set_allocated_ball(referenceMessage(*ball));
+    }
+    referenceMessages(target->mutable_yellow(), simpleYellow ? source.simple_tracking_yellow() : source.yellow());
+    referenceMessages(target->mutable_blue(), simpleBlue ? source.simple_tracking_blue() : source.blue());
+    referenceMessages(target->mutable_radio_response(), source.radio_response());
+    if (source.has_is_simulated()) {
+        target->set_is_simulated(source.is_simulated());
+    }
+    if (source.has_has_vision_data()) {
+        target->set_has_vision_data(source.has_vision_data());
+    }
+    if (source.has_mixed_team_info()) {
+        target->unsafe_arena_set_allocated_mixed_team_info(referenceMessage(source.mixed_team_info()));
+    }
+    if (source.has_tracking_aoi()) {
+        target->unsafe_arena_set_allocated_tracking_aoi(referenceMessage(source.tracking_aoi()));
+    }
+    referenceMessages(target->mutable_simple_tracking_yellow(), source.simple_tracking_yellow());
+    referenceMessages(target->mutable_simple_tracking_blue(), source.simple_tracking_blue());
+    if (source.has_simple_tracking_ball()) {
+        target->unsafe_arena_set_allocated_simple_tracking_ball(referenceMessage(source.simple_tracking_ball()));
+    }
+    referenceMessages(target->mutable_reality(), source.reality());
+    target->mutable_vision_frame_times()->CopyFrom(source.vision_frame_times());
+    if (source.has_system_delay()) {
+        target->set_system_delay(source.system_delay());
+    }
+    if (source.has_world_source()) {
+        target->set_world_source(source.world_source());
+    }
+}
@@ -29,6 +29,7 @@
 #include <QDebug>
 
 const uint DEFAULT_SYSTEM_DELAY = 30; // in ms
+const bool DEFAULT_VISION_TRIGGERED = false;
 const uint DEFAULT_TRANSCEIVER_CHANNEL = 11;
 const uint DEFAULT_VISION_PORT = SSL_VISION_PORT;
 const uint DEFAULT_REFEREE_PORT = SSL_GAME_CONTROLLER_PORT;
@@ -142,6 +143,7 @@ void ConfigDialog::sendConfiguration()
 
     // from ms to ns
     command->mutable_tracking()->set_system_delay(ui->systemDelayBox->value() * 1000 * 1000);
+    command->mutable_tracking()->set_vision_triggered(ui->visionTriggeredBox->isChecked());
 
     command->mutable_amun()->set_vision_port(ui->visionPort->value());
     command->mutable_amun()->set_referee_port(ui->refPort->value());
@@ -223,6 +225,7 @@ void ConfigDialog::load()
     QSettings s;
     ui->comboChannel->setCurrentIndex(s.value("Transceiver/Channel", DEFAULT_TRANSCEIVER_CHANNEL).toUInt());
     ui->systemDelayBox->setValue(s.value("Tracking/SystemDelay", DEFAULT_SYSTEM_DELAY).toUInt()); // in ms
+    ui->visionTriggeredBox->setChecked(s.value("Tracking/VisionTriggered", DEFAULT_VISION_TRIGGERED).toBool());
 
     ui->visionPort->setValue(s.value("Amun/VisionPort2018", DEFAULT_VISION_PORT).toUInt());
     ui->refPort->setValue(s.value("Amun/RefereePort", DEFAULT_REFEREE_PORT).toUInt());
@@ -280,6 +283,7 @@ void ConfigDialog::reset()
 {
     ui->comboChannel->setCurrentIndex(DEFAULT_TRANSCEIVER_CHANNEL);
     ui->systemDelayBox->setValue(DEFAULT_SYSTEM_DELAY);
+    ui->visionTriggeredBox->setChecked(DEFAULT_VISION_TRIGGERED);
     ui->visionPort->setValue(DEFAULT_VISION_PORT);
     ui->refPort->setValue(DEFAULT_REFEREE_PORT);
     ui->networkUse->setChecked(DEFAULT_NETWORK_ENABLE);
@@ -307,6 +311,7 @@ void ConfigDialog::apply()
     QSettings s;
     s.setValue("Transceiver/Channel", ui->comboChannel->currentIndex());
     s.setValue("Tracking/SystemDelay", ui->systemDelayBox->value());
+    s.setValue("Tracking/VisionTriggered", ui->visionTriggeredBox->isChecked());
 
     s.setValue("Amun/VisionPort2018", ui->visionPort->value());
     s.setValue("Amun/RefereePort", ui->refPort->value());
@@ -380,6 +380,9 @@ void LogProcessor::removeDebugOutput(Status& status)
     if (m_options & CutDebugTree) {
         for (auto& debug : *status->mutable_debug()) {
             debug.clear_value();
+            debug.clear_debug_key();
+            debug.clear_handle_value();
+            debug.clear_profile();
         }
     }
     if (m_options & CutLogOutput) {
@@ -21,6 +21,7 @@
 #include "debugmodel.h"
 #include <QSet>
 #include <QStringBuilder>
+#include <algorithm>
 
 class DebugModel::Entry {
 public:
@@ -83,6 +84,7 @@ bool DebugModel::hasItems() const
 
 void DebugModel::clearData()
 {
+    m_profiles.clear();
     for (int sourceId: m_itemRoots.keys()) {
         amun::DebugValues debug;
         debug.set_source((amun::DebugSource)sourceId);
@@ -111,6 +113,7 @@ void DebugModel::setDebug(const amun::DebugValues &debug, const QSet<QString> &d
             it.value() = -1;
             amun::DebugValues debug;
             debug.set_source((amun::DebugSource)it.key());
+            m_profiles.remove(it.key());
             setDebug(debug, QSet<QString>(), false);
         }
     }
@@ -126,59 +129,140 @@ void DebugModel::setDebug(const amun::DebugValues &debug, const QSet<QString> &d
 
     for (int i = 0; i < debug.value_size(); i++) {
         const amun::DebugValue &value = debug.value(i);
-
-        QString v; // convert to string
-        if (value.has_bool_value()) {
-            v = QVariant(value.bool_value()).toString();
-        } else if (value.has_float_value()) {
-            v = QString::number(value.float_value());
-        } else if (value.has_string_value()) {
-            v = QString::fromStdString(value.string_value());
-        }
-
         // strategy specific key
         const QString keys = parentItem->text() % "/" % QString::fromStdString(value.key());
-        Entry *entry = m_entryMap.value(keys, NULL);
-        // key not cached yet
-        if (entry == NULL) {
-            // split key and create all parent items
-            QStringList key = keys.split("/", QString::SkipEmptyParts);
-
-            QStandardItem *parent = parentItem;
-            QString name = key.takeFirst();
-
-            Map *m = &map;
-            foreach (const QString &k, key) {
-                name = name % "/" % k;
-
-                entry = m->value(k, NULL);
-                if (entry == NULL) {
-                    // allocate manually to allow using a lookup table
-                    entry = new Entry(k, name);
-                    (*m)[k] = entry; // add to tree
-                    m_entryMap[name] = entry; // add to map
-                    parent->appendRow(QList<QStandardItem*>() << entry->name << entry->value);
-
-                    if (debug_expanded.contains(name)) {
-                        emit expand(entry->name->index());
-                    }
-                }
+        setEntry(keys, valueString(value), map, parentItem, debug_expanded, entries);
+    }
 
-                parent = entry->name;
-                m = &entry->children;
+    setDebugKeys(debug);
+    if (debug.handle_value_size() > 0) {
+        const QVector<QString> keyTable = m_debugKeys.value(debug.source());
+        int unresolved = 0;
+        for (const amun::DebugHandleValue &value : debug.handle_value()) {
+            if (value.handle() >= (uint)keyTable.size() || keyTable[value.handle()].isNull()) {
+                unresolved++;
+                continue;
             }
+            setEntry(keyTable[value.handle()], valueString(value), map, parentItem, debug_expanded, entries);
         }
-
-        // prevent crash on invalid key
-        if (entry != NULL) {
-            entries.insert(entry); // entry is valid
-            entry->value->setText(v); // already checks whether the value is changed
+        // the key table is repeated once per second, until then the values can't be shown
+        if (unresolved > 0) {
+            setEntry(parentItem->text() % "/<unknown debug keys>", QString::number(unresolved),
+                     map, parentItem, debug_expanded, entries);
         }
     }
+
+    if (debug.has_profile()) {
+        m_profiles[debug.source()] = debug.profile();
+    }
+    if (content && m_profiles.contains(debug.source())) {
+        setProfileEntries(m_profiles[debug.source()], map, parentItem, debug_expanded, entries);
+    }
+
     // remove outdated items
     testMap(map, entries, false);
 }
 
+void DebugModel::setProfileEntries(const amun::StrategyProfile &profile, Map &map, QStandardItem *parentItem,
+                                   const QSet<QString> &debug_expanded, QSet<Entry*> &entries)
+{
+    if (profile.total_time() <= 0) {
+        return;
+    }
+    // functions are sorted by their self time
+    const int count = std::min(profile.function_size(), PROFILE_FUNCTION_COUNT);
+    for (int i = 0; i < count; i++) {
+        const amun::ProfileFunction &function = profile.function(i);
+        QString name = QString::fromStdString(function.name());
+        if (function.has_line()) {
+            name += ":" % QString::number(function.line());
+        }
+        // slashes would be interpreted as key separator
+        name.replace('/', '.');
+        const QString key = parentItem->text() % "/Profile/" % QString("%1").arg(i, 2, 10, QChar('0')) % " " % name;
+        const QString value = QString("%1% self, %2% total")
+                .arg(100 * function.self_time() / profile.total_time(), 0, 'f', 1)
+                .arg(100 * function.total_time() / profile.total_time(), 0, 'f', 1);
+        setEntry(key, value, map, parentItem, debug_expanded, entries);
+    }
+}
+
+/*!
+ * \brief Updates the key table used to resolve the handle values of a debug source
+ *
+ * The table is only part of some of the debug values. As the debug tree does not show
+ * every status, this has to be called for each one.
+ */
+void DebugModel::setDebugKeys(const amun::DebugValues &debug)
+{
+    QStandardItem *parentItem = m_itemRoots.value(debug.source());
+    if (parentItem == nullptr || debug.debug_key_size() == 0) {
+        return;
+    }
+    QVector<QString> &keyTable = m_debugKeys[debug.source()];
+    keyTable.clear();
+    for (const amun::DebugKey &key : debug.debug_key()) {
+        if (key.handle() >= (uint)keyTable.size()) {
+            keyTable.resize(key.handle() + 1);
+        }
+        keyTable[key.handle()] = parentItem->text() % "/" % QString::fromStdString(key.key());
+    }
+}
+
+template<typename DebugValueType>
+QString DebugModel::valueString(const DebugValueType &value)
+{
+    if (value.has_bool_value()) {
+        return QVariant(value.bool_value()).toString();
+    } else if (value.has_float_value()) {
+        return QString::number(value.float_value());
+    } else if (value.has_string_value()) {
+        return QString::fromStdString(value.string_value());
+    }
+    return QString();
+}
+
+void DebugModel::setEntry(const QString &keys, const QString &value, Map &map, QStandardItem *parentItem,
+                          const QSet<QString> &debug_expanded, QSet<Entry*> &entries)
+{
+    Entry *entry = m_entryMap.value(keys, NULL);
+    // key not cached yet
+    if (entry == NULL) {
+        // split key and create all parent items
+        QStringList key = keys.split("/", QString::SkipEmptyParts);
+
+        QStandardItem *parent = parentItem;
+        QString name = key.takeFirst();
+
+        Map *m = &map;
+        foreach (const QString &k, key) {
+            name = name % "/" % k;
+
+            entry = m->value(k, NULL);
+            if (entry == NULL) {
+                // allocate manually to allow using a lookup table
+                entry = new Entry(k, name);
+                (*m)[k] = entry; // add to tree
+                m_entryMap[name] = entry; // add to map
+                parent->appendRow(QList<QStandardItem*>() << entry->name << entry->value);
+
+                if (debug_expanded.contains(name)) {
+                    emit expand(entry->name->index());
+                }
+            }
+
+            parent = entry->name;
+            m = &entry->children;
+        }
+    }
+
+    // prevent crash on invalid key
+    if (entry != NULL) {
+        entries.insert(entry); // entry is valid
+        entry->value->setText(value); // already checks whether the value is changed
+    }
+}
+
 void DebugModel::testMap(DebugModel::Map &map, const QSet<Entry*> &entries, bool parentMatched)
 {
     QMutableHashIterator<QString, Entry*> it(map);
@@ -24,6 +24,7 @@
 #include "protobuf/status.pb.h"
 #include <QStandardItemModel>
 #include <QRegularExpression>
+#include <QVector>
 
 class DebugModel : public QStandardItemModel
 {
@@ -42,6 +43,7 @@ public:
     void clearData();
     void setDebugIfCurrent(const amun::DebugValues &debug, const QSet<QString> &debug_expanded);
     void setDebug(const amun::DebugValues &debug, const QSet<QString> &debug_expanded, bool content = true);
+    void setDebugKeys(const amun::DebugValues &debug);
     void setFilterRegEx(const QString &filterKey, const QString &filterValue);
     bool hasItems() const;
 
@@ -50,17 +52,28 @@ private:
     class Entry;
     typedef QHash<QString, Entry*> Map;
     void testMap(Map &map, const QSet<Entry*> &entries, bool parentMatched);
+    void setEntry(const QString &keys, const QString &value, Map &map, QStandardItem *parentItem,
+                  const QSet<QString> &debug_expanded, QSet<Entry*> &entries);
+    template<typename DebugValueType>
+    static QString valueString(const DebugValueType &value);
+    void setProfileEntries(const amun::StrategyProfile &profile, Map &map, QStandardItem *parentItem,
+                           const QSet<QString> &debug_expanded, QSet<Entry*> &entries);
 
 private:
     QHash<int, QStandardItem*> m_itemRoots;
     QHash<int, int> m_debugSourceCounter;
     Map m_entryMap;
     QHash<int, Map> m_debug;
+    // full keys, indexed by the handle of the debug key
+    QHash<int, QVector<QString>> m_debugKeys;
+    // the profile is only sent once per second, but has to be shown continuously
+    QHash<int, amun::StrategyProfile> m_profiles;
     bool m_filterKey, m_filterValue;
     QRegularExpression m_filterKeyExpression;
     QRegularExpression m_filterValueExpression;
 
     const int DEBUG_SOURCE_TIMEOUT = 50;
+    const int PROFILE_FUNCTION_COUNT = 20;
 };
 
 #endif // DEBUGMODEL_H
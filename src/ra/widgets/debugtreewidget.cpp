@@ -91,6 +91,9 @@ void DebugTreeWidget::setFilterRegEx(const QString &keyFilter, const QString &va
 void DebugTreeWidget::handleStatus(const Status &status)
 {
     for (const auto& debug : status->debug()) {
+        // only the latest status per source is shown, which may lack the key table
+        m_modelTree->setDebugKeys(debug);
+
         // save data for delayed update
         m_status[debug.source()] = status;
         m_guiTimer->requestTriggering();
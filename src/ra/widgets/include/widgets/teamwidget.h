@@ -69,6 +69,7 @@ private slots:
     void sendEnableDebug(bool enable);
     void sendTriggerDebug();
     void sendPerformanceDebug(bool enable);
+    void sendContinuousProfiling(bool enable);
 
 private:
     void open(const QString &filename);
@@ -93,6 +94,7 @@ private:
     QAction *m_reloadAction;
     QAction *m_debugAction;
     QAction *m_performanceAction;
+    QAction *m_profilingAction;
     bool m_userAutoReload;
     bool m_notification;
     bool m_compiling;
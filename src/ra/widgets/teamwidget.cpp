@@ -125,6 +125,10 @@ void TeamWidget::init(amun::StatusStrategyWrapper::StrategyType type)
     m_performanceAction->setChecked(true);
     connect(m_performanceAction, SIGNAL(toggled(bool)), SLOT(sendPerformanceDebug(bool)));
 
+    m_profilingAction = reload_menu->addAction("Continuous profiling");
+    m_profilingAction->setCheckable(true);
+    connect(m_profilingAction, SIGNAL(toggled(bool)), SLOT(sendContinuousProfiling(bool)));
+
     m_btnReload = new QToolButton;
     m_btnReload->setToolTip("Reload script");
     m_btnReload->setIcon(QIcon("icon:32/view-refresh.png"));
@@ -162,6 +166,7 @@ void TeamWidget::enableContent(bool enable)
     m_btnEnableDebug->setEnabled(enable && m_type != amun::StatusStrategyWrapper::AUTOREF);
     m_debugAction->setEnabled(enable);
     m_performanceAction->setEnabled(enable);
+    m_profilingAction->setEnabled(enable);
     m_contentEnabled = enable;
 }
 
@@ -505,6 +510,15 @@ void TeamWidget::sendPerformanceDebug(bool enable)
     emit sendCommand(command);
 }
 
+void TeamWidget::sendContinuousProfiling(bool enable)
+{
+    Command command(new amun::Command);
+    amun::CommandStrategy *strategy = commandStrategyFromType(command);
+
+    strategy->set_continuous_profiling(enable);
+    emit sendCommand(command);
+}
+
 void TeamWidget::updateStyleSheet()
 {
     // update background and border color
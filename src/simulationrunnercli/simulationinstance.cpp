@@ -0,0 +1,197 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "simulationinstance.h"
+#include "amun/commandconverter.h"
+#include "gamecontroller/strategygamecontrollermediator.h"
+#include "processor/processor.h"
+#include "protobuf/ssl_referee.h"
+#include "seshat/logfilewriter.h"
+#include "simulator/fastsimulator.h"
+#include "simulator/simulator.h"
+#include "strategy/strategy.h"
+
+#include <QDir>
+#include <QElapsedTimer>
+#include <algorithm>
+
+static const QString SENDER_NAME_FOR_REFEREE = "SimulationRunner";
+// simulated time between two referee packets, the game controller sends them at about 10 Hz
+static const qint64 REFEREE_INTERVAL = 100 * 1000 * 1000LL;
+
+SimulationInstance::SimulationInstance(const SimulationSetup &setup, int index, quint32 seed, CompilerRegistry *registry) :
+    m_setup(setup),
+    m_compilerRegistry(registry),
+    m_nextRefereeTime(0)
+{
+    m_metrics.index = index;
+    m_metrics.seed = seed;
+
+    // same start as in the simulator tests, the fast simulator requires a stopped timer
+    m_timer.setScaling(0);
+    m_timer.setTime(1234, 0);
+    m_startTime = m_timer.currentTime();
+
+    if (!setup.recordDirectory.isEmpty()) {
+        m_logWriter.reset(new LogFileWriter);
+        const QString filename = QDir(setup.recordDirectory).filePath(QString("instance-%1.log").arg(index));
+        if (!m_logWriter->open(filename)) {
+            m_metrics.error = "could not open " + filename;
+            m_logWriter.reset();
+        }
+    }
+
+    m_simulator.reset(new camun::simulator::Simulator(&m_timer, setup.command.simulator().simulator_setup(), true));
+    m_simulator->seedPRGN(seed);
+    m_processor.reset(new Processor(&m_timer, true));
+    m_commandConverter.reset(new CommandConverter(&m_timer));
+
+    // all objects live on the calling thread, so every connection is direct
+    QObject::connect(m_simulator.get(), &camun::simulator::Simulator::gotPacket, m_processor.get(), &Processor::handleVisionPacket);
+    QObject::connect(m_simulator.get(), &camun::simulator::Simulator::sendRealData, m_processor.get(), &Processor::handleSimulatorExtraVision);
+    QObject::connect(m_simulator.get(), &camun::simulator::Simulator::sendRadioResponses, m_processor.get(), &Processor::handleRadioResponses);
+    QObject::connect(m_processor.get(), &Processor::sendRadioCommands, m_commandConverter.get(), &CommandConverter::handleRadioCommands);
+    QObject::connect(m_commandConverter.get(), &CommandConverter::sendSSLSim, m_simulator.get(), &camun::simulator::Simulator::handleRadioCommands);
+    QObject::connect(m_processor.get(), &Processor::setFlipped, m_simulator.get(), &camun::simulator::Simulator::setFlipped);
+
+    if (m_logWriter) {
+        // the log writer is used as context to drop the status of the idle game controller thread
+        LogFileWriter *writer = m_logWriter.get();
+        QObject::connect(m_processor.get(), &Processor::sendStatus, writer, [this](const Status &status) { writeStatus(status); });
+        QObject::connect(m_simulator.get(), &camun::simulator::Simulator::sendStatus, writer, [this](const Status &status) { writeStatus(status); });
+        QObject::connect(m_commandConverter.get(), &CommandConverter::sendStatus, writer, [this](const Status &status) { writeStatus(status); });
+    }
+
+    if (setup.command.has_strategy_blue()) {
+        addStrategy(StrategyType::BLUE, m_metrics.blue);
+    }
+    if (setup.command.has_strategy_yellow()) {
+        addStrategy(StrategyType::YELLOW, m_metrics.yellow);
+    }
+
+    // the referee packets are injected directly, a game controller thread would break reproducibility
+    m_referee.set_packet_timestamp(0);
+    m_referee.set_stage(SSL_Referee::NORMAL_FIRST_HALF);
+    m_referee.set_stage_time_left(0);
+    m_referee.set_command(SSL_Referee::FORCE_START);
+    m_referee.set_command_counter(1);
+    m_referee.set_command_timestamp(0);
+    m_referee.set_blueteamonpositivehalf(true);
+    teamInfoSetDefault(m_referee.mutable_yellow());
+    teamInfoSetDefault(m_referee.mutable_blue());
+    if (setup.command.set_team_yellow().robot_size() > 0) {
+        m_referee.mutable_yellow()->set_goalkeeper(setup.command.set_team_yellow().robot(0).id());
+    }
+    if (setup.command.set_team_blue().robot_size() > 0) {
+        m_referee.mutable_blue()->set_goalkeeper(setup.command.set_team_blue().robot(0).id());
+    }
+
+    const Command command(new amun::Command(setup.command));
+    m_simulator->handleCommand(command);
+    m_processor->handleCommand(command);
+    m_commandConverter->handleCommand(command);
+    // loads the strategies, which is synchronous as they were already compiled
+    for (auto &strategy : m_strategies) {
+        strategy->handleCommand(command);
+    }
+}
+
+SimulationInstance::~SimulationInstance() = default;
+
+void SimulationInstance::addStrategy(StrategyType type, StrategyMetrics &metrics)
+{
+    const bool blue = type == StrategyType::BLUE;
+    m_gameControllerConnections.push_back(std::make_shared<StrategyGameControllerMediator>(false));
+    m_strategies.emplace_back(new Strategy(&m_timer, type, nullptr, m_compilerRegistry, m_gameControllerConnections.back()));
+    Strategy *strategy = m_strategies.back().get();
+
+    QObject::connect(m_processor.get(), &Processor::sendStrategyStatus, strategy, &Strategy::handleStatus);
+    QObject::connect(m_processor.get(), &Processor::setFlipped, strategy, &Strategy::setFlipped);
+    QObject::connect(strategy, &Strategy::sendStrategyCommands, m_processor.get(), &Processor::handleStrategyCommands);
+    QObject::connect(strategy, &Strategy::sendHalt, m_processor.get(), &Processor::handleStrategyHalt);
+    QObject::connect(strategy, &Strategy::sendStatus, strategy, [this, blue, &metrics](const Status &status) {
+        handleStrategyStatus(status, blue, metrics);
+        writeStatus(status);
+    });
+}
+
+void SimulationInstance::handleStrategyStatus(const Status &status, bool blue, StrategyMetrics &metrics)
+{
+    if (status->has_timing()) {
+        const amun::Timing &timing = status->timing();
+        if (blue ? timing.has_blue_total() : timing.has_yellow_total()) {
+            const double time = blue ? timing.blue_total() : timing.yellow_total();
+            metrics.runs++;
+            metrics.totalTime += time;
+            metrics.maxTime = std::max(metrics.maxTime, time);
+        }
+    }
+    if (status->has_status_strategy() && status->status_strategy().status().state() == amun::StatusStrategy::FAILED) {
+        if (metrics.failures == 0) {
+            metrics.firstFailure = (m_timer.currentTime() - m_startTime) * 1E-9;
+        }
+        metrics.failures++;
+    }
+}
+
+void SimulationInstance::writeStatus(const Status &status)
+{
+    if (!m_logWriter) {
+        return;
+    }
+    status->set_time(m_timer.currentTime());
+    m_logWriter->writeStatus(status);
+}
+
+void SimulationInstance::sendReferee(qint64 time)
+{
+    QByteArray data(m_referee.ByteSize(), 0);
+    if (m_referee.SerializeToArray(data.data(), data.size())) {
+        m_processor->handleRefereePacket(data, time, SENDER_NAME_FOR_REFEREE);
+    }
+}
+
+void SimulationInstance::step()
+{
+    const qint64 now = m_timer.currentTime();
+    if (now >= m_nextRefereeTime) {
+        sendReferee(now);
+        m_nextRefereeTime = now + REFEREE_INTERVAL;
+    }
+    m_processor->process();
+    // the strategies are not run by their idle timers as this thread has no event loop
+    for (auto &strategy : m_strategies) {
+        strategy->tryProcess();
+    }
+}
+
+InstanceMetrics SimulationInstance::run()
+{
+    QElapsedTimer elapsed;
+    elapsed.start();
+    // calls step every 10 ms simulated time, which matches the processor frequency
+    FastSimulator::goDeltaCallback(m_simulator.get(), &m_timer, m_setup.duration, [this]() { step(); });
+    m_metrics.wallTime = elapsed.nsecsElapsed() * 1E-9;
+    m_metrics.simulatedTime = (m_timer.currentTime() - m_startTime) * 1E-9;
+    if (m_logWriter) {
+        m_logWriter->close();
+    }
+    return m_metrics;
+}
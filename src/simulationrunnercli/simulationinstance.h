@@ -0,0 +1,125 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#ifndef SIMULATIONINSTANCE_H
+#define SIMULATIONINSTANCE_H
+
+#include "core/timer.h"
+#include "protobuf/command.h"
+#include "protobuf/ssl_referee.pb.h"
+#include "protobuf/status.h"
+#include "strategy/script/strategytype.h"
+#include <QString>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+class CommandConverter;
+class CompilerRegistry;
+class LogFileWriter;
+class Processor;
+class Strategy;
+class StrategyGameControllerMediator;
+namespace camun {
+    namespace simulator {
+        class Simulator;
+    }
+}
+
+// shared by all instances and only read while running
+struct SimulationSetup
+{
+    // simulator, team and strategy configuration, sent to every component at the start
+    amun::Command command;
+    qint64 duration = 0;
+    // no logs are written if empty
+    QString recordDirectory;
+};
+
+struct StrategyMetrics
+{
+    int runs = 0;
+    // in seconds
+    double totalTime = 0;
+    double maxTime = 0;
+    int failures = 0;
+    // simulated seconds until the first failure, negative if the strategy never failed
+    double firstFailure = -1;
+
+    void merge(const StrategyMetrics &other)
+    {
+        runs += other.runs;
+        totalTime += other.totalTime;
+        maxTime = std::max(maxTime, other.maxTime);
+        failures += other.failures;
+        if (other.firstFailure >= 0 && (firstFailure < 0 || other.firstFailure < firstFailure)) {
+            firstFailure = other.firstFailure;
+        }
+    }
+
+    double meanTime() const { return runs > 0 ? totalTime / runs : 0; }
+};
+
+struct InstanceMetrics
+{
+    int index = 0;
+    quint32 seed = 0;
+    double simulatedTime = 0;
+    double wallTime = 0;
+    StrategyMetrics blue;
+    StrategyMetrics yellow;
+    QString error;
+};
+
+// a complete simulator, processor and strategy stack which runs as fast as possible on the calling thread
+class SimulationInstance
+{
+public:
+    SimulationInstance(const SimulationSetup &setup, int index, quint32 seed, CompilerRegistry *registry);
+    ~SimulationInstance();
+    SimulationInstance(const SimulationInstance&) = delete;
+    SimulationInstance& operator=(const SimulationInstance&) = delete;
+
+    InstanceMetrics run();
+
+private:
+    void addStrategy(StrategyType type, StrategyMetrics &metrics);
+    void handleStrategyStatus(const Status &status, bool blue, StrategyMetrics &metrics);
+    void writeStatus(const Status &status);
+    void sendReferee(qint64 time);
+    void step();
+
+private:
+    const SimulationSetup &m_setup;
+    CompilerRegistry *m_compilerRegistry;
+    Timer m_timer;
+    qint64 m_startTime;
+    std::unique_ptr<LogFileWriter> m_logWriter;
+    std::unique_ptr<camun::simulator::Simulator> m_simulator;
+    std::unique_ptr<Processor> m_processor;
+    std::unique_ptr<CommandConverter> m_commandConverter;
+    std::vector<std::shared_ptr<StrategyGameControllerMediator>> m_gameControllerConnections;
+    std::vector<std::unique_ptr<Strategy>> m_strategies;
+    SSL_Referee m_referee;
+    qint64 m_nextRefereeTime;
+    InstanceMetrics m_metrics;
+};
+
+#endif // SIMULATIONINSTANCE_H
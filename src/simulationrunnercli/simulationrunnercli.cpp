@@ -0,0 +1,256 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThreadPool>
+#include <clocale>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include "simulationinstance.h"
+#include "core/configuration.h"
+#include "gamecontroller/strategygamecontrollermediator.h"
+#include "strategy/strategy.h"
+#include "strategy/script/compilerregistry.h"
+
+namespace {
+
+class SimulationTask : public QRunnable
+{
+public:
+    SimulationTask(const SimulationSetup &setup, int index, quint32 seed, CompilerRegistry *registry, InstanceMetrics &metrics) :
+        m_setup(setup), m_index(index), m_seed(seed), m_registry(registry), m_metrics(metrics) {}
+
+    void run() override
+    {
+        // the instance has to be created on the thread it runs on
+        SimulationInstance instance(m_setup, m_index, m_seed, m_registry);
+        m_metrics = instance.run();
+    }
+
+private:
+    const SimulationSetup &m_setup;
+    const int m_index;
+    const quint32 m_seed;
+    CompilerRegistry *m_registry;
+    InstanceMetrics &m_metrics;
+};
+
+void addStrategyLoad(amun::CommandStrategy *strategy, const QString &initScript, const QString &entryPoint, bool debug)
+{
+    // debug output is only useful if it is recorded
+    strategy->set_enable_debug(debug);
+    auto *load = strategy->mutable_load();
+    load->set_filename(initScript.toStdString());
+    load->set_entry_point(entryPoint.toStdString());
+}
+
+void writeCsvRow(QTextStream &stream, const QString &name, const QString &seed, const InstanceMetrics &m)
+{
+    stream << name << "," << seed << "," << m.simulatedTime << "," << m.wallTime << ","
+           << (m.wallTime > 0 ? m.simulatedTime / m.wallTime : 0);
+    for (const StrategyMetrics *strategy : {&m.blue, &m.yellow}) {
+        stream << "," << strategy->runs << "," << strategy->meanTime() * 1000 << "," << strategy->maxTime * 1000 << ","
+               << strategy->failures << "," << (strategy->firstFailure >= 0 ? QString::number(strategy->firstFailure) : QString());
+    }
+    stream << "," << m.error << "\n";
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("Simulation-runner-CLI");
+    app.setOrganizationName("ER-Force");
+
+    std::setlocale(LC_NUMERIC, "C");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Runs many headless simulated games in parallel as fast as possible");
+    parser.addHelpOption();
+    parser.addPositionalArgument("strategy_file", "Strategy init script");
+    parser.addPositionalArgument("entrypoint", "Entrypoint to run");
+
+    QCommandLineOption strategyColorConfig({"c", "strategy-color"}, "Color(s) of the strategy to run, either yellow, blue or both, defaults to yellow", "color", "yellow");
+    QCommandLineOption instancesOption({"i", "instances"}, "Number of independent simulations, defaults to one", "count", "1");
+    QCommandLineOption jobsOption({"j", "jobs"}, "Number of simulations to run in parallel, defaults to the number of cores", "count");
+    QCommandLineOption simulationTime({"t", "simulation-time"}, "Number of seconds to simulate per instance, defaults to 60", "seconds", "60");
+    QCommandLineOption numberOfRobots({"n", "num-robots"}, "Number of robots to load per team. Defaults to zero", "num-robots", "0");
+    QCommandLineOption robotGenerationFile("robot-generation", "Robot generation to create the robots of", "generation");
+    QCommandLineOption simulatorConfig({"s", "simulator-config"}, "Which simulator config to use (field size etc.), loaded from the config directory", "file");
+    QCommandLineOption realismConfig("realism", "Simulator realism configuration (short file name without the .txt)", "realism");
+    QCommandLineOption seedOption("seed", "Simulator seed of the first instance, every further instance adds one. Defaults to 14986", "seed", "14986");
+    QCommandLineOption recordDirectory({"r", "record-directory"}, "Record every instance to instance-<index>.log in this directory", "directory");
+    QCommandLineOption outputOption({"o", "output"}, "Write the csv metrics to this file instead of stdout", "file");
+    parser.addOption(strategyColorConfig);
+    parser.addOption(instancesOption);
+    parser.addOption(jobsOption);
+    parser.addOption(simulationTime);
+    parser.addOption(numberOfRobots);
+    parser.addOption(robotGenerationFile);
+    parser.addOption(simulatorConfig);
+    parser.addOption(realismConfig);
+    parser.addOption(seedOption);
+    parser.addOption(recordDirectory);
+    parser.addOption(outputOption);
+
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 2) {
+        parser.showHelp(1);
+    }
+
+    const QStringList args = parser.positionalArguments();
+    const QString initScript = QDir(".").absoluteFilePath(args.at(0));
+    const QString entryPoint = args.at(1);
+    const QString strategyColor = parser.value(strategyColorConfig);
+
+    if (strategyColor != "yellow" && strategyColor != "blue" && strategyColor != "both") {
+        std::cerr <<"Invalid strategy color configuration "<<strategyColor.toStdString()<<std::endl;
+        exit(1);
+    }
+    const int instances = parser.value(instancesOption).toInt();
+    const int simulationSeconds = parser.value(simulationTime).toInt();
+    if (instances <= 0 || simulationSeconds <= 0) {
+        std::cerr <<"Instance count and simulation time must be positive!"<<std::endl;
+        exit(1);
+    }
+    const quint32 seed = parser.value(seedOption).toUInt();
+    const int numRobots = parser.value(numberOfRobots).toInt();
+    if (numRobots > 0 && !parser.isSet(robotGenerationFile)) {
+        std::cerr <<"Option robot-generation must be specified with a non-zero robot count"<<std::endl;
+        exit(1);
+    }
+
+    qRegisterMetaType<Status>("Status");
+    qRegisterMetaType<Command>("Command");
+
+    SimulationSetup setup;
+    setup.duration = simulationSeconds * 1000000000LL;
+    if (parser.isSet(recordDirectory)) {
+        setup.recordDirectory = parser.value(recordDirectory);
+        QDir(".").mkpath(setup.recordDirectory);
+    }
+
+    amun::Command &command = setup.command;
+    command.mutable_simulator()->set_enable(true);
+    if (parser.isSet(simulatorConfig)) {
+        if (!loadConfiguration("simulator/" + parser.value(simulatorConfig), command.mutable_simulator()->mutable_simulator_setup(), false)) {
+            exit(1);
+        }
+    } else {
+        simulatorSetupSetDefault(*command.mutable_simulator()->mutable_simulator_setup());
+    }
+    if (parser.isSet(realismConfig)) {
+        if (!loadConfiguration("simulator-realism/" + parser.value(realismConfig), command.mutable_simulator()->mutable_realism_config(), true)) {
+            exit(1);
+        }
+    }
+    // the referee packets are sent by the instances themselves
+    command.mutable_referee()->set_active(false);
+    command.mutable_transceiver()->set_enable(true);
+    command.mutable_transceiver()->set_charge(true);
+
+    if (numRobots > 0) {
+        robot::Generation gen;
+        if (!loadConfiguration("robots/" + parser.value(robotGenerationFile), &gen, true)) {
+            exit(1);
+        }
+        robot::Team *yellow = command.mutable_set_team_yellow();
+        robot::Team *blue = command.mutable_set_team_blue();
+        for (int i = 0;i<numRobots;i++) {
+            yellow->add_robot()->CopyFrom(gen.default_());
+            yellow->mutable_robot(i)->set_id(i);
+            blue->add_robot()->CopyFrom(gen.default_());
+            blue->mutable_robot(i)->set_id(i > 15 ? i : (15 - i));
+        }
+    }
+
+    const bool debug = !setup.recordDirectory.isEmpty();
+    if (strategyColor == "blue" || strategyColor == "both") {
+        addStrategyLoad(command.mutable_strategy_blue(), initScript, entryPoint, debug);
+    }
+    if (strategyColor == "yellow" || strategyColor == "both") {
+        addStrategyLoad(command.mutable_strategy_yellow(), initScript, entryPoint, debug);
+    }
+
+    // compile the strategy once before starting the instances, this also initializes v8 on the main thread
+    CompilerRegistry compilerRegistry;
+    Timer compileTimer;
+    compileTimer.setTime(0, 1.0);
+    auto connection = std::make_shared<StrategyGameControllerMediator>(false);
+    Strategy compileStrategy(&compileTimer, StrategyType::YELLOW, nullptr, &compilerRegistry, connection);
+    compileStrategy.compileIfNecessary(initScript);
+    // process all outstanding events before executing the strategy to avoid race conditions (otherwise, the compiler output may not be visible)
+    app.processEvents();
+
+    // every instance has its own timer and is seeded independently, thus the results do not depend on the scheduling
+    std::vector<InstanceMetrics> results(instances);
+    QThreadPool pool;
+    if (parser.isSet(jobsOption)) {
+        pool.setMaxThreadCount(std::max(1, parser.value(jobsOption).toInt()));
+    }
+    QElapsedTimer elapsed;
+    elapsed.start();
+    for (int i = 0; i < instances; i++) {
+        pool.start(new SimulationTask(setup, i, seed + i, &compilerRegistry, results[i]));
+    }
+    pool.waitForDone();
+
+    InstanceMetrics total;
+    total.wallTime = elapsed.nsecsElapsed() * 1E-9;
+    bool hasError = false;
+    for (const InstanceMetrics &metrics : results) {
+        total.simulatedTime += metrics.simulatedTime;
+        total.blue.merge(metrics.blue);
+        total.yellow.merge(metrics.yellow);
+        hasError |= !metrics.error.isEmpty();
+    }
+
+    QFile outputFile;
+    if (parser.isSet(outputOption)) {
+        outputFile.setFileName(parser.value(outputOption));
+        if (!outputFile.open(QFile::WriteOnly | QFile::Truncate)) {
+            qFatal("Error: could not open output file");
+        }
+    } else {
+        outputFile.open(stdout, QFile::WriteOnly);
+    }
+    QTextStream stream(&outputFile);
+
+    // the speed of the total row is the aggregate throughput in simulated seconds per wall clock second
+    stream << "instance,seed,simulated_s,wall_s,speed,"
+           << "blue_runs,blue_time_ms_mean,blue_time_ms_max,blue_failures,blue_first_failure_s,"
+           << "yellow_runs,yellow_time_ms_mean,yellow_time_ms_max,yellow_failures,yellow_first_failure_s,error\n";
+    for (const InstanceMetrics &metrics : results) {
+        writeCsvRow(stream, QString::number(metrics.index), QString::number(metrics.seed), metrics);
+    }
+    writeCsvRow(stream, "total", QString(), total);
+
+    return hasError ? 1 : 0;
+}
@@ -0,0 +1,92 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "amun/lockstepamun.h"
+#include "config/config.h"
+#include "core/configuration.h"
+#include "protobuf/command.h"
+#include "protobuf/status.h"
+
+#include <QCoreApplication>
+
+static Command createGameCommand()
+{
+    Command command(new amun::Command);
+    command->mutable_simulator()->set_enable(true);
+    // the noise and the dropped detections depend on the seed
+    loadConfiguration("cpptests/realism-realistic", command->mutable_simulator()->mutable_realism_config(), false);
+    command->mutable_transceiver()->set_enable(true);
+    command->mutable_transceiver()->set_charge(true);
+
+    robot::Generation specs;
+    loadConfiguration("cpptests/robots-generation-2020", &specs, true);
+    for (int i = 0;i<2;i++) {
+        auto robot = command->mutable_set_team_blue()->add_robot();
+        robot->CopyFrom(specs.default_());
+        robot->set_id(i);
+        robot = command->mutable_set_team_yellow()->add_robot();
+        robot->CopyFrom(specs.default_());
+        robot->set_id(i);
+    }
+
+    auto *load = command->mutable_strategy_blue()->mutable_load();
+    load->set_filename(ERFORCE_STRATEGYDIR + std::string("lua/demo/init.lua"));
+    load->set_entry_point("Demo");
+    return command;
+}
+
+// returns the serialized world states of the first steps
+static QList<std::string> runGame(quint32 seed, int steps)
+{
+    LockstepAmun amun(seed);
+    QList<std::string> worldStates;
+    amun.connect(&amun, &LockstepAmun::gotStatus, [&amun, &worldStates, steps](const Status &status) {
+        if (!status->has_world_state() || worldStates.size() >= steps) {
+            return;
+        }
+        worldStates.append(status->world_state().SerializeAsString());
+        if (worldStates.size() == steps) {
+            amun.stop();
+            QCoreApplication::exit(0);
+        }
+    });
+    amun.handleCommand(createGameCommand());
+    amun.start();
+    QCoreApplication::exec();
+    return worldStates;
+}
+
+TEST(LockstepAmun, SameSeedIsDeterministic) {
+    std::string appName = "unittest";
+    char* args[2] = {const_cast<char*>(appName.c_str()), nullptr};
+    int argCount = 1;
+    QCoreApplication app(argCount, args);
+
+    const int STEPS = 300;
+    const QList<std::string> first = runGame(14986, STEPS);
+    ASSERT_EQ(first.size(), STEPS);
+    const QList<std::string> second = runGame(14986, STEPS);
+    ASSERT_EQ(first, second);
+
+    // the seed is actually passed to the simulator
+    const QList<std::string> otherSeed = runGame(14987, STEPS);
+    ASSERT_EQ(otherSeed.size(), STEPS);
+    ASSERT_NE(first, otherSeed);
+}
@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "core/timer.h"
+#include "processor/processor.h"
+#include "processor/visioningestqueue.h"
+#include "protobuf/ssl_wrapper.pb.h"
+
+#include <QCoreApplication>
+#include <QThread>
+#include <memory>
+
+namespace {
+
+IngestedVisionFrame visionFrame(VisionFrameDecoder &decoder, const Timer &timer, quint32 cameraId, int frameNumber)
+{
+    const qint64 time = timer.currentTime();
+    SSL_WrapperPacket wrapper;
+    SSL_DetectionFrame *detection = wrapper.mutable_detection();
+    detection->set_frame_number(frameNumber);
+    detection->set_t_capture(time * 1E-9);
+    detection->set_t_sent(time * 1E-9);
+    detection->set_camera_id(cameraId);
+    QByteArray data(wrapper.ByteSize(), 0);
+    wrapper.SerializeToArray(data.data(), data.size());
+
+    IngestedVisionFrame ingested;
+    ingested.frame = decoder.decode(data, time, "test");
+    ingested.time = time;
+    return ingested;
+}
+
+}
+
+TEST(Processor, OneRadioCommandPerTick) {
+    std::string appName = "unittest";
+    char* args[2] = {const_cast<char*>(appName.c_str()), nullptr};
+    int argCount = 1;
+    QCoreApplication app(argCount, args);
+
+    Timer timer;
+    Processor processor(&timer, false);
+    int radioCommandCount = 0;
+    QObject::connect(&processor, &Processor::sendRadioCommands, [&radioCommandCount]() {
+        radioCommandCount++;
+    });
+
+    Command command(new amun::Command);
+    command->mutable_tracking()->set_vision_triggered(true);
+    command->mutable_transceiver()->set_enable(true);
+    processor.handleCommand(command);
+
+    auto queue = std::make_shared<VisionIngestQueue>();
+    processor.setVisionIngestQueue(queue);
+    VisionFrameDecoder decoder;
+
+    const int CAMERA_COUNT = 4;
+    int frameNumber = 0;
+    for (int tick = 1; tick <= 5; tick++) {
+        // more than the minimum period since the last tracking
+        QThread::msleep(5);
+        // two frames per camera, the complete sets only trigger the tracking
+        for (int i = 0; i < 2 * CAMERA_COUNT; i++) {
+            ASSERT_TRUE(queue->frames.push(visionFrame(decoder, timer, i % CAMERA_COUNT, frameNumber++)));
+        }
+        processor.handleIngestedFrames();
+        ASSERT_TRUE(queue->frames.empty());
+        ASSERT_EQ(radioCommandCount, tick - 1);
+
+        // the tick drains the frames which arrived in between, these must not trigger anything else
+        QThread::msleep(5);
+        for (int i = 0; i < 2 * CAMERA_COUNT; i++) {
+            ASSERT_TRUE(queue->frames.push(visionFrame(decoder, timer, i % CAMERA_COUNT, frameNumber++)));
+        }
+        processor.process();
+        ASSERT_TRUE(queue->frames.empty());
+        ASSERT_EQ(radioCommandCount, tick);
+    }
+}
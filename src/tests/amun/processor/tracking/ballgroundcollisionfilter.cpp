@@ -92,6 +92,8 @@ SimulationController::SimulationController(int predictTimeOffsetMs, RealismConfi
     m_timer.setScaling(0);
     m_timer.setTime(1234, 0);
     m_simulator.seedPRGN(14986);
+    // the checks compare the tracked ball at the reception time with the simulator truth of the same frame
+    m_simulator.setImmediateVisionDelivery(true);
     loadRobots(2, 0);
 
     world::BallModel ballModel;
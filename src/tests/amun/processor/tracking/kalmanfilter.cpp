@@ -0,0 +1,152 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "gtest/gtest.h"
+#include "core/rng.h"
+#include "tracking/kalmanfilter.h"
+
+#include <QElapsedTimer>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+struct Measurement {
+    double time;
+    Eigen::Vector3d position;
+};
+
+// simulated detections of a robot which drives along a curve, as seen by a single camera
+std::vector<Measurement> simulateVision(uint32_t seed, int count)
+{
+    RNG rng(seed);
+    std::vector<Measurement> result;
+    double time = 0;
+    for (int i = 0; i < count; i++) {
+        // the vision runs at roughly 75 Hz with some jitter
+        time += 0.0133 + rng.uniformFloat(-0.002f, 0.002f);
+        const double angle = 0.8 * time;
+        Measurement m;
+        m.time = time;
+        m.position(0) = 2.0 * std::cos(angle) + rng.normal(0.002);
+        m.position(1) = 1.5 * std::sin(angle) + rng.normal(0.002);
+        m.position(2) = angle + M_PI_2 + rng.normal(0.006);
+        result.push_back(m);
+    }
+    return result;
+}
+
+// same process model as the robot filter
+template <typename Kalman>
+void predict(Kalman &kalman, double timeDiff)
+{
+    kalman.F(0, 3) = timeDiff;
+    kalman.F(1, 4) = timeDiff;
+    kalman.F(2, 5) = timeDiff;
+    kalman.B = kalman.F;
+
+    const double sigmaA[3] = {4.0, 4.0, 10.0};
+    for (int i = 0; i < 3; i++) {
+        const double g0 = timeDiff * timeDiff / 2 * sigmaA[i];
+        const double g1 = timeDiff * sigmaA[i];
+        kalman.Q(i, i) = g0 * g0;
+        kalman.Q(i, i + 3) = g0 * g1;
+        kalman.Q(i + 3, i) = g1 * g0;
+        kalman.Q(i + 3, i + 3) = g1 * g1;
+    }
+    kalman.predict(true);
+}
+
+template <typename Kalman>
+std::vector<typename Kalman::Vector> runFilter(const std::vector<Measurement> &measurements)
+{
+    typename Kalman::Vector x = Kalman::Vector::Zero();
+    x(0) = measurements[0].position(0);
+    x(1) = measurements[0].position(1);
+    x(2) = measurements[0].position(2);
+    Kalman kalman(x);
+    kalman.H(0, 0) = 1;
+    kalman.H(1, 1) = 1;
+    kalman.H(2, 2) = 1;
+    kalman.R(0, 0) = 0.004 * 0.004;
+    kalman.R(1, 1) = 0.004 * 0.004;
+    kalman.R(2, 2) = 0.01 * 0.01;
+
+    std::vector<typename Kalman::Vector> states;
+    double lastTime = measurements[0].time;
+    for (const Measurement &m : measurements) {
+        predict(kalman, m.time - lastTime);
+        lastTime = m.time;
+        kalman.z(0) = m.position(0);
+        kalman.z(1) = m.position(1);
+        kalman.z(2) = m.position(2);
+        kalman.update();
+        states.push_back(kalman.baseState());
+    }
+    return states;
+}
+
+}
+
+TEST(KalmanFilter, FloatMatchesDouble) {
+    const std::vector<Measurement> measurements = simulateVision(42, 5000);
+    const auto reference = runFilter<KalmanFilter<6, 3>>(measurements);
+    const auto result = runFilter<KalmanFilter<6, 3, float>>(measurements);
+
+    ASSERT_EQ(reference.size(), result.size());
+    for (std::size_t i = 0; i < reference.size(); i++) {
+        for (int j = 0; j < 3; j++) {
+            ASSERT_NEAR(reference[i](j), result[i](j), 1E-4) << "position " << j << " at frame " << i;
+            ASSERT_NEAR(reference[i](j + 3), result[i](j + 3), 1E-2) << "speed " << j << " at frame " << i;
+        }
+    }
+}
+
+TEST(KalmanFilter, TracksRecordedVision) {
+    const std::vector<Measurement> measurements = simulateVision(7, 2000);
+    const auto result = runFilter<KalmanFilter<6, 3, float>>(measurements);
+
+    // the speed of the robot is known from the curve it follows
+    const Measurement &last = measurements.back();
+    const double angle = 0.8 * last.time;
+    const Eigen::Vector2d speed(-2.0 * 0.8 * std::sin(angle), 1.5 * 0.8 * std::cos(angle));
+    ASSERT_NEAR(result.back()(3), speed(0), 0.1);
+    ASSERT_NEAR(result.back()(4), speed(1), 0.1);
+    ASSERT_NEAR(result.back()(5), 0.8, 0.2);
+}
+
+// run with --gtest_also_run_disabled_tests
+TEST(KalmanFilter, DISABLED_Benchmark) {
+    const std::vector<Measurement> measurements = simulateVision(1, 100000);
+
+    QElapsedTimer timer;
+    timer.start();
+    const auto reference = runFilter<KalmanFilter<6, 3>>(measurements);
+    const qint64 doubleTime = timer.nsecsElapsed();
+
+    timer.restart();
+    const auto result = runFilter<KalmanFilter<6, 3, float>>(measurements);
+    const qint64 floatTime = timer.nsecsElapsed();
+
+    std::cout << "double: " << doubleTime / measurements.size() << " ns per frame" << std::endl;
+    std::cout << "float: " << floatTime / measurements.size() << " ns per frame" << std::endl;
+    ASSERT_EQ(reference.size(), result.size());
+}
@@ -0,0 +1,235 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "gtest/gtest.h"
+#include "core/rng.h"
+#include "tracking/recursiveleastsquares.h"
+
+#include <cmath>
+#include <vector>
+
+namespace {
+
+const float GRAVITY = 9.81f;
+
+// the full problem as it was solved by the fly filter before
+template <int DIM>
+class BatchLeastSquares
+{
+public:
+    void addObservation(const Eigen::Matrix<float, 1, DIM> &row, float value)
+    {
+        m_rows.push_back(row);
+        m_values.push_back(value);
+    }
+
+    Eigen::Matrix<float, DIM, 1> solve() const
+    {
+        Eigen::MatrixXf A(m_rows.size(), DIM);
+        Eigen::VectorXf b(m_rows.size());
+        for (std::size_t i = 0; i < m_rows.size(); i++) {
+            A.row(i) = m_rows[i];
+            b(i) = m_values[i];
+        }
+        return A.colPivHouseholderQr().solve(b);
+    }
+
+    float squaredError(const Eigen::Matrix<float, DIM, 1> &x) const
+    {
+        float error = 0;
+        for (std::size_t i = 0; i < m_rows.size(); i++) {
+            const float residual = m_rows[i].dot(x) - m_values[i];
+            error += residual * residual;
+        }
+        return error;
+    }
+
+private:
+    std::vector<Eigen::Matrix<float, 1, DIM>> m_rows;
+    std::vector<float> m_values;
+};
+
+struct Detection {
+    float time;
+    Eigen::Vector2f pos;
+};
+
+const Eigen::Vector3f CAMERA(0.5f, -0.3f, 4.0f);
+
+// detections of a chip on the ground plane as seen by a camera above the field
+std::vector<Detection> simulateChip(RNG &rng, const Eigen::Vector2f &startPos, const Eigen::Vector2f &groundSpeed,
+                                    float zSpeed, float startTime, float noise)
+{
+    std::vector<Detection> result;
+    const float flightDuration = 2 * zSpeed / GRAVITY;
+    for (float t = startTime; t < flightDuration; t += 1 / 75.0f) {
+        const Eigen::Vector2f ground = startPos + groundSpeed * t;
+        const Eigen::Vector3f ball(ground.x(), ground.y(), zSpeed * t - 0.5f * GRAVITY * t * t);
+        const float lambda = -CAMERA.z() / (CAMERA.z() - ball.z());
+        const Eigen::Vector3f projected = CAMERA + (CAMERA - ball) * lambda;
+        Detection d;
+        d.time = t;
+        d.pos = Eigen::Vector2f(projected.x() + rng.normal(noise), projected.y() + rng.normal(noise));
+        result.push_back(d);
+    }
+    return result;
+}
+
+// same observations as FlyFilter::calcPinv, the parameters are z0, vz, x0, vx, y0, vy at the first detection
+template <typename Solver>
+void addPinvObservations(Solver &solver, const Detection &d, float startTime)
+{
+    const float t = d.time - startTime;
+    const float alpha = (d.pos.x() - CAMERA.x()) / CAMERA.z();
+    const float beta = (d.pos.y() - CAMERA.y()) / CAMERA.z();
+    Eigen::Matrix<float, 1, 6> row;
+    row << alpha, alpha * t, 1, t, 0, 0;
+    solver.addObservation(row, 0.5f * GRAVITY * alpha * t * t + d.pos.x());
+    row << beta, beta * t, 0, 0, 1, t;
+    solver.addObservation(row, 0.5f * GRAVITY * beta * t * t + d.pos.y());
+}
+
+// same observations as FlyFilter::constrainedReconstruction, the parameters are vz, ground speed and z0
+template <typename Solver>
+void addConstrainedObservations(Solver &solver, const Detection &d, const Eigen::Vector2f &startPos,
+                                const Eigen::Vector2f &direction, float startTime)
+{
+    const float t = d.time - startTime;
+    const float alpha = (CAMERA.x() - d.pos.x()) / CAMERA.z();
+    const float beta = (CAMERA.y() - d.pos.y()) / CAMERA.z();
+    solver.addObservation(Eigen::RowVector3f(alpha * t, -direction.x() * t, alpha),
+                          0.5f * GRAVITY * alpha * t * t + startPos.x() - d.pos.x());
+    solver.addObservation(Eigen::RowVector3f(beta * t, -direction.y() * t, beta),
+                          0.5f * GRAVITY * beta * t * t + startPos.y() - d.pos.y());
+}
+
+}
+
+TEST(RecursiveLeastSquares, MatchesBatchSolution) {
+    RNG rng(3);
+    RecursiveLeastSquares<6> recursive;
+    BatchLeastSquares<6> batch;
+    for (int i = 0; i < 200; i++) {
+        Eigen::Matrix<float, 1, 6> row;
+        for (int j = 0; j < 6; j++) {
+            row(j) = rng.uniformFloat(-2, 2);
+        }
+        const float value = rng.uniformFloat(-5, 5);
+        recursive.addObservation(row, value);
+        batch.addObservation(row, value);
+        if (i < 6) {
+            continue;
+        }
+
+        const Eigen::Matrix<float, 6, 1> expected = batch.solve();
+        const Eigen::Matrix<float, 6, 1> result = recursive.solve();
+        for (int j = 0; j < 6; j++) {
+            ASSERT_NEAR(expected(j), result(j), 1E-3) << "parameter " << j << " after " << i << " observations";
+        }
+        ASSERT_NEAR(batch.squaredError(expected), recursive.squaredError(result), 1E-2 * batch.squaredError(expected));
+    }
+    ASSERT_EQ(recursive.observationCount(), 200);
+}
+
+TEST(RecursiveLeastSquares, ReconstructsChip) {
+    RNG rng(11);
+    const Eigen::Vector2f startPos(1.0f, 0.5f);
+    const Eigen::Vector2f groundSpeed(3.0f, 1.2f);
+    const float zSpeed = 4.0f;
+    const std::vector<Detection> detections = simulateChip(rng, startPos, groundSpeed, zSpeed, 0.02f, 0.001f);
+    const float startTime = detections[0].time;
+
+    RecursiveLeastSquares<6> recursive;
+    BatchLeastSquares<6> batch;
+    for (std::size_t i = 0; i < detections.size(); i++) {
+        addPinvObservations(recursive, detections[i], startTime);
+        addPinvObservations(batch, detections[i], startTime);
+        if (i < 3) {
+            continue;
+        }
+
+        // the fly filter adds the position bias to a copy of the accumulated observations
+        const float bias = 0.1f;
+        RecursiveLeastSquares<6> biased = recursive;
+        BatchLeastSquares<6> biasedBatch = batch;
+        Eigen::Matrix<float, 1, 6> biasRow;
+        biasRow << 0, 0, bias, 0, 0, 0;
+        biased.addObservation(biasRow, detections[0].pos.x() * bias);
+        biasedBatch.addObservation(biasRow, detections[0].pos.x() * bias);
+        biasRow << 0, 0, 0, 0, bias, 0;
+        biased.addObservation(biasRow, detections[0].pos.y() * bias);
+        biasedBatch.addObservation(biasRow, detections[0].pos.y() * bias);
+
+        const Eigen::Matrix<float, 6, 1> expected = biasedBatch.solve();
+        const Eigen::Matrix<float, 6, 1> result = biased.solve();
+        for (int j = 0; j < 6; j++) {
+            ASSERT_NEAR(expected(j), result(j), 1E-2f * std::max(1.0f, std::abs(expected(j))))
+                    << "parameter " << j << " after " << i << " frames";
+        }
+    }
+
+    const Eigen::Matrix<float, 6, 1> result = recursive.solve();
+    ASSERT_NEAR(result(0), zSpeed * startTime - 0.5f * GRAVITY * startTime * startTime, 0.02f);
+    ASSERT_NEAR(result(1), zSpeed - GRAVITY * startTime, 0.1f);
+    ASSERT_NEAR(result(2), startPos.x() + groundSpeed.x() * startTime, 0.02f);
+    ASSERT_NEAR(result(3), groundSpeed.x(), 0.1f);
+    ASSERT_NEAR(result(4), startPos.y() + groundSpeed.y() * startTime, 0.02f);
+    ASSERT_NEAR(result(5), groundSpeed.y(), 0.1f);
+}
+
+TEST(RecursiveLeastSquares, ResetStartsNewFit) {
+    RNG rng(5);
+    const Eigen::Vector2f startPos(-1.0f, 0.2f);
+    const Eigen::Vector2f groundSpeed(2.5f, -0.8f);
+    const float zSpeed = 3.5f;
+    const std::vector<Detection> firstFlight = simulateChip(rng, startPos, groundSpeed, zSpeed, 0.02f, 0.001f);
+
+    // the second flight after the bounce
+    const float bounceTime = 2 * zSpeed / GRAVITY;
+    const Eigen::Vector2f bouncePos = startPos + groundSpeed * bounceTime;
+    const Eigen::Vector2f bouncedSpeed = groundSpeed * 0.8f;
+    const float bouncedZSpeed = zSpeed * 0.5f;
+    const std::vector<Detection> secondFlight = simulateChip(rng, bouncePos, bouncedSpeed, bouncedZSpeed, 0.0f, 0.001f);
+
+    const Eigen::Vector2f direction = groundSpeed.normalized();
+    RecursiveLeastSquares<3> recursive;
+    for (const Detection &d : firstFlight) {
+        addConstrainedObservations(recursive, d, startPos, direction, 0);
+    }
+    const Eigen::Vector3f first = recursive.solve();
+    ASSERT_NEAR(first(0), zSpeed, 0.1f);
+    ASSERT_NEAR(first(1), groundSpeed.norm(), 0.1f);
+
+    // the fly filter restarts its fit like this at a bounce, see Tracker.ChipIsTrackedAfterBounce
+    recursive.reset();
+    BatchLeastSquares<3> batch;
+    for (const Detection &d : secondFlight) {
+        addConstrainedObservations(recursive, d, bouncePos, direction, 0);
+        addConstrainedObservations(batch, d, bouncePos, direction, 0);
+    }
+    const Eigen::Vector3f expected = batch.solve();
+    const Eigen::Vector3f result = recursive.solve();
+    for (int j = 0; j < 3; j++) {
+        ASSERT_NEAR(expected(j), result(j), 1E-3f);
+    }
+    ASSERT_NEAR(result(0), bouncedZSpeed, 0.1f);
+    ASSERT_NEAR(result(1), bouncedSpeed.norm(), 0.1f);
+    ASSERT_EQ(recursive.observationCount(), int(secondFlight.size() * 2));
+}
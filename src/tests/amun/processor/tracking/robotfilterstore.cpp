@@ -0,0 +1,118 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "protobuf/ssl_detection.pb.h"
+#include "tracking/robotfilterstore.h"
+
+namespace {
+
+SSL_DetectionRobot detection(uint id)
+{
+    SSL_DetectionRobot robot;
+    robot.set_confidence(1);
+    robot.set_robot_id(id);
+    robot.set_x(1000);
+    robot.set_y(-500);
+    robot.set_orientation(0);
+    robot.set_pixel_x(0);
+    robot.set_pixel_y(0);
+    return robot;
+}
+
+}
+
+TEST(RobotFilterStore, InsertAndLookup) {
+    RobotFilterStore store;
+    ASSERT_EQ(store.find(0), nullptr);
+    ASSERT_EQ(store.find(7), nullptr);
+
+    RobotFilter *filter = store.create(detection(7), 0, true);
+    store.hypotheses(7).append(filter);
+    // lower ids get an empty slot, higher ones stay unknown
+    ASSERT_NE(store.find(3), nullptr);
+    ASSERT_TRUE(store.find(3)->isEmpty());
+    ASSERT_EQ(store.find(8), nullptr);
+    ASSERT_EQ(store.find(7)->size(), 1);
+    ASSERT_EQ(store.find(7)->first(), filter);
+
+    store.hypotheses(RobotFilterStore::MAX_ID).append(store.create(detection(RobotFilterStore::MAX_ID), 0, true));
+    ASSERT_EQ(store.find(RobotFilterStore::MAX_ID)->size(), 1);
+
+    int count = 0;
+    for (const RobotFilterStore::Hypotheses &hypotheses : store) {
+        count += hypotheses.size();
+    }
+    ASSERT_EQ(count, 2);
+}
+
+TEST(RobotFilterStore, PrunedFiltersAreReused) {
+    RobotFilterStore store;
+    RobotFilterStore::Hypotheses &hypotheses = store.hypotheses(2);
+    RobotFilter *first = store.create(detection(2), 0, false);
+    RobotFilter *second = store.create(detection(2), 0, false);
+    ASSERT_NE(first, second);
+    hypotheses.append(first);
+    hypotheses.append(second);
+
+    hypotheses.removeAll(first);
+    store.release(first);
+    ASSERT_EQ(store.find(2)->size(), 1);
+    ASSERT_EQ(store.find(2)->first(), second);
+
+    RobotFilter *reused = store.create(detection(5), 0, true);
+    ASSERT_EQ(reused, first);
+    // the pool is empty again
+    ASSERT_NE(store.create(detection(5), 0, true), first);
+}
+
+TEST(RobotFilterStore, ClearAndAssign) {
+    RobotFilterStore store;
+    for (uint id = 0; id < 4; id++) {
+        store.hypotheses(id).append(store.create(detection(id), 0, true));
+    }
+    store.hypotheses(1).append(store.create(detection(1), 0, true));
+
+    RobotFilterStore copy;
+    copy.assign(store);
+    for (uint id = 0; id < 4; id++) {
+        ASSERT_EQ(copy.find(id)->size(), store.find(id)->size());
+        for (RobotFilter *filter : *copy.find(id)) {
+            ASSERT_FALSE(store.find(id)->contains(filter));
+        }
+    }
+
+    // assigning again reuses the filters of the previous assignment
+    QVector<RobotFilter*> previous;
+    for (const RobotFilterStore::Hypotheses &hypotheses : copy) {
+        previous += hypotheses;
+    }
+    copy.assign(store);
+    for (const RobotFilterStore::Hypotheses &hypotheses : copy) {
+        for (RobotFilter *filter : hypotheses) {
+            ASSERT_TRUE(previous.contains(filter));
+        }
+    }
+
+    copy.clear();
+    for (uint id = 0; id < 4; id++) {
+        ASSERT_TRUE(copy.find(id)->isEmpty());
+    }
+    ASSERT_EQ(store.find(1)->size(), 2);
+}
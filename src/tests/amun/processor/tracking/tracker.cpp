@@ -0,0 +1,389 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "gtest/gtest.h"
+#include "core/configuration.h"
+#include "core/rng.h"
+#include "protobuf/robot.pb.h"
+#include "protobuf/ssl_wrapper.pb.h"
+#include "protobuf/status.h"
+#include "tracking/tracker.h"
+
+#include <Eigen/Core>
+#include <QByteArray>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+QByteArray serialize(const SSL_WrapperPacket &wrapper)
+{
+    QByteArray data(wrapper.ByteSize(), 0);
+    wrapper.SerializeToArray(data.data(), data.size());
+    return data;
+}
+
+QByteArray geometryPacket()
+{
+    SSL_WrapperPacket wrapper;
+    SSL_GeometryFieldSize *field = wrapper.mutable_geometry()->mutable_field();
+    field->set_field_length(12000);
+    field->set_field_width(9000);
+    field->set_goal_width(1200);
+    field->set_goal_depth(180);
+    field->set_boundary_width(300);
+
+    SSL_GeometryCameraCalibration *calib = wrapper.mutable_geometry()->add_calib();
+    calib->set_camera_id(0);
+    calib->set_focal_length(400);
+    calib->set_principal_point_x(300);
+    calib->set_principal_point_y(300);
+    calib->set_distortion(0);
+    calib->set_q0(0);
+    calib->set_q1(0);
+    calib->set_q2(0);
+    calib->set_q3(1);
+    calib->set_tx(0);
+    calib->set_ty(0);
+    calib->set_tz(4000);
+    calib->set_derived_camera_world_tx(0);
+    calib->set_derived_camera_world_ty(0);
+    calib->set_derived_camera_world_tz(4000);
+    return serialize(wrapper);
+}
+
+void addBall(SSL_DetectionFrame *detection, float x, float y)
+{
+    SSL_DetectionBall *ball = detection->add_balls();
+    ball->set_confidence(1);
+    ball->set_x(x);
+    ball->set_y(y);
+    ball->set_pixel_x(0);
+    ball->set_pixel_y(0);
+}
+
+qint64 receiveTime(int frame)
+{
+    const double captureTime = 1.0 + frame / 60.0;
+    return captureTime * 1E9 + 2 * 1000 * 1000;
+}
+
+// the true ball rolls slowly, far away from the false detections which start once it is established
+QByteArray clutteredFrame(int frame, RNG &rng)
+{
+    const double captureTime = 1.0 + frame / 60.0;
+    SSL_WrapperPacket wrapper;
+    SSL_DetectionFrame *detection = wrapper.mutable_detection();
+    detection->set_frame_number(frame);
+    detection->set_t_capture(captureTime);
+    detection->set_t_sent(captureTime + 0.001);
+    detection->set_camera_id(0);
+
+    const float truePosition = 1000 + 500 * frame / 60.0f;
+    addBall(detection, truePosition, 0);
+    for (int i = 0; i < 20 && frame >= 5; i++) {
+        addBall(detection, rng.uniformFloat(-5500, -1000), rng.uniformFloat(-4000, 4000));
+    }
+
+    SSL_DetectionRobot *robot = detection->add_robots_yellow();
+    robot->set_confidence(1);
+    robot->set_robot_id(3);
+    robot->set_x(4000);
+    robot->set_y(-3000 + truePosition / 2);
+    robot->set_orientation(0.5f);
+    robot->set_pixel_x(0);
+    robot->set_pixel_y(0);
+    return serialize(wrapper);
+}
+
+const float GRAVITY = 9.81f;
+// the camera of geometryPacket is 4 m above the field center
+const float CAMERA_HEIGHT = 4000;
+
+struct ChipShot {
+    // in ssl vision coordinates, the shot goes along the x axis, beside the camera
+    float startX = -2000;
+    float startY = -1500;
+    float groundSpeed = 2500;
+    float zSpeed = 4;
+    int kickFrame = 30;
+
+    // position of the true ball in mm, the flight after the first bounce is damped according to the ball model
+    Eigen::Vector3f position(int frame, const world::BallModel &ballModel) const
+    {
+        float t = std::max(0.0f, (frame - kickFrame) / 60.0f);
+        Eigen::Vector3f pos(startX, startY, 0);
+        float vxy = groundSpeed;
+        float vz = zSpeed;
+        for (int flight = 0; flight < 2; flight++) {
+            const float duration = 2 * vz / GRAVITY;
+            if (t < duration) {
+                return pos + Eigen::Vector3f(vxy * t, 0, (vz * t - 0.5f * GRAVITY * t * t) * 1000);
+            }
+            pos.x() += vxy * duration;
+            t -= duration;
+            vxy *= ballModel.xy_damping();
+            vz *= ballModel.z_damping();
+        }
+        return pos + Eigen::Vector3f(vxy * t, 0, 0);
+    }
+
+    // seconds since the first bounce, negative before it
+    float timeSinceBounce(int frame) const
+    {
+        return (frame - kickFrame) / 60.0f - 2 * zSpeed / GRAVITY;
+    }
+};
+
+// the chipping robot stands still, the ball is detected where its line of sight from the camera hits the ground
+QByteArray chipFrame(int frame, const ChipShot &shot, const world::BallModel &ballModel)
+{
+    const double captureTime = 1.0 + frame / 60.0;
+    SSL_WrapperPacket wrapper;
+    SSL_DetectionFrame *detection = wrapper.mutable_detection();
+    detection->set_frame_number(frame);
+    detection->set_t_capture(captureTime);
+    detection->set_t_sent(captureTime + 0.001);
+    detection->set_camera_id(0);
+
+    const Eigen::Vector3f ball = shot.position(frame, ballModel);
+    const float scale = CAMERA_HEIGHT / (CAMERA_HEIGHT - ball.z());
+    addBall(detection, ball.x() * scale, ball.y() * scale);
+
+    SSL_DetectionRobot *robot = detection->add_robots_yellow();
+    robot->set_confidence(1);
+    robot->set_robot_id(3);
+    robot->set_x(shot.startX - 90);
+    robot->set_y(shot.startY);
+    robot->set_orientation(0);
+    robot->set_pixel_x(0);
+    robot->set_pixel_y(0);
+    return serialize(wrapper);
+}
+
+// a single yellow robot which drives along the x axis, or an empty frame
+QByteArray robotFrame(int frame, bool withRobot)
+{
+    const double captureTime = 1.0 + frame / 60.0;
+    SSL_WrapperPacket wrapper;
+    SSL_DetectionFrame *detection = wrapper.mutable_detection();
+    detection->set_frame_number(frame);
+    detection->set_t_capture(captureTime);
+    detection->set_t_sent(captureTime + 0.001);
+    detection->set_camera_id(0);
+
+    if (withRobot) {
+        SSL_DetectionRobot *robot = detection->add_robots_yellow();
+        robot->set_confidence(1);
+        robot->set_robot_id(3);
+        robot->set_x(-2000 + 1000 * frame / 60.0f);
+        robot->set_y(500);
+        robot->set_orientation(0.2f);
+        robot->set_pixel_x(0);
+        robot->set_pixel_y(0);
+    }
+    return serialize(wrapper);
+}
+
+Status trackFrame(Tracker &tracker, const QByteArray &packet, int frame)
+{
+    tracker.queuePacket(packet, receiveTime(frame), "test");
+    tracker.process(receiveTime(frame));
+    Status status = tracker.worldState(receiveTime(frame), true);
+    tracker.finishProcessing();
+    return status;
+}
+
+float debugValue(const Status &status, const std::string &key)
+{
+    for (const amun::DebugValues &debug : status->debug()) {
+        for (const amun::DebugValue &value : debug.value()) {
+            if (value.key() == key) {
+                return value.float_value();
+            }
+        }
+    }
+    return -1;
+}
+
+}
+
+TEST(Tracker, BallHypothesesStayBounded) {
+    Tracker tracker(false, false);
+    world::BallModel ballModel;
+    loadConfiguration("cpptests/ballmodel", &ballModel, false);
+    tracker.setBallModel(ballModel);
+
+    RNG rng(17);
+    const qint64 startTime = 1000 * 1000 * 1000;
+    tracker.queuePacket(geometryPacket(), startTime, "test");
+
+    float maxCount = 0;
+    Status status;
+    for (int frame = 0; frame < 120; frame++) {
+        status = trackFrame(tracker, clutteredFrame(frame, rng), frame);
+
+        const float count = debugValue(status, "Ball hypotheses/count");
+        ASSERT_GE(count, 1);
+        ASSERT_LE(count, 12);
+        maxCount = std::max(maxCount, count);
+    }
+
+    ASSERT_EQ(maxCount, 12);
+    ASSERT_GT(debugValue(status, "Ball hypotheses/pruned"), 0);
+    ASSERT_GT(debugValue(status, "Ball hypotheses/created"), 12);
+
+    // the established hypothesis of the true ball survives
+    ASSERT_TRUE(status->world_state().has_ball());
+    const float expected = (1000 + 500 * 119 / 60.0f) / 1000.0f;
+    ASSERT_NEAR(status->world_state().ball().p_x(), 0, 0.05);
+    ASSERT_NEAR(status->world_state().ball().p_y(), expected, 0.05);
+}
+
+TEST(Tracker, ParallelBallFiltersTrackIdentically) {
+    world::BallModel ballModel;
+    loadConfiguration("cpptests/ballmodel", &ballModel, false);
+    Tracker parallel(false, false);
+    parallel.setBallModel(ballModel);
+    Tracker sequential(false, false);
+    sequential.setBallModel(ballModel);
+    sequential.setParallelBallFilters(false);
+
+    RNG rng(23);
+    parallel.queuePacket(geometryPacket(), 1000 * 1000 * 1000, "test");
+    sequential.queuePacket(geometryPacket(), 1000 * 1000 * 1000, "test");
+    float maxCount = 0;
+    for (int frame = 0; frame < 90; frame++) {
+        const QByteArray packet = clutteredFrame(frame, rng);
+        const Status expected = trackFrame(sequential, packet, frame);
+        const Status status = trackFrame(parallel, packet, frame);
+        ASSERT_EQ(status->world_state().SerializeAsString(), expected->world_state().SerializeAsString());
+        maxCount = std::max(maxCount, debugValue(status, "Ball hypotheses/count"));
+    }
+    // enough hypotheses for the parallel update
+    ASSERT_EQ(maxCount, 12);
+}
+
+TEST(Tracker, RestoredSnapshotRetracksIdentically) {
+    Tracker tracker(false, false);
+    world::BallModel ballModel;
+    loadConfiguration("cpptests/ballmodel", &ballModel, false);
+    tracker.setBallModel(ballModel);
+
+    RNG rng(5);
+    std::vector<QByteArray> packets;
+    for (int frame = 0; frame < 90; frame++) {
+        packets.push_back(clutteredFrame(frame, rng));
+    }
+
+    tracker.queuePacket(geometryPacket(), 1000 * 1000 * 1000, "test");
+    for (int frame = 0; frame < 45; frame++) {
+        trackFrame(tracker, packets[frame], frame);
+    }
+    const auto snapshot = tracker.snapshot();
+
+    std::vector<std::string> expected;
+    for (int frame = 45; frame < 90; frame++) {
+        expected.push_back(trackFrame(tracker, packets[frame], frame)->world_state().SerializeAsString());
+    }
+
+    tracker.restore(*snapshot);
+    Status status;
+    for (int frame = 45; frame < 90; frame++) {
+        status = trackFrame(tracker, packets[frame], frame);
+        ASSERT_EQ(status->world_state().SerializeAsString(), expected[frame - 45]);
+    }
+    ASSERT_TRUE(status->world_state().has_ball());
+    ASSERT_EQ(status->world_state().yellow_size(), 1);
+
+    // the snapshot stays valid after being restored
+    tracker.restore(*snapshot);
+    ASSERT_EQ(trackFrame(tracker, packets[45], 45)->world_state().SerializeAsString(), expected[0]);
+}
+
+TEST(Tracker, ReusedRobotFilterTracksLikeFreshOne) {
+    // the first robot filter of reused is dropped after the robot vanished and then taken from the pool,
+    // while fresh never saw the robot before it appears
+    Tracker reused(false, false);
+    Tracker fresh(false, false);
+    reused.queuePacket(geometryPacket(), 1000 * 1000 * 1000, "test");
+    fresh.queuePacket(geometryPacket(), 1000 * 1000 * 1000, "test");
+
+    robot::RadioCommand radioCommand;
+    radioCommand.set_generation(3);
+    radioCommand.set_id(3);
+    radioCommand.set_is_blue(false);
+    radioCommand.mutable_command()->mutable_output1()->set_v_f(1);
+    radioCommand.mutable_command()->mutable_output1()->set_omega(0.5f);
+
+    for (int frame = 0; frame < 60; frame++) {
+        reused.queueRadioCommands({radioCommand}, receiveTime(frame) - 5 * 1000 * 1000);
+        trackFrame(reused, robotFrame(frame, true), frame);
+        trackFrame(fresh, robotFrame(frame, false), frame);
+    }
+    // long enough for the filter to time out
+    for (int frame = 60; frame < 150; frame++) {
+        trackFrame(reused, robotFrame(frame, false), frame);
+        trackFrame(fresh, robotFrame(frame, false), frame);
+    }
+    ASSERT_EQ(trackFrame(reused, robotFrame(150, false), 150)->world_state().yellow_size(), 0);
+    trackFrame(fresh, robotFrame(150, false), 150);
+
+    Status status;
+    for (int frame = 151; frame < 240; frame++) {
+        const QByteArray packet = robotFrame(frame, true);
+        const Status expected = trackFrame(fresh, packet, frame);
+        status = trackFrame(reused, packet, frame);
+        ASSERT_EQ(status->world_state().SerializeAsString(), expected->world_state().SerializeAsString());
+    }
+    ASSERT_EQ(status->world_state().yellow_size(), 1);
+}
+
+TEST(Tracker, ChipIsTrackedAfterBounce) {
+    // the flight after the bounce is reconstructed from the curved detections,
+    // which only works if that fit restarts at the bounce instead of reusing the initial flight
+    Tracker tracker(false, false);
+    world::BallModel ballModel;
+    loadConfiguration("cpptests/ballmodel", &ballModel, false);
+    tracker.setBallModel(ballModel);
+    tracker.queuePacket(geometryPacket(), 1000 * 1000 * 1000, "test");
+
+    const ChipShot shot;
+    const float secondFlightDuration = 2 * shot.zSpeed * ballModel.z_damping() / GRAVITY;
+    int checkedFrames = 0;
+    for (int frame = 0; shot.timeSinceBounce(frame) < secondFlightDuration; frame++) {
+        const Status status = trackFrame(tracker, chipFrame(frame, shot, ballModel), frame);
+
+        // leave the reconstruction some frames to pick up the curvature after the bounce
+        const float sinceBounce = shot.timeSinceBounce(frame);
+        if (sinceBounce < 0.15f || sinceBounce > secondFlightDuration - 0.05f) {
+            continue;
+        }
+        ASSERT_TRUE(status->world_state().has_ball());
+        const world::Ball &ball = status->world_state().ball();
+        const Eigen::Vector3f truth = shot.position(frame, ballModel) / 1000;
+        EXPECT_TRUE(ball.is_bouncing());
+        EXPECT_NEAR(ball.p_x(), -truth.y(), 0.1f);
+        EXPECT_NEAR(ball.p_y(), truth.x(), 0.1f);
+        EXPECT_NEAR(ball.p_z(), truth.z(), 0.1f);
+        checkedFrames++;
+    }
+    ASSERT_GT(checkedFrames, 5);
+}
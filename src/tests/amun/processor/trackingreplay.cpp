@@ -0,0 +1,79 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "core/timer.h"
+#include "processor/trackingreplay.h"
+#include "protobuf/ssl_wrapper.pb.h"
+#include "protobuf/status.h"
+
+namespace {
+
+Status visionStatus(qint64 time, int frameNumber)
+{
+    Status status(new amun::Status);
+    status->set_time(time);
+    world::State *state = status->mutable_world_state();
+    state->set_time(time);
+    SSL_DetectionFrame *detection = state->add_vision_frames()->mutable_detection();
+    detection->set_frame_number(frameNumber);
+    detection->set_t_capture(time * 1E-9);
+    detection->set_t_sent(time * 1E-9);
+    detection->set_camera_id(0);
+    state->add_vision_frame_times(time);
+    // not used by the tracking replay and thus not part of the checkpoints
+    status->mutable_debug()->Add()->set_source(amun::Tracking);
+    return status;
+}
+
+}
+
+TEST(TrackingReplay, SeekBeforeOldestCheckpoint) {
+    Timer timer;
+    TrackingReplay replay(&timer);
+
+    const qint64 start = 1000 * 1000 * 1000LL;
+    const qint64 step = 500 * 1000 * 1000LL;
+    // creates a checkpoint every second, more than are kept
+    for (int i = 0; i < 300; i++) {
+        replay.handleStatus(visionStatus(start + i * step, i));
+    }
+    QList<qint64> checkpoints = replay.checkpointTimes();
+    ASSERT_EQ(checkpoints.size(), 120);
+    ASSERT_EQ(checkpoints.first(), start + 60 * step);
+    ASSERT_EQ(checkpoints.last(), start + 298 * step);
+
+    // the status differs from the first pass, thus it is not cached and has to be tracked from scratch
+    const qint64 seekTime = start + step + 1;
+    replay.handleStatus(visionStatus(seekTime, 1000));
+    checkpoints = replay.checkpointTimes();
+    ASSERT_EQ(checkpoints.size(), 120);
+    ASSERT_EQ(checkpoints.first(), seekTime);
+    // the latest checkpoint is the farthest away from the new one
+    ASSERT_EQ(checkpoints.last(), start + 296 * step);
+
+    // continuing from there adds checkpoints again
+    replay.handleStatus(visionStatus(seekTime + step, 1001));
+    replay.handleStatus(visionStatus(seekTime + 2 * step, 1002));
+    checkpoints = replay.checkpointTimes();
+    ASSERT_EQ(checkpoints.size(), 120);
+    ASSERT_EQ(checkpoints.at(0), seekTime);
+    ASSERT_EQ(checkpoints.at(1), seekTime + 2 * step);
+    ASSERT_EQ(checkpoints.at(2), start + 60 * step);
+}
@@ -159,6 +159,31 @@ public:
         emit test.sendCommand(c);
     }
 
+    // continues from the current state and again from the snapshot, both have to result in the same output
+    void checkSnapshotContinuation(const sslsim::SimulatorSnapshotErForce &snapshot, const std::function<void()> &callback) {
+        QList<std::string> truths;
+        test.handleSimulatorTruth = [&truths] (const world::SimulatorState &truth) {
+            truths.append(truth.SerializeAsString());
+        };
+        QList<std::string> frames;
+        test.handleDetectionWrapper = [&frames] (const SSL_WrapperPacket &packet, qint64 time) {
+            frames.append(packet.SerializeAsString() + std::to_string(time));
+        };
+        FastSimulator::goDeltaCallback(s, &t, 1e9, callback);
+        const QList<std::string> expectedTruths = truths;
+        const QList<std::string> expectedFrames = frames;
+        ASSERT_GT(expectedTruths.size(), 0);
+        ASSERT_GT(expectedFrames.size(), 0);
+
+        truths.clear();
+        frames.clear();
+        t.setTime(snapshot.time(), 0);
+        s->restoreSnapshot(snapshot);
+        FastSimulator::goDeltaCallback(s, &t, 1e9, callback);
+        ASSERT_EQ(truths, expectedTruths);
+        ASSERT_EQ(frames, expectedFrames);
+    }
+
     SimTester test;
     Timer t;
     camun::simulator::Simulator* s;
@@ -248,6 +273,26 @@ TEST_F(FastSimulatorTest, VisionRate) {
     ASSERT_GE(test.m_counter, exp_packets * 0.8);
 }
 
+TEST_F(FastSimulatorTest, VisionDelay) {
+    QObject::disconnect(s, &Simulator::sendRealData, &test, &SimTester::handleSimulatorTruthRaw);
+    int detections = 0;
+    test.handleDetectionWrapper = [this, &detections] (auto wrapper, qint64 time) {
+        if (!wrapper.has_detection()) {
+            return;
+        }
+        detections++;
+        // the packet is stamped with the time it was sent by the vision, which is never in the future
+        ASSERT_EQ(time, qint64(std::llround(wrapper.detection().t_sent() * 1E9)));
+        ASSERT_LE(time, t.currentTime());
+        ASSERT_GE(time - qint64(std::llround(wrapper.detection().t_capture() * 1E9)), 0);
+    };
+    // nothing can arrive before the default vision delay of 35 ms
+    FastSimulator::goDelta(s, &t, 3e7);
+    ASSERT_EQ(detections, 0);
+    FastSimulator::goDelta(s, &t, 1e8);
+    ASSERT_GT(detections, 0);
+}
+
 TEST_F(FastSimulatorTest, OriginString) {
     QObject::disconnect(s, &Simulator::sendRealData, &test, &SimTester::handleSimulatorTruthRaw);
     FastSimulator::goDelta(s, &t, 5e8); // 500 millisecond
@@ -766,6 +811,8 @@ TEST_F(FastSimulatorTest, TeleportRobotAfterMove) {
 
     // send same teleport command as above again
     emit this->test.sendCommand(teleportCommand);
+    // skip the frames captured before the teleport, which still arrive during the vision delay
+    FastSimulator::goDelta(s, &t, 5e7);
 
     test.handleSimulatorTruth = [&desiredPos] (auto truth) {
         ASSERT_EQ(truth.blue_robots_size(), 1);
@@ -867,6 +914,8 @@ TEST_F(FastSimulatorTest, InvisibleBall) {
         teleportBall->set_vy(0);
         emit this->test.sendCommand(command);
     }
+    // skip the frames captured before the teleport, which still arrive during the vision delay
+    FastSimulator::goDelta(s, &t, 5e7);
     test.handleDetectionWrapper = [] (auto wrapper, auto) {
         if (!wrapper.has_detection()) {
             return;
@@ -902,8 +951,9 @@ TEST_F(FastSimulatorTest, CameraOverlap) {
         teleportBall->set_vy(0);
         emit this->test.sendCommand(command);
 
+        // skip the frames captured before the teleport, including those delayed by the vision delay
         this->test.handleDetectionWrapper = [](auto, auto){};
-        FastSimulator::goDelta(s, &t, 3e7);
+        FastSimulator::goDelta(s, &t, 7e7);
 
         std::set<int> foundCameras;
         this->test.handleDetectionWrapper = [&foundCameras] (auto wrapper, auto) {
@@ -941,6 +991,126 @@ TEST_F(FastSimulatorTest, CameraOverlap) {
     checkCameras(Vector(2, -0.49), {0, 2});
 }
 
+TEST_F(FastSimulatorTest, SnapshotRestore) {
+    loadRobots(2, 2);
+
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    auto *cmd = control->add_robot_commands();
+    cmd->set_id(1);
+    cmd->set_dribbler_speed(1000);
+    auto *localVel = cmd->mutable_move_command()->mutable_local_velocity();
+    localVel->set_forward(1);
+    localVel->set_left(0.5);
+    localVel->set_angular(2);
+    auto callback = [&control, this]() {
+        emit this->test.sendSSLRadioCommand(control, true, 0);
+    };
+    FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+
+    checkSnapshotContinuation(s->captureAndRebuild(), callback);
+}
+
+TEST_F(FastSimulatorTest, SnapshotRestoreWithNoise) {
+    // detection noise, dropped and shuffled detections and lost radio commands all use the random generators
+    Command command{new amun::Command};
+    loadConfiguration("cpptests/realism-realistic", command->mutable_simulator()->mutable_realism_config(), false);
+    emit test.sendCommand(command);
+    loadRobots(2, 2);
+
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    auto *cmd = control->add_robot_commands();
+    cmd->set_id(0);
+    auto *localVel = cmd->mutable_move_command()->mutable_local_velocity();
+    localVel->set_forward(1);
+    localVel->set_angular(1);
+    auto callback = [&control, this]() {
+        emit this->test.sendSSLRadioCommand(control, false, 0);
+    };
+    FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+
+    checkSnapshotContinuation(s->captureAndRebuild(), callback);
+}
+
+TEST_F(FastSimulatorTest, SeededRunsAreIdentical) {
+    // the realistic config adds detection noise, dropped and shuffled detections, which all have to follow the seed
+    RealismConfigErForce realism;
+    loadConfiguration("cpptests/realism-realistic", &realism, false);
+    amun::SimulatorSetup setup;
+    loadConfiguration("cpptests/simulator-2020", &setup, false);
+
+    QList<std::string> truths;
+    test.handleSimulatorTruth = [&truths] (const world::SimulatorState &truth) {
+        truths.append(truth.SerializeAsString());
+    };
+    QList<std::string> frames;
+    test.handleDetectionWrapper = [&frames] (const SSL_WrapperPacket &packet, qint64 time) {
+        frames.append(packet.SerializeAsString() + std::to_string(time));
+    };
+
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    auto *cmd = control->add_robot_commands();
+    cmd->set_id(0);
+    cmd->set_dribbler_speed(1000);
+    auto *localVel = cmd->mutable_move_command()->mutable_local_velocity();
+    localVel->set_forward(1);
+    localVel->set_angular(1);
+    auto callback = [&control, this]() {
+        emit this->test.sendSSLRadioCommand(control, true, 0);
+    };
+
+    // createSimulator seeds the simulator with the same value every time
+    auto runScenario = [&]() {
+        createSimulator(setup);
+        Command command{new amun::Command};
+        command->mutable_simulator()->mutable_realism_config()->CopyFrom(realism);
+        sslsim::TeleportBall *teleport = command->mutable_simulator()->mutable_ssl_control()->mutable_teleport_ball();
+        coordinates::toVision(Vector(-1, -2), *teleport);
+        coordinates::toVisionVelocity(Vector(0.5, 2), *teleport);
+        emit test.sendCommand(command);
+        loadRobots(2, 2);
+        FastSimulator::goDeltaCallback(s, &t, 2e9, callback);
+    };
+
+    runScenario();
+    const QList<std::string> expectedTruths = truths;
+    const QList<std::string> expectedFrames = frames;
+    ASSERT_GT(expectedTruths.size(), 0);
+    ASSERT_GT(expectedFrames.size(), 0);
+
+    truths.clear();
+    frames.clear();
+    runScenario();
+    ASSERT_EQ(truths, expectedTruths);
+    ASSERT_EQ(frames, expectedFrames);
+}
+
+TEST_F(ShootTest, SnapshotRestoreHeldBall) {
+    // the perfect dribbler holds the ball with a constraint, which has to be restored as well
+    Command command{new amun::Command};
+    command->mutable_simulator()->mutable_realism_config()->set_simulate_dribbling(false);
+    emit test.sendCommand(command);
+    prepareShoot();
+
+    SSLSimRobotControl control{new sslsim::RobotControl};
+    auto *cmd = control->add_robot_commands();
+    cmd->set_id(0);
+    cmd->set_dribbler_speed(1000);
+    auto callback = [&control, this]() {
+        emit this->test.sendSSLRadioCommand(control, false, 0);
+    };
+    FastSimulator::goDeltaCallback(s, &t, 5e8, callback);
+
+    // rotate with the ball after the snapshot
+    auto *localVel = cmd->mutable_move_command()->mutable_local_velocity();
+    localVel->set_forward(0);
+    localVel->set_left(0);
+    localVel->set_angular(2);
+    const sslsim::SimulatorSnapshotErForce snapshot = s->captureAndRebuild();
+    ASSERT_EQ(snapshot.yellow_robots_size(), 1);
+    ASSERT_TRUE(snapshot.yellow_robots(0).has_hold_ball());
+    checkSnapshotContinuation(snapshot, callback);
+}
+
 TEST_F(ShootTest, ShootSpeed) {
     for (const float expected_speed : { 2.0f, 4.0f, 6.0f, 8.0f }) {
         prepareShoot();
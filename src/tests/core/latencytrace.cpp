@@ -0,0 +1,161 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "core/latencytrace.h"
+#include "protobuf/debug.pb.h"
+#include <QFile>
+#include <QTemporaryDir>
+
+static const qint64 MS = 1000 * 1000;
+
+static bool findValue(const amun::DebugValues &debug, const std::string &key, float &value)
+{
+    for (const amun::DebugValue &debugValue : debug.value()) {
+        if (debugValue.key() == key) {
+            value = debugValue.float_value();
+            return true;
+        }
+    }
+    return false;
+}
+
+// the histogram reports the upper bound of the 0.5 ms bucket of the duration
+static void checkDuration(const amun::DebugValues &debug, const std::string &prefix, int durationMs)
+{
+    float count = 0;
+    ASSERT_TRUE(findValue(debug, prefix + "/count", count)) << prefix;
+    ASSERT_EQ(count, 1) << prefix;
+    float p50 = 0;
+    ASSERT_TRUE(findValue(debug, prefix + "/p50", p50)) << prefix;
+    ASSERT_FLOAT_EQ(p50, durationMs + 0.5f) << prefix;
+}
+
+// two strategies take part in the trace with the given id
+static void recordFullTrace(LatencyTrace &trace, qint64 traceId, qint64 start)
+{
+    trace.record(traceId, LatencyTrace::ProcessingStart, start + 1 * MS);
+    trace.record(traceId, LatencyTrace::VisionReceived, start);
+    trace.record(traceId, LatencyTrace::TrackingDone, start + 3 * MS);
+    trace.record(traceId, LatencyTrace::StrategyStart, start + 5 * MS);
+    trace.record(traceId, LatencyTrace::StrategyStart, start + 4 * MS);
+    trace.record(traceId, LatencyTrace::StrategyDone, start + 9 * MS);
+    trace.record(traceId, LatencyTrace::StrategyDone, start + 8 * MS);
+    trace.record(traceId, LatencyTrace::CommandsReceived, start + 7 * MS);
+    trace.record(traceId, LatencyTrace::CommandsReceived, start + 10 * MS);
+    trace.recordRadioQueued(traceId, {traceId}, start + 11 * MS);
+    trace.recordRadioSent(traceId, start + 12 * MS);
+}
+
+TEST(LatencyTrace, StageOrdering) {
+    LatencyTrace trace;
+    recordFullTrace(trace, 42, 0);
+
+    amun::DebugValues debug;
+    trace.writeStatistics(&debug, 2000 * MS);
+    checkDuration(debug, "Latency trace/total", 12);
+    checkDuration(debug, "Latency trace/1 processing start", 1);
+    checkDuration(debug, "Latency trace/2 tracking done", 2);
+    // the earliest strategy start and the latest end are kept
+    checkDuration(debug, "Latency trace/3 strategy start", 1);
+    checkDuration(debug, "Latency trace/4 strategy done", 5);
+    // the commands are measured from the strategy start
+    checkDuration(debug, "Latency trace/5 commands received", 6);
+    checkDuration(debug, "Latency trace/6 radio queued", 1);
+    checkDuration(debug, "Latency trace/7 radio sent", 1);
+}
+
+TEST(LatencyTrace, StatisticsWindow) {
+    LatencyTrace trace;
+    amun::DebugValues empty;
+    trace.writeStatistics(&empty, 1000 * MS);
+    ASSERT_EQ(empty.value_size(), 0);
+
+    recordFullTrace(trace, 42, 1000 * MS);
+    // the new trace is only published once the window is over
+    amun::DebugValues sameWindow;
+    trace.writeStatistics(&sameWindow, 1500 * MS);
+    ASSERT_EQ(sameWindow.value_size(), 0);
+
+    amun::DebugValues nextWindow;
+    trace.writeStatistics(&nextWindow, 2000 * MS);
+    checkDuration(nextWindow, "Latency trace/total", 12);
+    amun::DebugValues repeated;
+    trace.writeStatistics(&repeated, 2500 * MS);
+    ASSERT_EQ(repeated.SerializeAsString(), nextWindow.SerializeAsString());
+}
+
+TEST(LatencyTrace, TimeoutCompletesTrace) {
+    LatencyTrace trace;
+    trace.record(1, LatencyTrace::ProcessingStart, 1 * MS);
+    trace.record(1, LatencyTrace::VisionReceived, 0);
+    trace.record(1, LatencyTrace::TrackingDone, 3 * MS);
+
+    // the trace is still waiting for the strategy
+    amun::DebugValues pending;
+    trace.writeStatistics(&pending, 1000 * MS);
+    ASSERT_EQ(pending.value_size(), 0);
+
+    trace.record(2, LatencyTrace::ProcessingStart, 1001 * MS);
+    amun::DebugValues debug;
+    trace.writeStatistics(&debug, 2000 * MS);
+    checkDuration(debug, "Latency trace/1 processing start", 1);
+    checkDuration(debug, "Latency trace/2 tracking done", 2);
+    // neither the total nor the missing stages are published
+    float value;
+    ASSERT_FALSE(findValue(debug, "Latency trace/total/count", value));
+    ASSERT_FALSE(findValue(debug, "Latency trace/3 strategy start/count", value));
+}
+
+TEST(LatencyTrace, IgnoreStagesWithoutProcessing) {
+    LatencyTrace trace;
+    // e.g. a strategy running on a replayed world state
+    trace.record(1, LatencyTrace::StrategyStart, 1 * MS);
+    trace.record(1, LatencyTrace::StrategyDone, 2 * MS);
+    trace.record(1, LatencyTrace::CommandsReceived, 3 * MS);
+    trace.recordRadioQueued(1, {1}, 4 * MS);
+    trace.recordRadioSent(1, 5 * MS);
+    trace.record(2, LatencyTrace::ProcessingStart, 2000 * MS);
+
+    amun::DebugValues debug;
+    trace.writeStatistics(&debug, 4000 * MS);
+    ASSERT_EQ(debug.value_size(), 0);
+}
+
+TEST(LatencyTrace, CsvExport) {
+    QTemporaryDir dir;
+    ASSERT_TRUE(dir.isValid());
+    const QString filename = dir.filePath("trace.csv");
+
+    LatencyTrace trace;
+    ASSERT_TRUE(trace.setExportFile(filename));
+    recordFullTrace(trace, 42, 0);
+    // incomplete traces are not exported
+    trace.record(43, LatencyTrace::ProcessingStart, 20 * MS);
+    recordFullTrace(trace, 44, 2000 * MS);
+    ASSERT_TRUE(trace.setExportFile(QString()));
+
+    QFile file(filename);
+    ASSERT_TRUE(file.open(QIODevice::ReadOnly | QIODevice::Text));
+    const QStringList lines = QString::fromUtf8(file.readAll()).split('\n', QString::SkipEmptyParts);
+    ASSERT_EQ(lines.size(), 3);
+    ASSERT_EQ(lines[0], "vision_received,processing_start,tracking_done,strategy_start,strategy_done,commands_received,radio_queued,radio_sent");
+    ASSERT_EQ(lines[1], "0,1000000,3000000,4000000,9000000,10000000,11000000,12000000");
+    ASSERT_EQ(lines[2], "2000000000,2001000000,2003000000,2004000000,2009000000,2010000000,2011000000,2012000000");
+}
@@ -0,0 +1,72 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "core/ringbuffer.h"
+
+TEST(RingBuffer, Order) {
+    RingBuffer<int, 4> buffer;
+    ASSERT_TRUE(buffer.isEmpty());
+    for (int i = 0; i < 3; i++) {
+        ASSERT_FALSE(buffer.append(i));
+    }
+    ASSERT_EQ(buffer.size(), 3);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(buffer.at(i), i);
+    }
+    buffer.removeFirst();
+    ASSERT_EQ(buffer.first(), 1);
+    ASSERT_EQ(buffer.size(), 2);
+}
+
+TEST(RingBuffer, WrapAround) {
+    RingBuffer<int, 4> buffer;
+    // the start moves around the storage several times
+    for (int i = 0; i < 20; i++) {
+        ASSERT_FALSE(buffer.append(2 * i));
+        ASSERT_FALSE(buffer.append(2 * i + 1));
+        ASSERT_EQ(buffer.size(), 3);
+        ASSERT_EQ(buffer.at(1), 2 * i);
+        ASSERT_EQ(buffer.at(2), 2 * i + 1);
+        buffer.removeFirst();
+        buffer.removeFirst();
+    }
+    ASSERT_EQ(buffer.size(), 1);
+    ASSERT_EQ(buffer.first(), 39);
+}
+
+TEST(RingBuffer, Overflow) {
+    RingBuffer<int, 4> buffer;
+    for (int i = 0; i < 4; i++) {
+        ASSERT_FALSE(buffer.append(i));
+    }
+    ASSERT_TRUE(buffer.isFull());
+    // the oldest elements are dropped, the rest keeps its order
+    ASSERT_TRUE(buffer.append(4));
+    ASSERT_TRUE(buffer.append(5));
+    ASSERT_EQ(buffer.size(), 4);
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(buffer.at(i), i + 2);
+    }
+
+    buffer.clear();
+    ASSERT_TRUE(buffer.isEmpty());
+    ASSERT_FALSE(buffer.append(6));
+    ASSERT_EQ(buffer.first(), 6);
+}
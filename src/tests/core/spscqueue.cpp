@@ -0,0 +1,87 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include "gtest/gtest.h"
+#include "core/spscqueue.h"
+
+#include <thread>
+
+TEST(SpscQueue, Capacity) {
+    SpscQueue<int> queue(5);
+    ASSERT_EQ(queue.capacity(), 8u);
+    ASSERT_TRUE(queue.empty());
+
+    for (int i = 0; i < 8; i++) {
+        ASSERT_TRUE(queue.push(i));
+    }
+    ASSERT_FALSE(queue.push(8));
+
+    int value = -1;
+    ASSERT_TRUE(queue.pop(value));
+    ASSERT_EQ(value, 0);
+    ASSERT_TRUE(queue.push(8));
+}
+
+TEST(SpscQueue, Order) {
+    SpscQueue<int> queue(4);
+    int value = -1;
+    ASSERT_FALSE(queue.pop(value));
+    // wrap around several times
+    for (int i = 0; i < 20; i++) {
+        ASSERT_TRUE(queue.push(2 * i));
+        ASSERT_TRUE(queue.push(2 * i + 1));
+        ASSERT_TRUE(queue.pop(value));
+        ASSERT_EQ(value, 2 * i);
+        ASSERT_TRUE(queue.pop(value));
+        ASSERT_EQ(value, 2 * i + 1);
+    }
+    ASSERT_TRUE(queue.empty());
+}
+
+TEST(SpscQueue, Threads) {
+    const int COUNT = 100000;
+    SpscQueue<int> queue(16);
+
+    std::thread producer([&queue]() {
+        for (int i = 0; i < COUNT; i++) {
+            while (!queue.push(i)) {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    // a failed assertion here would return while the producer still waits for free space
+    int expected = 0;
+    int mismatches = 0;
+    while (expected < COUNT) {
+        int value;
+        if (queue.pop(value)) {
+            if (value != expected) {
+                mismatches++;
+            }
+            expected++;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    ASSERT_EQ(mismatches, 0);
+    ASSERT_TRUE(queue.empty());
+}
@@ -0,0 +1,113 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+#include "gtest/gtest.h"
+#include "protobuf/status.h"
+#include "protobuf/world.h"
+
+namespace {
+
+void addRobot(google::protobuf::RepeatedPtrField<world::Robot> *robots, uint id, float x)
+{
+    world::Robot *robot = robots->Add();
+    robot->set_id(id);
+    robot->set_p_x(x);
+    robot->set_p_y(1);
+    robot->set_phi(0);
+    robot->set_v_x(0);
+    robot->set_v_y(0);
+    robot->set_omega(0);
+}
+
+Status trackedStatus()
+{
+    Status status = Status::createArena();
+    world::State *state = status->mutable_world_state();
+    state->set_time(1234);
+    world::Ball *ball = state->mutable_ball();
+    ball->set_p_x(1);
+    ball->set_p_y(2);
+    ball->set_v_x(0);
+    ball->set_v_y(0);
+    state->mutable_simple_tracking_ball()->CopyFrom(*ball);
+    state->mutable_simple_tracking_ball()->set_p_x(1.5f);
+    for (uint id = 0; id < 8; id++) {
+        addRobot(state->mutable_yellow(), id, id);
+        addRobot(state->mutable_simple_tracking_yellow(), id, id + 0.5f);
+        addRobot(state->mutable_blue(), id, -1.0f * id);
+        addRobot(state->mutable_simple_tracking_blue(), id, -1.0f * id - 0.5f);
+    }
+    state->set_has_vision_data(true);
+    state->set_world_source(world::INTERNAL_SIMULATION);
+    state->add_vision_frames();
+    state->add_vision_frame_times(1000);
+    return status;
+}
+
+}
+
+TEST(WorldState, ReferenceMatchesCopy) {
+    const Status source = trackedStatus();
+    const world::State &sourceState = source->world_state();
+
+    for (int variant = 0; variant < 8; variant++) {
+        const bool simpleYellow = variant & 1;
+        const bool simpleBlue = variant & 2;
+        const bool simpleBall = variant & 4;
+
+        world::State expected;
+        expected.CopyFrom(sourceState);
+        expected.clear_vision_frames();
+        if (simpleYellow) {
+            expected.mutable_yellow()->CopyFrom(sourceState.simple_tracking_yellow());
+        }
+        if (simpleBlue) {
+            expected.mutable_blue()->CopyFrom(sourceState.simple_tracking_blue());
+        }
+        if (simpleBall) {
+            expected.mutable_ball()->CopyFrom(sourceState.simple_tracking_ball());
+        }
+
+        Status target = Status::createArena();
+        target.keepAlive(source);
+        referenceWorldState(target->mutable_execution_state(), sourceState, simpleYellow, simpleBlue, simpleBall);
+        ASSERT_EQ(target->execution_state().SerializeAsString(), expected.SerializeAsString());
+    }
+}
+
+TEST(WorldState, ReferenceDoesNotCopy) {
+    Status target = Status::createArena();
+    {
+        const Status source = trackedStatus();
+        target.keepAlive(source);
+        referenceWorldState(target->mutable_execution_state(), source->world_state(), true, false, true);
+    }
+
+    // the source is only kept alive by the target
+    const world::State &state = target->execution_state();
+    ASSERT_EQ(state.yellow_size(), 8);
+    ASSERT_EQ(state.blue_size(), 8);
+    for (int i = 0; i < 8; i++) {
+        ASSERT_EQ(&state.yellow(i), &state.simple_tracking_yellow(i));
+        ASSERT_NE(&state.blue(i), &state.simple_tracking_blue(i));
+    }
+    ASSERT_EQ(&state.ball(), &state.simple_tracking_ball());
+    ASSERT_FLOAT_EQ(state.ball().p_x(), 1.5f);
+    ASSERT_EQ(state.vision_frames_size(), 0);
+}
@@ -0,0 +1,343 @@
+/***************************************************************************
+ *   Copyright 2026 Robotics Erlangen e.V.                                 *
+ *   http://www.robotics-erlangen.de/                                      *
+ *   info@robotics-erlangen.de                                             *
+ *                                                                         *
+ *   This program is free software: you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation, either version 3 of the License, or     *
+ *   any later version.                                                    *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program.  If not, see <http://www.gnu.org/licenses/>. *
+ ***************************************************************************/
+
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <clocale>
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include "core/configuration.h"
+#include "core/vector.h"
+#include "git/gitconfig.h"
+#include "protobuf/status.h"
+#include "testtools/simulationharness.h"
+#include "tracking/tracker.h"
+
+// the tracked ball counts as flying once it has a height
+static const float CHIP_MIN_HEIGHT = 0.02f;
+
+struct ErrorSum
+{
+    qint64 count = 0;
+    double squaredSum = 0;
+
+    void add(double error)
+    {
+        count++;
+        squaredSum += error * error;
+    }
+
+    double rms() const { return count > 0 ? std::sqrt(squaredSum / count) : NAN; }
+};
+
+struct BenchmarkResult
+{
+    ErrorSum ballPosition;
+    ErrorSum ballSpeed;
+    ErrorSum robotPosition;
+    ErrorSum robotSpeed;
+    int samples = 0;
+    int ballMissing = 0;
+    // time between the first flight of the true ball and the detection of the flight, -1 if there was none
+    qint64 chipLatency = -1;
+    // duration of the calls to Tracker::process
+    std::vector<qint64> processTimes;
+};
+
+// runs one scenario in the simulator and compares the tracking with the ground truth every 10 ms
+class BenchmarkRun : public SimulationHarness
+{
+public:
+    BenchmarkRun(uint32_t seed, int blueRobots, int yellowRobots);
+
+    void simulate(float seconds);
+    // the errors are only accumulated while evaluating, which allows skipping the reaction to teleports
+    void setEvaluating(bool evaluating) { m_evaluating = evaluating; }
+
+    const BenchmarkResult &result() const { return m_result; }
+
+private:
+    static RealismConfigErForce createRealism();
+    void track();
+
+private:
+    Tracker m_tracker;
+    world::SimulatorState m_truth;
+    bool m_hasTruth = false;
+    bool m_evaluating = true;
+    qint64 m_chipStart = -1;
+    BenchmarkResult m_result;
+};
+
+RealismConfigErForce BenchmarkRun::createRealism()
+{
+    RealismConfigErForce realismConfig;
+    loadConfiguration("cpptests/realism-realistic", &realismConfig, false);
+    return realismConfig;
+}
+
+BenchmarkRun::BenchmarkRun(uint32_t seed, int blueRobots, int yellowRobots) :
+    SimulationHarness(seed, blueRobots, yellowRobots, createRealism()),
+    m_tracker(false, false)
+{
+    world::BallModel ballModel;
+    loadConfiguration("cpptests/ballmodel", &ballModel, false);
+    m_tracker.setBallModel(ballModel);
+
+    QObject::connect(&simulator(), &camun::simulator::Simulator::gotPacket, [this](const QByteArray &data, qint64 time, QString sender) {
+        m_tracker.queuePacket(data, time, sender);
+    });
+    QObject::connect(&simulator(), &camun::simulator::Simulator::sendRealData, [this](const QByteArray &data) {
+        m_hasTruth = m_truth.ParseFromArray(data.data(), data.size());
+    });
+}
+
+void BenchmarkRun::simulate(float seconds)
+{
+    SimulationHarness::simulate(seconds, [this]() { track(); });
+}
+
+template<typename Robots, typename SimRobots>
+static void addRobotErrors(BenchmarkResult &result, const Robots &robots, const SimRobots &truth, float dt)
+{
+    for (const auto &simRobot : truth) {
+        for (const auto &robot : robots) {
+            if (robot.id() != simRobot.id()) {
+                continue;
+            }
+            const Vector truePos(simRobot.p_x() + simRobot.v_x() * dt, simRobot.p_y() + simRobot.v_y() * dt);
+            result.robotPosition.add(truePos.distance(Vector(robot.p_x(), robot.p_y())));
+            result.robotSpeed.add(Vector(simRobot.v_x(), simRobot.v_y()).distance(Vector(robot.v_x(), robot.v_y())));
+            break;
+        }
+    }
+}
+
+void BenchmarkRun::track()
+{
+    const qint64 now = timer().currentTime();
+    QElapsedTimer elapsed;
+    elapsed.start();
+    m_tracker.process(now);
+    const qint64 processTime = elapsed.nsecsElapsed();
+    const Status status = m_tracker.worldState(now, true);
+    m_tracker.finishProcessing();
+
+    if (!m_hasTruth) {
+        return;
+    }
+    const world::State &state = status->world_state();
+
+    // the chip latency is measured independently of the evaluation window
+    if (m_chipStart < 0 && m_truth.has_ball() && m_truth.ball().p_z() > CHIP_MIN_HEIGHT) {
+        m_chipStart = m_truth.time();
+    }
+    if (m_chipStart >= 0 && m_result.chipLatency < 0 && state.has_ball() && state.ball().p_z() > CHIP_MIN_HEIGHT) {
+        m_result.chipLatency = now - m_chipStart;
+    }
+
+    if (!m_evaluating) {
+        return;
+    }
+    m_result.samples++;
+    m_result.processTimes.push_back(processTime);
+
+    // the ground truth arrives with the vision delay, extrapolate it to the tracking time
+    const float dt = (now - m_truth.time()) * 1E-9f;
+    if (m_truth.has_ball()) {
+        if (state.has_ball()) {
+            const world::SimBall &ball = m_truth.ball();
+            const Vector truePos(ball.p_x() + ball.v_x() * dt, ball.p_y() + ball.v_y() * dt);
+            m_result.ballPosition.add(truePos.distance(Vector(state.ball().p_x(), state.ball().p_y())));
+            m_result.ballSpeed.add(Vector(ball.v_x(), ball.v_y()).distance(Vector(state.ball().v_x(), state.ball().v_y())));
+        } else {
+            m_result.ballMissing++;
+        }
+    }
+    addRobotErrors(m_result, state.blue(), m_truth.blue_robots(), dt);
+    addRobotErrors(m_result, state.yellow(), m_truth.yellow_robots(), dt);
+}
+
+// the scenarios are scripted with fixed timings, thus runs with the same seed track identical vision data
+
+static BenchmarkResult straightPass(uint32_t seed)
+{
+    BenchmarkRun run(seed, 1, 0);
+    run.teleportRobot(true, 0, Vector(4, -5), Vector(0, 1));
+    run.teleportBall(Vector(0, -3), Vector(0, 0));
+    run.setEvaluating(false);
+    run.simulate(0.5);
+    run.setEvaluating(true);
+    run.simulate(0.2);
+    run.teleportBall(Vector(0, -3), Vector(0.3, 5));
+    run.simulate(2.5);
+    run.teleportBall(Vector(1, 2), Vector(-1.5, -3.5));
+    run.simulate(2.5);
+    return run.result();
+}
+
+static BenchmarkResult chipKick(uint32_t seed)
+{
+    BenchmarkRun run(seed, 1, 0);
+    run.teleportRobot(true, 0, Vector(0, -3.5), Vector(0, 1));
+    run.teleportBall(Vector(0, -3), Vector(0, 0));
+    run.setEvaluating(false);
+    run.simulate(0.5);
+    run.setEvaluating(true);
+    // drive into the ball, which is then chipped
+    run.driveRobot(true, 0, Vector(1, 0), 0, false, 4, 45);
+    run.simulate(0.8);
+    run.driveRobot(true, 0, Vector(0, 0), 0);
+    run.simulate(2.5);
+    return run.result();
+}
+
+static BenchmarkResult dribbling(uint32_t seed)
+{
+    BenchmarkRun run(seed, 1, 0);
+    run.teleportRobot(true, 0, Vector(-3, 2), Vector(-1, 0));
+    run.teleportBall(Vector(-3.5, 2), Vector(0, 0));
+    run.setEvaluating(false);
+    run.simulate(0.5);
+    run.setEvaluating(true);
+    run.driveRobot(true, 0, Vector(1, 0), 0, true);
+    run.simulate(1);
+    run.driveRobot(true, 0, Vector(0.8, 0), 1.5, true);
+    run.simulate(1.5);
+    run.driveRobot(true, 0, Vector(0, 0), 0, true);
+    run.simulate(0.5);
+    run.driveRobot(true, 0, Vector(-1, 0), 0, false);
+    run.simulate(1);
+    return run.result();
+}
+
+static BenchmarkResult robotCrowd(uint32_t seed)
+{
+    const int ROBOTS_PER_TEAM = 8;
+    BenchmarkRun run(seed, ROBOTS_PER_TEAM, ROBOTS_PER_TEAM);
+    for (int i = 0;i<2 * ROBOTS_PER_TEAM;i++) {
+        const bool isBlue = i < ROBOTS_PER_TEAM;
+        const int id = i % ROBOTS_PER_TEAM;
+        const Vector position(-0.6f + 0.4f * (i % 4), -1.4f + 0.4f * (i / 4));
+        run.teleportRobot(isBlue, id, position, Vector(std::cos(i), std::sin(i)));
+    }
+    run.teleportBall(Vector(-2.5, -0.9), Vector(0, 0));
+    run.setEvaluating(false);
+    run.simulate(0.5);
+    run.setEvaluating(true);
+    for (int i = 0;i<2 * ROBOTS_PER_TEAM;i++) {
+        // every robot drives on its own circle
+        run.driveRobot(i < ROBOTS_PER_TEAM, i % ROBOTS_PER_TEAM, Vector(0.4f + 0.05f * i, 0), i % 2 == 0 ? 2 : -2);
+    }
+    run.simulate(0.5);
+    run.teleportBall(Vector(-2.5, -0.9), Vector(3, 0.4));
+    run.simulate(3);
+    return run.result();
+}
+
+static QString formatNumber(double value)
+{
+    return std::isnan(value) ? QString() : QString::number(value, 'g', 6);
+}
+
+static double percentile(std::vector<qint64> values, double p)
+{
+    if (values.empty()) {
+        return NAN;
+    }
+    const std::size_t index = std::min(values.size() - 1, std::size_t(p * values.size()));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values[index];
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName("Tracking-benchmark-CLI");
+    app.setOrganizationName("ER-Force");
+
+    std::setlocale(LC_NUMERIC, "C");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures tracking accuracy and cost against the simulator ground truth");
+    parser.addHelpOption();
+    parser.addVersionOption();
+    parser.addPositionalArgument("scenarios", "Scenarios to run, defaults to all: straight-pass, chip-kick, dribbling, robot-crowd");
+
+    QCommandLineOption seedOption("seed", "Seed for the simulator noise, fixed to make results comparable across commits", "seed", "14986");
+    parser.addOption(seedOption);
+
+    // parse command line
+    parser.process(app);
+
+    const std::vector<std::pair<QString, std::function<BenchmarkResult(uint32_t)>>> scenarios = {
+        {"straight-pass", straightPass},
+        {"chip-kick", chipKick},
+        {"dribbling", dribbling},
+        {"robot-crowd", robotCrowd}
+    };
+    QStringList selected = parser.positionalArguments();
+    if (selected.isEmpty()) {
+        for (const auto &scenario : scenarios) {
+            selected.append(scenario.first);
+        }
+    }
+    for (const QString &name : selected) {
+        if (std::none_of(scenarios.begin(), scenarios.end(), [&name](const auto &s) { return s.first == name; })) {
+            std::cerr <<"Unknown scenario "<<name.toStdString()<<std::endl;
+            parser.showHelp(1);
+        }
+    }
+    const uint32_t seed = parser.value(seedOption).toUInt();
+
+    std::cout <<"# commit "<<gitconfig::getErforceCommitHash()
+              <<(std::string(gitconfig::getErforceCommitDiff()).empty() ? "" : " (modified)")<<", seed "<<seed<<std::endl;
+    std::cout <<"scenario,samples,ball_missing,ball_rms_position_m,ball_rms_speed_mps,robot_rms_position_m,robot_rms_speed_mps,"
+              <<"chip_latency_ms,process_mean_us,process_median_us,process_p95_us"<<std::endl;
+    for (const auto &scenario : scenarios) {
+        if (!selected.contains(scenario.first)) {
+            continue;
+        }
+        const BenchmarkResult result = scenario.second(seed);
+        double processSum = 0;
+        for (qint64 time : result.processTimes) {
+            processSum += time;
+        }
+        const double processMean = result.processTimes.empty() ? NAN : processSum / result.processTimes.size();
+
+        std::cout <<scenario.first.toStdString()<<","<<result.samples<<","<<result.ballMissing<<","
+                  <<formatNumber(result.ballPosition.rms()).toStdString()<<","
+                  <<formatNumber(result.ballSpeed.rms()).toStdString()<<","
+                  <<formatNumber(result.robotPosition.rms()).toStdString()<<","
+                  <<formatNumber(result.robotSpeed.rms()).toStdString()<<","
+                  <<formatNumber(result.chipLatency < 0 ? NAN : result.chipLatency * 1E-6).toStdString()<<","
+                  <<formatNumber(processMean * 1E-3).toStdString()<<","
+                  <<formatNumber(percentile(result.processTimes, 0.5) * 1E-3).toStdString()<<","
+                  <<formatNumber(percentile(result.processTimes, 0.95) * 1E-3).toStdString()<<std::endl;
+    }
+
+    return 0;
+}
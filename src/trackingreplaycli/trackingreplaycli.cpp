@@ -20,15 +20,262 @@
 
 #include <QCoreApplication>
 #include <QCommandLineParser>
+#include <QDirIterator>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRunnable>
+#include <QTextStream>
+#include <QThreadPool>
 #include <clocale>
 #include <QtGlobal>
+#include <cmath>
+#include <google/protobuf/text_format.h>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "processor/trackingreplay.h"
 #include "protobuf/status.h"
 #include "seshat/logfilereader.h"
 #include "core/timer.h"
 
+namespace {
+
+struct ErrorStatistic
+{
+    qint64 count = 0;
+    double sum = 0;
+    double max = 0;
+
+    void add(double value)
+    {
+        count++;
+        sum += value;
+        max = std::max(max, value);
+    }
+
+    void merge(const ErrorStatistic &other)
+    {
+        count += other.count;
+        sum += other.sum;
+        max = std::max(max, other.max);
+    }
+
+    double mean() const { return count > 0 ? sum / count : NAN; }
+};
+
+struct LogMetrics
+{
+    QString file;
+    QString error;
+    int packets = 0;
+    int frames = 0;
+    int flights = 0;
+    int ballFilterSwitches = 0;
+    // distance to the simulator ground truth, only available for simulated logs
+    ErrorStatistic ballTruthError;
+    ErrorStatistic robotTruthError;
+    // distance to the tracking stored in the log
+    ErrorStatistic loggedBallDifference;
+    // in milliseconds
+    ErrorStatistic frameTime;
+
+    void merge(const LogMetrics &other)
+    {
+        packets += other.packets;
+        frames += other.frames;
+        flights += other.flights;
+        ballFilterSwitches += other.ballFilterSwitches;
+        ballTruthError.merge(other.ballTruthError);
+        robotTruthError.merge(other.robotTruthError);
+        loggedBallDifference.merge(other.loggedBallDifference);
+        frameTime.merge(other.frameTime);
+    }
+};
+
+float debugValue(const Status &status, const std::string &key, float defaultValue)
+{
+    for (const amun::DebugValues &debug : status->debug()) {
+        for (const amun::DebugValue &value : debug.value()) {
+            if (value.key() == key) {
+                return value.float_value();
+            }
+        }
+    }
+    return defaultValue;
+}
+
+template<typename Robots, typename SimRobots>
+void addRobotErrors(ErrorStatistic &statistic, const Robots &robots, const SimRobots &truth)
+{
+    for (const auto &robot : robots) {
+        for (const auto &simRobot : truth) {
+            if (simRobot.id() == robot.id()) {
+                statistic.add(std::hypot(robot.p_x() - simRobot.p_x(), robot.p_y() - simRobot.p_y()));
+                break;
+            }
+        }
+    }
+}
+
+LogMetrics replayLog(const QString &filename, const world::BallModel *ballModel, bool parallelTracking)
+{
+    LogMetrics metrics;
+    metrics.file = filename;
+
+    LogFileReader logfile;
+    if (!logfile.open(filename)) {
+        metrics.error = logfile.errorMsg();
+        return metrics;
+    }
+
+    Timer timer;
+    timer.setTime(0, 0);
+    TrackingReplay replay(&timer);
+    replay.setParallelTracking(parallelTracking);
+    if (ballModel) {
+        replay.setBallModel(*ballModel);
+    }
+
+    Status input;
+    bool wasFlying = false;
+    replay.connect(&replay, &TrackingReplay::gotStatus, [&](const Status &status) {
+        if (!status->has_world_state()) {
+            return;
+        }
+        const world::State &state = status->world_state();
+        metrics.frames++;
+        metrics.ballFilterSwitches = debugValue(status, "Ball hypotheses/switches", metrics.ballFilterSwitches);
+
+        if (state.has_ball()) {
+            const bool flying = state.ball().p_z() != 0.0f;
+            if (flying && !wasFlying) {
+                metrics.flights++;
+            }
+            wasFlying = flying;
+        }
+
+        if (state.reality_size() > 0) {
+            const world::SimulatorState &truth = state.reality(state.reality_size() - 1);
+            if (state.has_ball() && truth.has_ball()) {
+                metrics.ballTruthError.add(std::hypot(state.ball().p_x() - truth.ball().p_x(), state.ball().p_y() - truth.ball().p_y()));
+            }
+            addRobotErrors(metrics.robotTruthError, state.yellow(), truth.yellow_robots());
+            addRobotErrors(metrics.robotTruthError, state.blue(), truth.blue_robots());
+        }
+
+        if (state.has_ball() && input->has_world_state() && input->world_state().has_ball()) {
+            const world::Ball &logged = input->world_state().ball();
+            metrics.loggedBallDifference.add(std::hypot(state.ball().p_x() - logged.p_x(), state.ball().p_y() - logged.p_y()));
+        }
+    });
+
+    metrics.packets = logfile.packetCount();
+    QElapsedTimer elapsed;
+    for (int i = 0;i<logfile.packetCount();i++) {
+        input = logfile.readStatus(i);
+        if (input.isNull()) {
+            continue;
+        }
+        elapsed.start();
+        replay.handleStatus(input);
+        if (input->has_world_state()) {
+            metrics.frameTime.add(elapsed.nsecsElapsed() * 1E-6);
+        }
+    }
+    return metrics;
+}
+
+class ReplayTask : public QRunnable
+{
+public:
+    ReplayTask(const QString &filename, const world::BallModel *ballModel, LogMetrics &metrics) :
+        m_filename(filename), m_ballModel(ballModel), m_metrics(metrics) {}
+
+    void run() override
+    {
+        // the logs are the unit of parallelism, the trackers of one log share its thread
+        m_metrics = replayLog(m_filename, m_ballModel, false);
+    }
+
+private:
+    const QString m_filename;
+    const world::BallModel *m_ballModel;
+    LogMetrics &m_metrics;
+};
+
+QStringList findLogs(const QStringList &paths)
+{
+    QStringList logs;
+    for (const QString &path : paths) {
+        if (!QFileInfo(path).isDir()) {
+            logs.append(path);
+            continue;
+        }
+        QStringList found;
+        QDirIterator it(path, {"*.log"}, QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            found.append(it.next());
+        }
+        found.sort();
+        logs.append(found);
+    }
+    return logs;
+}
+
+QString csvString(QString value)
+{
+    // RFC 4180: quote the field and double any quotes within it
+    return "\"" + value.replace("\"", "\"\"") + "\"";
+}
+
+QString csvNumber(double value)
+{
+    return std::isnan(value) ? QString() : QString::number(value);
+}
+
+void writeCsvRow(QTextStream &stream, const QString &name, const LogMetrics &m)
+{
+    stream << csvString(name) << "," << m.packets << "," << m.frames << "," << m.flights << "," << m.ballFilterSwitches << ","
+           << csvNumber(m.ballTruthError.mean()) << "," << csvNumber(m.ballTruthError.count > 0 ? m.ballTruthError.max : NAN) << ","
+           << csvNumber(m.robotTruthError.mean()) << "," << csvNumber(m.robotTruthError.count > 0 ? m.robotTruthError.max : NAN) << ","
+           << csvNumber(m.loggedBallDifference.mean()) << "," << csvNumber(m.loggedBallDifference.count > 0 ? m.loggedBallDifference.max : NAN) << ","
+           << csvNumber(m.frameTime.mean()) << "," << csvNumber(m.frameTime.count > 0 ? m.frameTime.max : NAN) << ","
+           << csvString(m.error) << "\n";
+}
+
+QJsonValue jsonStatistic(const ErrorStatistic &statistic)
+{
+    if (statistic.count == 0) {
+        return QJsonValue();
+    }
+    QJsonObject object;
+    object["count"] = statistic.count;
+    object["mean"] = statistic.mean();
+    object["max"] = statistic.max;
+    return object;
+}
+
+QJsonObject jsonMetrics(const LogMetrics &m)
+{
+    QJsonObject object;
+    object["packets"] = m.packets;
+    object["frames"] = m.frames;
+    object["flights"] = m.flights;
+    object["ball_filter_switches"] = m.ballFilterSwitches;
+    object["ball_truth_error"] = jsonStatistic(m.ballTruthError);
+    object["robot_truth_error"] = jsonStatistic(m.robotTruthError);
+    object["logged_ball_difference"] = jsonStatistic(m.loggedBallDifference);
+    object["frame_time_ms"] = jsonStatistic(m.frameTime);
+    return object;
+}
+
+}
+
 int main(int argc, char* argv[])
 {
     QCoreApplication app(argc, argv);
@@ -41,7 +288,18 @@ int main(int argc, char* argv[])
     parser.setApplicationDescription("Command line interface for tracking replay on ER-Force logs");
     parser.addHelpOption();
     parser.addVersionOption();
-    parser.addPositionalArgument("logfile", "Log file to read");
+    parser.addPositionalArgument("logs", "Log files or directories containing log files to read");
+
+    QCommandLineOption formatOption({"f", "format"}, "Write metrics for every log and all logs combined as csv or json. "
+                                    "Without it, the number of ball flights of a single log is printed", "format");
+    parser.addOption(formatOption);
+    QCommandLineOption outputOption({"o", "output"}, "Write the metrics to this file instead of stdout", "file");
+    parser.addOption(outputOption);
+    QCommandLineOption jobsOption({"j", "jobs"}, "Number of logs to replay in parallel, defaults to the number of cores. "
+                                                 "Each log is tracked on a single thread, its processor only adds an idle game controller thread", "count");
+    parser.addOption(jobsOption);
+    QCommandLineOption ballModelOption("ball-model", "Track with the ball model from this text protobuf file instead of the logged one", "file");
+    parser.addOption(ballModelOption);
 
 //    QCommandLineOption asBlueOption({"b", "as-blue"}, "Run as blue strategy, defaults to yellow");
 //    parser.addOption(asBlueOption);
@@ -49,42 +307,93 @@ int main(int argc, char* argv[])
     // parse command line
     parser.process(app);
 
-    int argCount = parser.positionalArguments().size();
-    if (argCount != 1) {
+    const QString format = parser.value(formatOption);
+    if (!format.isEmpty() && format != "csv" && format != "json") {
+        parser.showHelp(1);
+    }
+    const QStringList logs = findLogs(parser.positionalArguments());
+    if (logs.isEmpty() || (format.isEmpty() && logs.size() != 1)) {
         parser.showHelp(1);
     }
 
     qRegisterMetaType<Status>("Status");
     qRegisterMetaType<Command>("Command");
 
-    Timer timer;
-    timer.setTime(0, 0);
-    TrackingReplay replay(&timer);
+    std::unique_ptr<world::BallModel> ballModel;
+    if (parser.isSet(ballModelOption)) {
+        QFile file(parser.value(ballModelOption));
+        if (!file.open(QFile::ReadOnly)) {
+            qFatal("Error: could not open ball model");
+        }
+        ballModel.reset(new world::BallModel);
+        google::protobuf::TextFormat::Parser textParser;
+        if (!textParser.ParseFromString(file.readAll().toStdString(), ballModel.get())) {
+            qFatal("Error: could not parse ball model");
+        }
+    }
 
-    bool wasFlying = false;
-    int flyCount = 0;
-    replay.connect(&replay, &TrackingReplay::gotStatus, [&wasFlying, &flyCount](const Status &status) {
-        if (status->has_world_state() && status->world_state().has_ball()) {
-            bool flying = status->world_state().ball().p_z() != 0.0f;
-            if (flying && !wasFlying) {
-                flyCount++;
-            }
-            wasFlying = flying;
+    if (format.isEmpty()) {
+        const LogMetrics metrics = replayLog(logs.first(), ballModel.get(), true);
+        if (!metrics.error.isEmpty()) {
+            qFatal("Error: could not open logfile");
         }
-    });
+        std::cout <<metrics.flights<<std::endl;
+        return 0;
+    }
 
-    LogFileReader logfile;
-    const QStringList arguments = parser.positionalArguments();
-    if (!logfile.open(arguments.first())) {
-        qFatal("Error: could not open logfile");
+    // every log is replayed with its own processor and timer
+    std::vector<LogMetrics> results(logs.size());
+    QThreadPool pool;
+    if (parser.isSet(jobsOption)) {
+        pool.setMaxThreadCount(std::max(1, parser.value(jobsOption).toInt()));
+    }
+    for (int i = 0; i < logs.size(); i++) {
+        pool.start(new ReplayTask(logs[i], ballModel.get(), results[i]));
     }
+    pool.waitForDone();
 
-    for (int i = 0;i<logfile.packetCount();i++) {
-        const Status &status = logfile.readStatus(i);
-        replay.handleStatus(status);
+    LogMetrics total;
+    for (const LogMetrics &metrics : results) {
+        if (!metrics.error.isEmpty()) {
+            std::cerr <<"Error: could not open "<<metrics.file.toStdString()<<": "<<metrics.error.toStdString()<<std::endl;
+        }
+        total.merge(metrics);
     }
 
-    std::cout <<flyCount<<std::endl;
+    QFile outputFile;
+    if (parser.isSet(outputOption)) {
+        outputFile.setFileName(parser.value(outputOption));
+        if (!outputFile.open(QFile::WriteOnly | QFile::Truncate)) {
+            qFatal("Error: could not open output file");
+        }
+    } else {
+        outputFile.open(stdout, QFile::WriteOnly);
+    }
+    QTextStream stream(&outputFile);
+
+    if (format == "csv") {
+        stream << "log,packets,frames,flights,ball_filter_switches,ball_truth_error_mean,ball_truth_error_max,"
+               << "robot_truth_error_mean,robot_truth_error_max,logged_ball_difference_mean,logged_ball_difference_max,"
+               << "frame_time_ms_mean,frame_time_ms_max,error\n";
+        for (const LogMetrics &metrics : results) {
+            writeCsvRow(stream, metrics.file, metrics);
+        }
+        writeCsvRow(stream, "total", total);
+    } else {
+        QJsonArray logArray;
+        for (const LogMetrics &metrics : results) {
+            QJsonObject object = jsonMetrics(metrics);
+            object["log"] = metrics.file;
+            if (!metrics.error.isEmpty()) {
+                object["error"] = metrics.error;
+            }
+            logArray.append(object);
+        }
+        QJsonObject root;
+        root["logs"] = logArray;
+        root["total"] = jsonMetrics(total);
+        stream << QJsonDocument(root).toJson();
+    }
 
     return 0;
 }
@@ -156,6 +156,25 @@ separator for luadoc]]--
 --[[
 separator for luadoc]]--
 
+--- Registers a debug key, the returned handle can be passed to addDebugBatch
+-- @class function
+-- @name registerDebugKey
+-- @param key string
+-- @return number - handle for the key
+
+--[[
+separator for luadoc]]--
+
+--- Sets multiple values in the debug tree
+-- @class function
+-- @name addDebugBatch
+-- @param handles number[] - handles as returned by registerDebugKey
+-- @param values (number|bool|string|nil)[]
+-- @param [count number - only use the first count entries]
+
+--[[
+separator for luadoc]]--
+
 --- Add a value to the plotter
 -- @class function
 -- @name addPlot
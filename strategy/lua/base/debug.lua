@@ -34,6 +34,44 @@ local debugStack = { "" }
 
 local joinCache = {}
 
+-- debug keys are registered once, values are then sent in batches
+local useHandles = amun.registerDebugKey ~= nil and amun.addDebugBatch ~= nil
+local handleCache = {}
+local bufferedHandles = {}
+local bufferedValues = {}
+local bufferedCount = 0
+-- bounds the buffer size, values of an unfinished frame are lost on a crash either way
+local MAX_BUFFERED_VALUES = 1000
+
+local function flush()
+	if bufferedCount > 0 then
+		amun.addDebugBatch(bufferedHandles, bufferedValues, bufferedCount)
+		bufferedCount = 0
+	end
+end
+
+local function addDebug(key, value)
+	if not useHandles then
+		amun.addDebug(key, value)
+		return
+	end
+	local handle = handleCache[key]
+	if not handle then
+		handle = amun.registerDebugKey(key)
+		handleCache[key] = handle
+	end
+	bufferedCount = bufferedCount + 1
+	bufferedHandles[bufferedCount] = handle
+	-- nil values would create holes in the table
+	if value == nil then
+		value = "<nil>"
+	end
+	bufferedValues[bufferedCount] = value
+	if bufferedCount >= MAX_BUFFERED_VALUES then
+		flush()
+	end
+end
+
 local function prefixName(name)
 	local prefix = debugStack[#debugStack]
 	if name == nil then
@@ -164,12 +202,13 @@ function debug.set(name, value, visited, tableCounter)
 		value = tostring(value)
 	end
 
-	amun.addDebug(prefixName(name), value)
+	addDebug(prefixName(name), value)
 end
 
---- Clears the debug stack
+--- Clears the debug stack and submits all buffered debug values
 -- @name resetStack
 function debug.resetStack()
+	flush()
 	if #debugStack ~= 1 or debugStack[1] ~= "" then
 		log("Unbalanced push/pop on debug stack")
 		for _,v in ipairs(debugStack) do
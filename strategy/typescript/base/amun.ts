@@ -110,6 +110,10 @@ interface Amun extends AmunPublic {
 	getSelectedOptions(): string[];
 	/** Sets a value in the debug tree */
 	addDebug(key: string, value?: number | boolean | string): void;
+	/** Registers a debug key and returns a handle for use with addDebugBatch. Not available in older versions of ra */
+	registerDebugKey?(key: string): number;
+	/** Sets the values for the given debug key handles, only the first count entries are used if given */
+	addDebugBatch?(handles: number[], values: (number | boolean | string | undefined)[], count?: number): void;
 	/** Add a value to the plotter */
 	addPlot(name: string, value: number): void;
 	/** Send internal referee command. Only works in debug mode. Must be fully populated */
@@ -211,6 +215,8 @@ export function _hideFunctions() {
 		getStrategyPath: makeDisabledFunction("getStrategyPath"),
 		getSelectedOptions: makeDisabledFunction("getSelectedOptions"),
 		addDebug: makeDisabledFunction("addDebug"),
+		registerDebugKey: makeDisabledFunction("registerDebugKey"),
+		addDebugBatch: makeDisabledFunction("addDebugBatch"),
 		addPlot: makeDisabledFunction("addPlot"),
 		sendRefereeCommand: makeDisabledFunction("sendRefereeCommand"),
 		sendMixedTeamInfo: makeDisabledFunction("sendMixedTeamInfo"),
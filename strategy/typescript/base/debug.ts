@@ -23,9 +23,44 @@
 *   along with this program.  if not, see <http://www.gnu.org/licenses/>. *
 **************************************************************************/
 
-let addDebug: Function = amun.addDebug;
+let amunAddDebug: Function = amun.addDebug;
+let registerDebugKey: ((key: string) => number) | undefined = amun.registerDebugKey;
+let addDebugBatch: Function | undefined = amun.addDebugBatch;
 import { log } from "base/amun";
 
+// debug keys are registered once, values are then sent in batches
+let handleCache: Map<string, number> = new Map();
+let bufferedHandles: number[] = [];
+let bufferedValues: any[] = [];
+let bufferedCount = 0;
+// bounds the buffer size, values of an unfinished frame are lost on a crash either way
+const MAX_BUFFERED_VALUES = 1000;
+
+function flush() {
+	if (bufferedCount > 0) {
+		addDebugBatch!(bufferedHandles, bufferedValues, bufferedCount);
+		bufferedCount = 0;
+	}
+}
+
+function addDebug(key: string, value: any) {
+	if (registerDebugKey == undefined || addDebugBatch == undefined) {
+		amunAddDebug(key, value);
+		return;
+	}
+	let handle = handleCache.get(key);
+	if (handle == undefined) {
+		handle = registerDebugKey(key);
+		handleCache.set(key, handle);
+	}
+	bufferedHandles[bufferedCount] = handle;
+	bufferedValues[bufferedCount] = value;
+	bufferedCount++;
+	if (bufferedCount >= MAX_BUFFERED_VALUES) {
+		flush();
+	}
+}
+
 let debugStack: string[] = [""];
 
 let joinCache: { [prefix: string]: { [name: string]: string } } = {};
@@ -196,8 +231,9 @@ export function wrap<T extends Function>(key: string, fn: T): T {
 	return newFn as any;
 }
 
-/** Clears the debug stack */
+/** Clears the debug stack and submits all buffered debug values */
 export function resetStack() {
+	flush();
 	if (debugStack.length !== 1 || debugStack[0] !== "") {
 		log("Unbalanced push/pop on debug stack");
 		for (let v of debugStack) {